@@ -0,0 +1,220 @@
+/* -------------------------------------------------------------------------- */
+
+// Timestamp parsing throughput for the Saleae csv exports.
+//
+// Pulls every timestamp out of the csv files in a folder (the 12B baudrate logs
+// by default), checks the SWAR and cached parsers agree with the reference
+// implementation, then times each one over the same set of strings.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "iso8601.h"
+#include "saleae_csv.h"
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef BENCH_SAMPLE_DIR
+    #define BENCH_SAMPLE_DIR "."
+#endif
+
+#define BENCH_TARGET_PARSES (20000000u)
+
+/* -------------------------------------------------------------------------- */
+
+typedef bool (*parse_fn_t)( iso8601_cache_t *cache, const char *str, int64_t *ns );
+
+static bool parse_reference( iso8601_cache_t *cache, const char *str, int64_t *ns );
+static bool parse_swar( iso8601_cache_t *cache, const char *str, int64_t *ns );
+static bool parse_cached( iso8601_cache_t *cache, const char *str, int64_t *ns );
+
+static double run_parser( parse_fn_t fn, const std::vector<char> &strings, size_t count, uint32_t passes, int64_t *checksum );
+static double run_csv_ingest( const std::vector<std::string> &files, uint64_t *rows );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    const char *dir = ( argc > 1 ) ? argv[1] : BENCH_SAMPLE_DIR;
+
+    std::vector<std::string> files;
+    std::error_code          ec;
+
+    for( const auto &entry : std::filesystem::directory_iterator( dir, ec ) )
+    {
+        if( entry.path().extension() == ".csv" )
+        {
+            files.push_back( entry.path().string() );
+        }
+    }
+    std::sort( files.begin(), files.end() );
+
+    if( files.empty() )
+    {
+        fprintf( stderr, "No csv files found in %s\n", dir );
+        return 1;
+    }
+
+    // Timestamps are packed at a fixed stride so every parser sees identical input
+    std::vector<char> strings;
+    size_t            count = 0;
+
+    for( const std::string &path : files )
+    {
+        FILE *f = fopen( path.c_str(), "rb" );
+        char  line[256];
+
+        if( !f || !fgets( line, sizeof(line), f ) )
+        {
+            fprintf( stderr, "Failed to read %s\n", path.c_str() );
+            return 1;
+        }
+
+        while( fgets( line, sizeof(line), f ) )
+        {
+            if( strlen( line ) > ISO8601_SALEAE_LENGTH && line[ISO8601_SALEAE_LENGTH] == ',' )
+            {
+                strings.insert( strings.end(), line, line + ISO8601_SALEAE_LENGTH );
+                count++;
+            }
+        }
+        fclose( f );
+    }
+
+    // Everything must agree with the digit-at-a-time reference before timing it
+    iso8601_cache_t cache = {};
+    for( size_t i = 0; i < count; i++ )
+    {
+        const char *str = &strings[i * ISO8601_SALEAE_LENGTH];
+        int64_t     expected, swar, cached;
+
+        if(    !iso8601_parse_ns_reference( str, ISO8601_SALEAE_LENGTH, &expected )
+            || !iso8601_parse_ns( str, ISO8601_SALEAE_LENGTH, &swar )
+            || !iso8601_parse_ns_cached( &cache, str, ISO8601_SALEAE_LENGTH, &cached )
+            || swar != expected || cached != expected )
+        {
+            fprintf( stderr, "Mismatch on %.35s\n", str );
+            return 1;
+        }
+    }
+
+    const uint32_t passes = (uint32_t)std::max<size_t>( 1, BENCH_TARGET_PARSES / count );
+    const double   total  = (double)count * passes;
+
+    printf( "%zu files, %zu timestamps, %u passes\n\n", files.size(), count, passes );
+    printf( "%-12s %12s %14s\n", "parser", "ns/stamp", "Mstamps/s" );
+
+    struct
+    {
+        const char *name;
+        parse_fn_t  fn;
+    } parsers[] = {
+        { "reference", parse_reference },
+        { "swar",      parse_swar },
+        { "swar+cache", parse_cached },
+    };
+
+    int64_t checksum = 0;
+    double  baseline = 0;
+
+    for( const auto &p : parsers )
+    {
+        double seconds = run_parser( p.fn, strings, count, passes, &checksum );
+        double ns      = seconds * 1e9 / total;
+
+        if( baseline == 0 )
+        {
+            baseline = ns;
+        }
+
+        printf( "%-12s %12.2f %14.1f   (%.1fx)\n", p.name, ns, total / seconds / 1e6, baseline / ns );
+    }
+
+    uint64_t rows    = 0;
+    double   seconds = run_csv_ingest( files, &rows );
+    printf( "\ncsv ingest: %llu rows in %.2f ms, %.1f Mrows/s\n",
+            (unsigned long long)rows, seconds * 1e3, rows / seconds / 1e6 );
+
+    // Keep the optimiser honest
+    return checksum == 42 ? 2 : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool parse_reference( iso8601_cache_t *cache, const char *str, int64_t *ns )
+{
+    (void)cache;
+    return iso8601_parse_ns_reference( str, ISO8601_SALEAE_LENGTH, ns );
+}
+
+static bool parse_swar( iso8601_cache_t *cache, const char *str, int64_t *ns )
+{
+    (void)cache;
+    return iso8601_parse_ns( str, ISO8601_SALEAE_LENGTH, ns );
+}
+
+static bool parse_cached( iso8601_cache_t *cache, const char *str, int64_t *ns )
+{
+    return iso8601_parse_ns_cached( cache, str, ISO8601_SALEAE_LENGTH, ns );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double run_parser( parse_fn_t fn, const std::vector<char> &strings, size_t count, uint32_t passes, int64_t *checksum )
+{
+    iso8601_cache_t cache = {};
+    int64_t         sum   = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for( uint32_t p = 0; p < passes; p++ )
+    {
+        for( size_t i = 0; i < count; i++ )
+        {
+            int64_t ns = 0;
+            fn( &cache, &strings[i * ISO8601_SALEAE_LENGTH], &ns );
+            sum += ns;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    *checksum ^= sum;
+
+    return std::chrono::duration<double>( end - start ).count();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double run_csv_ingest( const std::vector<std::string> &files, uint64_t *rows )
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for( const std::string &path : files )
+    {
+        saleae_csv_t csv;
+        saleae_row_t row;
+
+        if( saleae_csv_open( &csv, path.c_str() ) )
+        {
+            while( saleae_csv_next( &csv, &row ) )
+            {
+                ( *rows )++;
+            }
+            saleae_csv_close( &csv );
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>( end - start ).count();
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,223 @@
+/* -------------------------------------------------------------------------- */
+
+// Accuracy and throughput of the streaming latency statistics.
+//
+// Loads every wide csv in analysis/, computes exact type 7 quantiles by sorting
+// each column, and reports the worst relative error of the histogram estimate
+// per quantile. Then times how fast samples can be recorded and merged.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+#include "latency_stats.h"
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef BENCH_SAMPLE_DIR
+    #define BENCH_SAMPLE_DIR "."
+#endif
+
+#define BENCH_TARGET_SAMPLES (50000000u)
+
+/* -------------------------------------------------------------------------- */
+
+static const double bench_quantiles[] = { 0.25, 0.5, 0.75, 0.9, 0.99, 0.999 };
+
+#define BENCH_QUANTILE_COUNT ( sizeof( bench_quantiles ) / sizeof( bench_quantiles[0] ) )
+
+static double exact_quantile( const std::vector<double> &sorted, double q );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    const char *dir = ( argc > 1 ) ? argv[1] : BENCH_SAMPLE_DIR;
+
+    std::vector<std::string> files;
+    std::error_code          ec;
+
+    for( const auto &entry : std::filesystem::directory_iterator( dir, ec ) )
+    {
+        if( entry.path().extension() == ".csv" )
+        {
+            files.push_back( entry.path().string() );
+        }
+    }
+    std::sort( files.begin(), files.end() );
+
+    std::vector<std::vector<double>> columns;
+    std::vector<double>              samples;
+
+    for( const std::string &path : files )
+    {
+        std::vector<latency_column_t> read;
+
+        if( !latency_columns_read_csv( path.c_str(), &read ) )
+        {
+            continue;
+        }
+
+        for( latency_column_t &column : read )
+        {
+            std::vector<double> values;
+
+            for( double value : column.values )
+            {
+                if( !isnan( value ) )
+                {
+                    values.push_back( value );
+                }
+            }
+
+            if( values.size() > 1 )
+            {
+                samples.insert( samples.end(), values.begin(), values.end() );
+                columns.push_back( std::move( values ) );
+            }
+        }
+    }
+
+    if( columns.empty() )
+    {
+        fprintf( stderr, "No latency columns found in %s\n", dir );
+        return 1;
+    }
+
+    printf( "%zu columns, %zu samples from %s\n\n", columns.size(), samples.size(), dir );
+
+    // Accuracy: worst relative error per quantile across every column
+    double worst[BENCH_QUANTILE_COUNT] = { 0 };
+    double worst_mean                  = 0.0;
+    double worst_variance              = 0.0;
+
+    for( std::vector<double> &values : columns )
+    {
+        latency_stats_t stats;
+        latency_stats_init( &stats, 0 );
+
+        for( double value : values )
+        {
+            latency_stats_add( &stats, value );
+        }
+
+        double sum = 0.0;
+
+        for( double value : values )
+        {
+            sum += value;
+        }
+
+        const double mean     = sum / (double)values.size();
+        double       squares  = 0.0;
+
+        for( double value : values )
+        {
+            squares += ( value - mean ) * ( value - mean );
+        }
+
+        const double variance = squares / (double)( values.size() - 1 );
+
+        latency_summary_t summary;
+        latency_stats_summarise( &stats, &summary );
+
+        if( mean != 0.0 )
+        {
+            worst_mean = std::max( worst_mean, fabs( summary.mean - mean ) / fabs( mean ) );
+        }
+
+        if( variance != 0.0 )
+        {
+            worst_variance = std::max( worst_variance, fabs( summary.variance - variance ) / variance );
+        }
+
+        std::sort( values.begin(), values.end() );
+
+        for( size_t q = 0; q < BENCH_QUANTILE_COUNT; q++ )
+        {
+            const double exact    = exact_quantile( values, bench_quantiles[q] );
+            const double estimate = latency_stats_quantile( &stats, bench_quantiles[q] );
+
+            if( exact != 0.0 )
+            {
+                worst[q] = std::max( worst[q], fabs( estimate - exact ) / fabs( exact ) );
+            }
+        }
+    }
+
+    printf( "Worst relative error vs sorted type 7 quantiles:\n" );
+
+    for( size_t q = 0; q < BENCH_QUANTILE_COUNT; q++ )
+    {
+        printf( "  p%-6g %.4f%%\n", bench_quantiles[q] * 100.0, worst[q] * 100.0 );
+    }
+
+    printf( "  mean    %.2e%%\n", worst_mean * 100.0 );
+    printf( "  var     %.2e%%\n\n", worst_variance * 100.0 );
+
+    // Throughput: record the pooled samples repeatedly into one histogram
+    const uint32_t passes = (uint32_t)std::max<size_t>( 1, BENCH_TARGET_SAMPLES / samples.size() );
+
+    latency_stats_t stats;
+    latency_stats_init( &stats, 0 );
+
+    const auto started = std::chrono::steady_clock::now();
+
+    for( uint32_t pass = 0; pass < passes; pass++ )
+    {
+        for( double value : samples )
+        {
+            latency_stats_add( &stats, value );
+        }
+    }
+
+    const auto   recorded = std::chrono::steady_clock::now();
+    const double add_s    = std::chrono::duration<double>( recorded - started ).count();
+
+    // Merge cost is per bucket, independent of how many samples went in
+    latency_stats_t total;
+    latency_stats_init( &total, 0 );
+
+    const uint32_t merges = 1000;
+
+    for( uint32_t i = 0; i < merges; i++ )
+    {
+        latency_stats_merge( &total, &stats );
+    }
+
+    const double merge_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - recorded ).count();
+
+    printf( "add    %8.1f M samples/s (%llu samples)\n",
+            (double)stats.count / add_s / 1e6,
+            (unsigned long long)stats.count );
+    printf( "merge  %8.2f us per histogram (%zu buckets)\n", merge_s / merges * 1e6, stats.buckets.size() );
+    printf( "p99    %g\n", latency_stats_quantile( &total, 0.99 ) );
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double exact_quantile( const std::vector<double> &sorted, double q )
+{
+    const double h     = (double)( sorted.size() - 1 ) * q;
+    const size_t below = (size_t)floor( h );
+
+    if( below + 1 >= sorted.size() )
+    {
+        return sorted[below];
+    }
+
+    return sorted[below] + ( h - (double)below ) * ( sorted[below + 1] - sorted[below] );
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,359 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "analysis_cache.h"
+#include "content_hash.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define CACHE_MANIFEST_NAME  "manifest"
+#define CACHE_MANIFEST_MAGIC "latency-cache"
+#define CACHE_BLOB_MAGIC     "LATCACHE"
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Result blob header, followed by the error text and the durations as doubles
+typedef struct
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t ok;
+    uint64_t counts[7];     // edge_pairing_counts_t, field by field
+    uint64_t rows;
+    uint64_t durations;
+    uint32_t error_length;
+    uint32_t reserved;
+} cache_blob_header_t;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static std::string cache_blob_path( const analysis_cache_t *cache, uint64_t hash );
+static bool cache_load_blob( const analysis_cache_t *cache, uint64_t hash, capture_latency_t *result, bool *ok );
+static bool cache_write_blob( const analysis_cache_t *cache, uint64_t hash, bool ok, const capture_latency_t *result );
+static void cache_counts_pack( const edge_pairing_counts_t *counts, uint64_t *packed );
+static void cache_counts_unpack( const uint64_t *packed, edge_pairing_counts_t *counts );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool analysis_cache_open( analysis_cache_t *cache, const std::string &dir )
+{
+    std::error_code ec;
+
+    cache->dir = dir;
+    cache->captures.clear();
+    cache->outputs.clear();
+    cache->hits     = 0;
+    cache->rehashed = 0;
+    cache->parsed   = 0;
+
+    std::filesystem::create_directories( dir, ec );
+
+    if( !std::filesystem::is_directory( dir, ec ) )
+    {
+        return false;
+    }
+
+    FILE *f = fopen( ( std::filesystem::path( dir ) / CACHE_MANIFEST_NAME ).string().c_str(), "rb" );
+
+    if( !f )
+    {
+        return true;
+    }
+
+    char     line[4096];
+    unsigned version = 0;
+
+    // Results from an older pairing are stale, start over
+    if( !fgets( line, sizeof( line ), f ) || sscanf( line, CACHE_MANIFEST_MAGIC " %u", &version ) != 1
+        || version != ANALYSIS_CACHE_VERSION )
+    {
+        fclose( f );
+        return true;
+    }
+
+    while( fgets( line, sizeof( line ), f ) )
+    {
+        line[strcspn( line, "\r\n" )] = '\0';
+
+        analysis_cache_entry_t entry;
+        uint64_t               key = 0;
+        int                    path_at = 0;
+
+        if( sscanf( line, "c\t%" SCNu64 "\t%" SCNd64 "\t%" SCNx64 "\t%n", &entry.size, &entry.mtime_ns, &entry.hash, &path_at ) == 3
+            && path_at > 0 )
+        {
+            cache->captures[line + path_at] = entry;
+        }
+        else if( sscanf( line, "o\t%" SCNx64 "\t%n", &key, &path_at ) == 1 && path_at > 0 )
+        {
+            cache->outputs[line + path_at] = key;
+        }
+    }
+
+    fclose( f );
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool analysis_cache_save( analysis_cache_t *cache )
+{
+    const std::string path      = ( std::filesystem::path( cache->dir ) / CACHE_MANIFEST_NAME ).string();
+    const std::string temporary = path + ".tmp";
+
+    FILE *f = fopen( temporary.c_str(), "wb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard( cache->lock );
+
+    fprintf( f, CACHE_MANIFEST_MAGIC " %u\n", ANALYSIS_CACHE_VERSION );
+
+    for( const auto &capture : cache->captures )
+    {
+        fprintf( f,
+                 "c\t%" PRIu64 "\t%" PRId64 "\t%016" PRIx64 "\t%s\n",
+                 capture.second.size,
+                 capture.second.mtime_ns,
+                 capture.second.hash,
+                 capture.first.c_str() );
+    }
+
+    for( const auto &output : cache->outputs )
+    {
+        fprintf( f, "o\t%016" PRIx64 "\t%s\n", output.second, output.first.c_str() );
+    }
+
+    const bool written = !ferror( f );
+
+    // Swap in whole so an interrupted run leaves the previous manifest
+    return ( fclose( f ) == 0 ) && written && rename( temporary.c_str(), path.c_str() ) == 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool analysis_cache_read( analysis_cache_t *cache, const std::string &path, capture_latency_t *result, uint64_t *hash )
+{
+    struct stat     st;
+    std::error_code ec;
+
+    const std::string key = std::filesystem::absolute( path, ec ).lexically_normal().string();
+
+    if( stat( path.c_str(), &st ) != 0 )
+    {
+        *hash = 0;
+        return capture_latency_read( path, result );
+    }
+
+    analysis_cache_entry_t current;
+    current.size     = (uint64_t)st.st_size;
+    current.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    current.hash     = 0;
+
+    analysis_cache_entry_t previous = { 0, 0, 0 };
+    bool                   known    = false;
+    bool                   ok       = false;
+
+    {
+        std::lock_guard<std::mutex> guard( cache->lock );
+        const auto                  found = cache->captures.find( key );
+
+        if( found != cache->captures.end() )
+        {
+            previous = found->second;
+            known    = true;
+        }
+    }
+
+    // Same size and timestamp as last time: trust it without reading the file
+    if( known && previous.size == current.size && previous.mtime_ns == current.mtime_ns
+        && cache_load_blob( cache, previous.hash, result, &ok ) )
+    {
+        cache->hits++;
+        *hash = previous.hash;
+        return ok;
+    }
+
+    if( !content_hash_file( path.c_str(), &current.hash ) )
+    {
+        *hash = 0;
+        return capture_latency_read( path, result );
+    }
+
+    // Touched or checked out again but the bytes are the same, or a copy of
+    // another capture that's already been processed
+    if( cache_load_blob( cache, current.hash, result, &ok ) )
+    {
+        cache->rehashed++;
+    }
+    else
+    {
+        cache->parsed++;
+        ok = capture_latency_read( path, result );
+        cache_write_blob( cache, current.hash, ok, result );
+    }
+
+    std::lock_guard<std::mutex> guard( cache->lock );
+    cache->captures[key] = current;
+
+    *hash = current.hash;
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool analysis_cache_output_current( analysis_cache_t *cache, const std::string &output, uint64_t key )
+{
+    std::error_code ec;
+
+    if( !std::filesystem::exists( output, ec ) )
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard( cache->lock );
+    const auto                  found = cache->outputs.find( output );
+
+    return found != cache->outputs.end() && found->second == key;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void analysis_cache_output_built( analysis_cache_t *cache, const std::string &output, uint64_t key )
+{
+    std::lock_guard<std::mutex> guard( cache->lock );
+    cache->outputs[output] = key;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static std::string cache_blob_path( const analysis_cache_t *cache, uint64_t hash )
+{
+    char name[32];
+    snprintf( name, sizeof( name ), "%016" PRIx64 ".lat", hash );
+
+    return ( std::filesystem::path( cache->dir ) / name ).string();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool cache_load_blob( const analysis_cache_t *cache, uint64_t hash, capture_latency_t *result, bool *ok )
+{
+    FILE *f = fopen( cache_blob_path( cache, hash ).c_str(), "rb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    cache_blob_header_t header;
+    bool                valid = fread( &header, sizeof( header ), 1, f ) == 1
+                 && memcmp( header.magic, CACHE_BLOB_MAGIC, sizeof( header.magic ) ) == 0
+                 && header.version == ANALYSIS_CACHE_VERSION;
+
+    if( valid )
+    {
+        result->error.assign( header.error_length, '\0' );
+        result->durations_ms.resize( header.durations );
+
+        valid = ( header.error_length == 0 || fread( &result->error[0], header.error_length, 1, f ) == 1 )
+                && ( header.durations == 0
+                     || fread( result->durations_ms.data(), sizeof( double ), header.durations, f ) == header.durations );
+    }
+
+    fclose( f );
+
+    if( !valid )
+    {
+        return false;
+    }
+
+    cache_counts_unpack( header.counts, &result->counts );
+    result->rows = header.rows;
+    *ok          = header.ok != 0;
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool cache_write_blob( const analysis_cache_t *cache, uint64_t hash, bool ok, const capture_latency_t *result )
+{
+    cache_blob_header_t header;
+
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, CACHE_BLOB_MAGIC, sizeof( header.magic ) );
+    header.version      = ANALYSIS_CACHE_VERSION;
+    header.ok           = ok ? 1 : 0;
+    header.rows         = result->rows;
+    header.durations    = result->durations_ms.size();
+    header.error_length = (uint32_t)result->error.size();
+    cache_counts_pack( &result->counts, header.counts );
+
+    // Workers can race on identical captures, each writes its own temporary
+    // and the rename makes whichever finishes last visible atomically
+    const std::string path      = cache_blob_path( cache, hash );
+    const std::string temporary = path + "." + std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) );
+
+    FILE *f = fopen( temporary.c_str(), "wb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    bool written = fwrite( &header, sizeof( header ), 1, f ) == 1
+                   && ( result->error.empty() || fwrite( result->error.data(), result->error.size(), 1, f ) == 1 )
+                   && ( result->durations_ms.empty()
+                        || fwrite( result->durations_ms.data(), sizeof( double ), result->durations_ms.size(), f ) == result->durations_ms.size() );
+
+    written = ( fclose( f ) == 0 ) && written;
+
+    if( !written || rename( temporary.c_str(), path.c_str() ) != 0 )
+    {
+        remove( temporary.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void cache_counts_pack( const edge_pairing_counts_t *counts, uint64_t *packed )
+{
+    packed[0] = counts->triggers;
+    packed[1] = counts->paired;
+    packed[2] = counts->lost;
+    packed[3] = counts->late;
+    packed[4] = counts->duplicated;
+    packed[5] = counts->orphaned;
+    packed[6] = counts->glitches;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void cache_counts_unpack( const uint64_t *packed, edge_pairing_counts_t *counts )
+{
+    counts->triggers   = packed[0];
+    counts->paired     = packed[1];
+    counts->lost       = packed[2];
+    counts->late       = packed[3];
+    counts->duplicated = packed[4];
+    counts->orphaned   = packed[5];
+    counts->glitches   = packed[6];
+}
+
+/* ----- End ---------------------------------------------------------------- */
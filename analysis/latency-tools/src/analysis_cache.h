@@ -0,0 +1,79 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "capture_latency.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Bump when the pairing or parsing changes what a capture produces, every
+// cached result is dropped on the next run
+#define ANALYSIS_CACHE_VERSION (2u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    uint64_t size;
+    int64_t  mtime_ns;
+    uint64_t hash;      // content hash, names the result blob
+} analysis_cache_entry_t;
+
+// Build graph state kept between runs in one folder:
+//  - captures: path -> size/mtime/content hash. An unchanged stat skips
+//    hashing, an unchanged hash skips parsing (e.g. after a git checkout).
+//  - outputs: path -> key of the inputs it was built from, so consolidated
+//    files and charts are only rebuilt when something they depend on changed.
+typedef struct
+{
+    std::string                                   dir;
+    std::mutex                                    lock;
+    std::map<std::string, analysis_cache_entry_t> captures;
+    std::map<std::string, uint64_t>               outputs;
+    std::atomic<uint64_t>                         hits;         // stat matched
+    std::atomic<uint64_t>                         rehashed;     // stat changed, content didn't
+    std::atomic<uint64_t>                         parsed;       // new or changed content
+} analysis_cache_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Loads the manifest from dir (created if needed). A missing or older
+ *  manifest just starts an empty cache.
+ */
+
+bool analysis_cache_open( analysis_cache_t *cache, const std::string &dir );
+
+/* -------------------------------------------------------------------------- */
+
+bool analysis_cache_save( analysis_cache_t *cache );
+
+/* -------------------------------------------------------------------------- */
+
+/** capture_latency_read() through the cache. hash gets the capture's content
+ *  hash for building output keys. Safe to call from several threads.
+ */
+
+bool analysis_cache_read( analysis_cache_t *cache, const std::string &path, capture_latency_t *result, uint64_t *hash );
+
+/* -------------------------------------------------------------------------- */
+
+/** True if output exists and was last built from inputs with the same key */
+
+bool analysis_cache_output_current( analysis_cache_t *cache, const std::string &output, uint64_t key );
+
+/* -------------------------------------------------------------------------- */
+
+void analysis_cache_output_built( analysis_cache_t *cache, const std::string &output, uint64_t key );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* ANALYSIS_CACHE_H */
@@ -0,0 +1,170 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <set>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "batch_ingest.h"
+#include "thread_pool.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    thread_pool_t                pool;
+    std::filesystem::path        root;
+    batch_options_t              options;
+    std::mutex                   lock;      // guards captures
+    std::vector<batch_capture_t> captures;
+} batch_job_t;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static void batch_scan_folder( batch_job_t *job, const std::filesystem::path &folder );
+static void batch_ingest_file( batch_job_t *job, const std::filesystem::path &file );
+static void batch_infer_tags( const std::filesystem::path &relative, batch_capture_t *capture );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool batch_ingest_run( const std::string &            root,
+                       const batch_options_t &        options,
+                       std::vector<batch_capture_t> * captures,
+                       batch_stats_t *                stats )
+{
+    std::error_code ec;
+
+    if( !std::filesystem::is_directory( root, ec ) )
+    {
+        return false;
+    }
+
+    batch_job_t job;
+    job.root    = root;
+    job.options = options;
+
+    const auto started = std::chrono::steady_clock::now();
+
+    thread_pool_start( &job.pool, options.worker_count );
+    const uint32_t workers = (uint32_t)job.pool.workers.size();
+
+    thread_pool_submit( &job.pool, [&job] { batch_scan_folder( &job, job.root ); } );
+    thread_pool_stop( &job.pool );
+
+    const auto finished = std::chrono::steady_clock::now();
+
+    std::sort( job.captures.begin(),
+               job.captures.end(),
+               []( const batch_capture_t &a, const batch_capture_t &b ) { return a.path < b.path; } );
+
+    stats->files     = job.captures.size();
+    stats->rows      = 0;
+    stats->steals    = job.pool.steals;
+    stats->workers   = workers;
+    stats->elapsed_s = std::chrono::duration<double>( finished - started ).count();
+
+    for( const batch_capture_t &capture : job.captures )
+    {
+        stats->rows += capture.latency.rows;
+    }
+
+    *captures = std::move( job.captures );
+    return true;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static void batch_scan_folder( batch_job_t *job, const std::filesystem::path &folder )
+{
+    std::error_code                    ec;
+    std::vector<std::filesystem::path> files;
+    std::set<std::string>              exported;    // stems that already have a csv
+
+    for( const auto &entry : std::filesystem::directory_iterator( folder, ec ) )
+    {
+        const std::string name = entry.path().filename().string();
+
+        // Skip hidden folders and our own build trees
+        if( name.empty() || name[0] == '.' )
+        {
+            continue;
+        }
+
+        if( entry.is_directory( ec ) )
+        {
+            const std::filesystem::path sub = entry.path();
+            thread_pool_submit( &job->pool, [job, sub] { batch_scan_folder( job, sub ); } );
+        }
+        else if( entry.is_regular_file( ec ) )
+        {
+            if( capture_latency_has_extension( name, ".csv" ) )
+            {
+                exported.insert( entry.path().stem().string() );
+                files.push_back( entry.path() );
+            }
+            else if( job->options.include_sal && capture_latency_has_extension( name, ".sal" ) )
+            {
+                files.push_back( entry.path() );
+            }
+        }
+    }
+
+    for( const std::filesystem::path &file : files )
+    {
+        // The csv is what the published charts used, prefer it over the raw capture
+        if( file.extension() == ".sal" && exported.count( file.stem().string() ) )
+        {
+            continue;
+        }
+
+        thread_pool_submit( &job->pool, [job, file] { batch_ingest_file( job, file ); } );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void batch_ingest_file( batch_job_t *job, const std::filesystem::path &file )
+{
+    batch_capture_t capture;
+    std::error_code ec;
+
+    const std::filesystem::path relative = std::filesystem::relative( file, job->root, ec );
+
+    capture.path    = ( ec ? file : relative ).generic_string();
+    capture.variant = file.stem().string();
+    capture.hash    = 0;
+
+    if( job->options.cache )
+    {
+        capture.ok = analysis_cache_read( job->options.cache, file.string(), &capture.latency, &capture.hash );
+    }
+    else
+    {
+        capture.ok = capture_latency_read( file.string(), &capture.latency );
+    }
+
+    batch_infer_tags( ec ? file : relative, &capture );
+
+    std::lock_guard<std::mutex> guard( job->lock );
+    job->captures.push_back( std::move( capture ) );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void batch_infer_tags( const std::filesystem::path &relative, batch_capture_t *capture )
+{
+    capture->tags = {};
+
+    // Most specific first: "12B-modified" then "esp-tcp"
+    dataset_naming_infer( capture->variant, &capture->tags );
+
+    for( std::filesystem::path folder = relative.parent_path(); !folder.empty(); folder = folder.parent_path() )
+    {
+        dataset_naming_infer( folder.filename().string(), &capture->tags );
+    }
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,58 @@
+#ifndef BATCH_INGEST_H
+#define BATCH_INGEST_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "analysis_cache.h"
+#include "capture_latency.h"
+#include "dataset_naming.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    uint32_t           worker_count;    // 0 = one per hardware thread
+    bool               include_sal;     // also read .sal captures that have no csv export
+    analysis_cache_t * cache;           // optional, reuses results for unchanged captures
+} batch_options_t;
+
+typedef struct
+{
+    std::string       path;     // relative to the walked root, e.g. "esp-tcp/12B-modified.csv"
+    std::string       variant;  // file name without the extension
+    dataset_tags_t    tags;     // inferred from the file and folder names
+    capture_latency_t latency;
+    bool              ok;       // false for csv files that aren't Logic 2 exports
+    uint64_t          hash;     // content hash, only set when reading through a cache
+} batch_capture_t;
+
+typedef struct
+{
+    uint64_t files;
+    uint64_t rows;
+    uint64_t steals;
+    uint32_t workers;
+    double   elapsed_s;
+} batch_stats_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Walks root and converts every capture to a latency vector on a work-stealing
+ *  pool. The walk itself runs as pool tasks, one per folder. Captures come back
+ *  sorted by path so the output doesn't depend on scheduling.
+ */
+
+bool batch_ingest_run( const std::string &            root,
+                       const batch_options_t &        options,
+                       std::vector<batch_capture_t> * captures,
+                       batch_stats_t *                stats );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* BATCH_INGEST_H */
@@ -0,0 +1,120 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "capture_latency.h"
+#include "edge_pairing.h"
+#include "saleae_csv.h"
+#include "saleae_sal.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool capture_latency_read_csv( const std::string &path, capture_latency_t *result );
+static bool capture_latency_read_sal( const std::string &path, capture_latency_t *result );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool capture_latency_read( const std::string &path, capture_latency_t *result )
+{
+    result->durations_ms.clear();
+    result->counts = {};
+    result->rows   = 0;
+    result->error.clear();
+
+    if( capture_latency_has_extension( path, ".sal" ) )
+    {
+        return capture_latency_read_sal( path, result );
+    }
+
+    return capture_latency_read_csv( path, result );
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool capture_latency_has_extension( const std::string &name, const char *extension )
+{
+    const size_t length = strlen( extension );
+
+    return name.size() > length && name.compare( name.size() - length, length, extension ) == 0;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static bool capture_latency_read_csv( const std::string &path, capture_latency_t *result )
+{
+    saleae_csv_t   csv;
+    saleae_row_t   row;
+    edge_pairing_t pairing;
+
+    if( !saleae_csv_open( &csv, path.c_str() ) )
+    {
+        result->error = "not a Saleae Logic 2 csv export";
+        return false;
+    }
+
+    if( csv.channel_count < 2 )
+    {
+        result->error = "expected trigger and done channels";
+        saleae_csv_close( &csv );
+        return false;
+    }
+
+    edge_pairing_init( &pairing, 0, 1 );
+
+    while( saleae_csv_next( &csv, &row ) )
+    {
+        edge_pairing_feed( &pairing, &row, &result->durations_ms );
+        result->rows++;
+    }
+
+    edge_pairing_finish( &pairing, &result->durations_ms );
+    result->counts = pairing.counts;
+
+    bool ok = csv.eof;
+    if( !ok )
+    {
+        result->error = "malformed row at line " + std::to_string( csv.line );
+    }
+
+    saleae_csv_close( &csv );
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool capture_latency_read_sal( const std::string &path, capture_latency_t *result )
+{
+    saleae_sal_t              sal;
+    std::vector<saleae_row_t> rows;
+    edge_pairing_t            pairing;
+
+    if( !saleae_sal_open( &sal, path.c_str() ) )
+    {
+        result->error = "not a readable Logic 2 capture";
+        return false;
+    }
+
+    if( sal.channels.size() < 2 || sal.channels[0].channel != 0 || sal.channels[1].channel != 1 )
+    {
+        result->error = "expected trigger and done channels";
+        return false;
+    }
+
+    // Only merge the two channels we pair, so the rows match a csv export of CH0/CH1
+    saleae_sal_rows( &sal, 0x3u, &rows );
+    edge_pairing_init( &pairing, 0, 1 );
+
+    for( const saleae_row_t &row : rows )
+    {
+        edge_pairing_feed( &pairing, &row, &result->durations_ms );
+    }
+
+    edge_pairing_finish( &pairing, &result->durations_ms );
+    result->counts = pairing.counts;
+    result->rows   = rows.size();
+    return true;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,41 @@
+#ifndef CAPTURE_LATENCY_H
+#define CAPTURE_LATENCY_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "edge_pairing.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    std::vector<double>   durations_ms;
+    edge_pairing_counts_t counts;     // how every trigger was classified
+    uint64_t              rows;       // edge rows read from the capture
+    std::string           error;      // why the read failed
+} capture_latency_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Reads a Logic 2 csv export or .sal capture (picked by extension) and pairs
+ *  the CH0 triggers with the CH1 done strobes. Lost, late and duplicated
+ *  completions are counted in result->counts. Safe to call from several threads.
+ */
+
+bool capture_latency_read( const std::string &path, capture_latency_t *result );
+
+/* -------------------------------------------------------------------------- */
+
+/** True for file names ending in extension, e.g. ".csv" */
+
+bool capture_latency_has_extension( const std::string &name, const char *extension );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* CAPTURE_LATENCY_H */
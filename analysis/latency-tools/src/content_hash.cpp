@@ -0,0 +1,190 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "content_hash.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define HASH_PRIME_1 (0x9E3779B185EBCA87ull)
+#define HASH_PRIME_2 (0xC2B2AE3D27D4EB4Full)
+#define HASH_PRIME_3 (0x165667B19E3779F9ull)
+#define HASH_PRIME_4 (0x85EBCA77C2B2AE63ull)
+#define HASH_PRIME_5 (0x27D4EB2F165667C5ull)
+
+#define HASH_FILE_CHUNK (1u << 20)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint64_t hash_rotl( uint64_t value, int bits );
+static uint64_t hash_read64( const uint8_t *p );
+static uint32_t hash_read32( const uint8_t *p );
+static uint64_t hash_round( uint64_t accumulator, uint64_t input );
+static uint64_t hash_merge( uint64_t accumulator, uint64_t value );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+uint64_t content_hash( const void *data, size_t length, uint64_t seed )
+{
+    const uint8_t *p   = (const uint8_t *)data;
+    const uint8_t *end = p + length;
+    uint64_t       h;
+
+    if( length >= 32 )
+    {
+        uint64_t v1 = seed + HASH_PRIME_1 + HASH_PRIME_2;
+        uint64_t v2 = seed + HASH_PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - HASH_PRIME_1;
+
+        // Four independent lanes so the multiplies pipeline
+        do
+        {
+            v1 = hash_round( v1, hash_read64( p ) );
+            v2 = hash_round( v2, hash_read64( p + 8 ) );
+            v3 = hash_round( v3, hash_read64( p + 16 ) );
+            v4 = hash_round( v4, hash_read64( p + 24 ) );
+            p += 32;
+        } while( p + 32 <= end );
+
+        h = hash_rotl( v1, 1 ) + hash_rotl( v2, 7 ) + hash_rotl( v3, 12 ) + hash_rotl( v4, 18 );
+        h = hash_merge( h, v1 );
+        h = hash_merge( h, v2 );
+        h = hash_merge( h, v3 );
+        h = hash_merge( h, v4 );
+    }
+    else
+    {
+        h = seed + HASH_PRIME_5;
+    }
+
+    h += (uint64_t)length;
+
+    for( ; p + 8 <= end; p += 8 )
+    {
+        h ^= hash_round( 0, hash_read64( p ) );
+        h = hash_rotl( h, 27 ) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+
+    if( p + 4 <= end )
+    {
+        h ^= (uint64_t)hash_read32( p ) * HASH_PRIME_1;
+        h = hash_rotl( h, 23 ) * HASH_PRIME_2 + HASH_PRIME_3;
+        p += 4;
+    }
+
+    for( ; p < end; p++ )
+    {
+        h ^= (uint64_t)*p * HASH_PRIME_5;
+        h = hash_rotl( h, 11 ) * HASH_PRIME_1;
+    }
+
+    h ^= h >> 33;
+    h *= HASH_PRIME_2;
+    h ^= h >> 29;
+    h *= HASH_PRIME_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool content_hash_file( const char *path, uint64_t *hash )
+{
+    FILE *f = fopen( path, "rb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    // Captures are a few MB at most, hash them in one piece
+    std::vector<uint8_t> data;
+    size_t               used = 0;
+
+    for( ;; )
+    {
+        data.resize( used + HASH_FILE_CHUNK );
+        const size_t got = fread( data.data() + used, 1, HASH_FILE_CHUNK, f );
+        used += got;
+
+        if( got < HASH_FILE_CHUNK )
+        {
+            break;
+        }
+    }
+
+    const bool ok = !ferror( f );
+    fclose( f );
+
+    *hash = content_hash( data.data(), used, 0 );
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t content_hash_combine( uint64_t key, uint64_t value )
+{
+    uint8_t bytes[16];
+
+    memcpy( bytes, &key, 8 );
+    memcpy( bytes + 8, &value, 8 );
+
+    return content_hash( bytes, sizeof( bytes ), 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t content_hash_string( const std::string &text, uint64_t seed )
+{
+    return content_hash( text.data(), text.size(), seed );
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static uint64_t hash_rotl( uint64_t value, int bits )
+{
+    return ( value << bits ) | ( value >> ( 64 - bits ) );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t hash_read64( const uint8_t *p )
+{
+    uint64_t value;
+    memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t hash_read32( const uint8_t *p )
+{
+    uint32_t value;
+    memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t hash_round( uint64_t accumulator, uint64_t input )
+{
+    accumulator += input * HASH_PRIME_2;
+    accumulator = hash_rotl( accumulator, 31 );
+    return accumulator * HASH_PRIME_1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t hash_merge( uint64_t accumulator, uint64_t value )
+{
+    accumulator ^= hash_round( 0, value );
+    return accumulator * HASH_PRIME_1 + HASH_PRIME_4;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,37 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** XXH64 of a buffer. Fast enough that hashing a capture costs less than
+ *  parsing it, and wide enough that collisions across a few thousand
+ *  captures aren't a concern.
+ */
+
+uint64_t content_hash( const void *data, size_t length, uint64_t seed );
+
+/* -------------------------------------------------------------------------- */
+
+/** Hashes a whole file */
+
+bool content_hash_file( const char *path, uint64_t *hash );
+
+/* -------------------------------------------------------------------------- */
+
+/** Folds another value into a running key, for hashing lists of hashes */
+
+uint64_t content_hash_combine( uint64_t key, uint64_t value );
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t content_hash_string( const std::string &text, uint64_t seed );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* CONTENT_HASH_H */
@@ -0,0 +1,170 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "dataset_naming.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    const char *token;
+    const char *transport;
+} naming_transport_t;
+
+/* ----- Private Variables -------------------------------------------------- */
+
+// Folder names under firmware/ and the labels used in the analysis csv headers
+static const naming_transport_t naming_transports[] = {
+    { "espnow",     "espnow" },
+    { "spp",        "spp" },
+    { "ble",        "bluedroid" },
+    { "bluedroid",  "bluedroid" },
+    { "nimble",     "nimble" },
+    { "tcp",        "tcp" },
+    { "udp",        "udp" },
+    { "websockets", "websockets" },
+    { "ws",         "websockets" },
+    { "802154",     "802154" },
+    { "ethernet",   "ethernet" },
+    { "eth",        "ethernet" },
+    { "wifi",       "wifi" },
+    { "hc",         "hc-05" },
+    { "nrf24",      "nrf24" },
+    { "nrf52",      "nrf52" },
+    { "nrf58240",   "nrf52" },
+    { "rfm95",      "lora" },
+    { "lora",       "lora" },
+    { "sik",        "sik" },
+    { "uart",       "uart" },
+    { "gpio",       "gpio" },
+};
+
+// Words that describe how the firmware was built or configured
+static const char *const naming_flags[] = {
+    "dma",      "irq",      "poll",     "debug",    "release",    "minsize", "relsmall",
+    "o1",       "o2",       "o3",       "os",       "og",         "ll",      "stm32duino",
+    "espidf",   "defaults", "modified", "chunked",  "padded",     "nagles",  "throughput",
+    "ack",      "faf",      "lr",       "hci",      "fix",        "override", "connparams",
+    "swept",    "fixed",    "sc",       "cs",       "notify",     "write",   "mtu20",
+};
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static std::vector<std::string> naming_tokens( const std::string &text );
+static bool naming_payload( const std::string &token, uint32_t *bytes );
+static void naming_add_flag( std::string *flags, const char *flag );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void dataset_naming_infer( const std::string &text, dataset_tags_t *tags )
+{
+    for( const std::string &token : naming_tokens( text ) )
+    {
+        uint32_t bytes = 0;
+
+        if( tags->payload_bytes == 0 && naming_payload( token, &bytes ) )
+        {
+            tags->payload_bytes = bytes;
+            continue;
+        }
+
+        if( tags->transport.empty() )
+        {
+            for( const naming_transport_t &transport : naming_transports )
+            {
+                if( token == transport.token )
+                {
+                    tags->transport = transport.transport;
+                    break;
+                }
+            }
+        }
+
+        for( const char *flag : naming_flags )
+        {
+            if( token == flag )
+            {
+                naming_add_flag( &tags->build_flags, flag );
+                break;
+            }
+        }
+    }
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static std::vector<std::string> naming_tokens( const std::string &text )
+{
+    std::vector<std::string> tokens;
+    std::string              token;
+
+    for( char c : text )
+    {
+        if( isalnum( (unsigned char)c ) )
+        {
+            token += (char)tolower( (unsigned char)c );
+        }
+        else if( !token.empty() )
+        {
+            tokens.push_back( token );
+            token.clear();
+        }
+    }
+
+    if( !token.empty() )
+    {
+        tokens.push_back( token );
+    }
+
+    return tokens;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// "12b", "1024b" - but not "2mbps" or "64k5"
+static bool naming_payload( const std::string &token, uint32_t *bytes )
+{
+    if( token.size() < 2 || token.back() != 'b' )
+    {
+        return false;
+    }
+
+    for( size_t i = 0; i + 1 < token.size(); i++ )
+    {
+        if( !isdigit( (unsigned char)token[i] ) )
+        {
+            return false;
+        }
+    }
+
+    *bytes = (uint32_t)strtoul( token.c_str(), 0, 10 );
+    return *bytes > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void naming_add_flag( std::string *flags, const char *flag )
+{
+    // Flags are short and few, a substring search against ",a,b," is plenty
+    const std::string wrapped = "," + *flags + ",";
+    const std::string needle  = std::string( "," ) + flag + ",";
+
+    if( wrapped.find( needle ) != std::string::npos )
+    {
+        return;
+    }
+
+    if( !flags->empty() )
+    {
+        *flags += ',';
+    }
+
+    *flags += flag;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,31 @@
+#ifndef DATASET_NAMING_H
+#define DATASET_NAMING_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+
+/* ----- Types -------------------------------------------------------------- */
+
+// What can be worked out from the file, folder and column names used in this repo,
+// e.g. "firmware/esp-tcp/12B-modified.csv" or the "1024B-NimBLE" column
+typedef struct
+{
+    std::string transport;      // canonical short name, "tcp", "nimble", "lora" ...
+    std::string build_flags;    // comma separated variant words, "dma,release"
+    uint32_t    payload_bytes;  // 0 if unknown
+} dataset_tags_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Tokenises text (any mix of '-', '_', ' ', '/', '.' separators, case insensitive)
+ *  and fills in whatever tags it recognises. Fields already set are kept, so call
+ *  it with the most specific name first (column, then file, then folders).
+ */
+
+void dataset_naming_infer( const std::string &text, dataset_tags_t *tags );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* DATASET_NAMING_H */
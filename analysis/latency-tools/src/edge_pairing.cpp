@@ -0,0 +1,172 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "edge_pairing.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint32_t edge_pairing_close_window( edge_pairing_t *pairing, std::vector<double> *durations_ms );
+static void edge_pairing_emit( int64_t start_ns, int64_t end_ns, std::vector<double> *durations_ms );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void edge_pairing_init( edge_pairing_t *pairing, uint32_t trigger_channel, uint32_t done_channel )
+{
+    pairing->trigger_mask    = 1u << trigger_channel;
+    pairing->done_mask       = 1u << done_channel;
+    pairing->have_previous   = false;
+    pairing->previous        = 0;
+    pairing->window_open     = false;
+    pairing->window_start_ns = 0;
+    pairing->window_dones    = 0;
+    pairing->trigger_fall_ns = INT64_MIN;
+    pairing->carry           = false;
+    pairing->carry_start_ns  = 0;
+    pairing->counts          = {};
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t edge_pairing_feed( edge_pairing_t *pairing, const saleae_row_t *row, std::vector<double> *durations_ms )
+{
+    uint32_t emitted = 0;
+
+    // The first row is the level at the start of the capture, not an edge
+    if( !pairing->have_previous )
+    {
+        pairing->previous      = row->channels;
+        pairing->have_previous = true;
+        return 0;
+    }
+
+    const uint32_t rising  = row->channels & ~pairing->previous;
+    const uint32_t falling = pairing->previous & ~row->channels;
+
+    // A done rising on the same sample as a trigger can't be its response,
+    // so it's counted against the window that is closing
+    if( rising & pairing->done_mask )
+    {
+        if( pairing->window_open )
+        {
+            if( pairing->window_dones < 2 )
+            {
+                pairing->window_done_ns[pairing->window_dones] = row->time_ns;
+            }
+
+            pairing->window_dones++;
+        }
+        else
+        {
+            pairing->counts.orphaned++;
+        }
+    }
+
+    if( falling & pairing->trigger_mask )
+    {
+        pairing->trigger_fall_ns = row->time_ns;
+    }
+
+    if( ( rising & pairing->trigger_mask ) && pairing->window_open && pairing->window_dones == 0
+        && row->time_ns - EDGE_PAIRING_GLITCH_NS < pairing->trigger_fall_ns )
+    {
+        pairing->counts.glitches++;
+    }
+    else if( rising & pairing->trigger_mask )
+    {
+        if( pairing->window_open )
+        {
+            emitted = edge_pairing_close_window( pairing, durations_ms );
+        }
+
+        pairing->window_open     = true;
+        pairing->window_start_ns = row->time_ns;
+        pairing->window_dones    = 0;
+        pairing->counts.triggers++;
+    }
+
+    pairing->previous = row->channels;
+    return emitted;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t edge_pairing_finish( edge_pairing_t *pairing, std::vector<double> *durations_ms )
+{
+    uint32_t emitted = 0;
+
+    if( pairing->window_open )
+    {
+        emitted              = edge_pairing_close_window( pairing, durations_ms );
+        pairing->window_open = false;
+    }
+
+    // Nothing left that could complete it
+    if( pairing->carry )
+    {
+        pairing->counts.lost++;
+        pairing->carry = false;
+    }
+
+    return emitted;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static uint32_t edge_pairing_close_window( edge_pairing_t *pairing, std::vector<double> *durations_ms )
+{
+    edge_pairing_counts_t *counts  = &pairing->counts;
+    uint32_t               dones   = pairing->window_dones;
+    uint32_t               next    = 0;    // first done not yet claimed
+    uint32_t               emitted = 0;
+
+    if( pairing->carry )
+    {
+        // Two completions after the next trigger: the first one is the late
+        // reply to the carried trigger. Otherwise the carried one never made it.
+        if( dones >= 2 )
+        {
+            edge_pairing_emit( pairing->carry_start_ns, pairing->window_done_ns[0], durations_ms );
+            counts->late++;
+            emitted++;
+            next = 1;
+        }
+        else
+        {
+            counts->lost++;
+        }
+
+        pairing->carry = false;
+    }
+
+    if( dones > next )
+    {
+        edge_pairing_emit( pairing->window_start_ns, pairing->window_done_ns[next], durations_ms );
+        emitted++;
+
+        if( dones - next > 1 )
+        {
+            counts->duplicated++;
+        }
+        else
+        {
+            counts->paired++;
+        }
+    }
+    else
+    {
+        pairing->carry          = true;
+        pairing->carry_start_ns = pairing->window_start_ns;
+    }
+
+    return emitted;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void edge_pairing_emit( int64_t start_ns, int64_t end_ns, std::vector<double> *durations_ms )
+{
+    durations_ms->push_back( (double)( end_ns - start_ns ) / 1e6 );
+}
+
+/* ----- End ---------------------------------------------------------------- */
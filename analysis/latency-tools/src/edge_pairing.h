@@ -0,0 +1,81 @@
+#ifndef EDGE_PAIRING_H
+#define EDGE_PAIRING_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "saleae_csv.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// A trigger that rises again this soon after falling is contact/ringing noise
+// on the same trigger (rfm95/64k5-SF2048-4o6-1024B has a 150ns re-pulse 20ns
+// after every trigger), not a new one
+#define EDGE_PAIRING_GLITCH_NS (1000)
+
+/* ----- Types -------------------------------------------------------------- */
+
+// What happened to each trigger. Every trigger lands in exactly one class.
+typedef struct
+{
+    uint64_t triggers;
+    uint64_t paired;        // one done before the next trigger
+    uint64_t lost;          // never completed
+    uint64_t late;          // completed after the next trigger had already fired
+    uint64_t duplicated;    // more than one done before the next trigger
+    uint64_t orphaned;      // done edges before the first trigger, not counted as triggers
+    uint64_t glitches;      // trigger re-pulses merged into the trigger before them
+} edge_pairing_counts_t;
+
+// Streaming trigger/done pairing. Each trigger's rising edge opens a window
+// that lasts until the next trigger, the done edges inside it decide its class
+// once it closes:
+//  - 1 done                          -> paired
+//  - 2+ dones                        -> paired, extras make it duplicated
+//  - 0 dones                         -> undecided, carried into the next window
+//  - carried, next window has 2+     -> first done belongs to the carried trigger (late)
+//  - carried, next window has 0 or 1 -> the carried trigger was lost
+// A lost completion used to inflate the previous trigger's duration instead of
+// being reported, and a double completion was silently dropped.
+typedef struct
+{
+    uint32_t              trigger_mask;
+    uint32_t              done_mask;
+    bool                  have_previous;
+    uint32_t              previous;
+    bool                  window_open;
+    int64_t               window_start_ns;  // trigger that opened the current window
+    uint32_t              window_dones;
+    int64_t               window_done_ns[2];
+    int64_t               trigger_fall_ns;  // last falling edge of the current window's trigger
+    bool                  carry;            // previous trigger still has no done
+    int64_t               carry_start_ns;
+    edge_pairing_counts_t counts;
+} edge_pairing_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void edge_pairing_init( edge_pairing_t *pairing, uint32_t trigger_channel, uint32_t done_channel );
+
+/* -------------------------------------------------------------------------- */
+
+/** Feed rows in capture order. Durations (milliseconds) of paired, duplicated
+ *  and late triggers are appended to durations_ms in trigger order once the
+ *  trigger's window closes, the number appended is returned.
+ */
+
+uint32_t edge_pairing_feed( edge_pairing_t *pairing, const saleae_row_t *row, std::vector<double> *durations_ms );
+
+/* -------------------------------------------------------------------------- */
+
+/** Closes the last window at the end of the capture */
+
+uint32_t edge_pairing_finish( edge_pairing_t *pairing, std::vector<double> *durations_ms );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* EDGE_PAIRING_H */
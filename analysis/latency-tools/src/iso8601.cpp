@@ -0,0 +1,380 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "iso8601.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    #define ISO8601_USE_SWAR
+#endif
+
+// Per-byte helpers for the SWAR path
+#define BYTES_0x0F (0x0F0F0F0F0F0F0F0FULL)
+#define BYTES_0xF0 (0xF0F0F0F0F0F0F0F0ULL)
+#define BYTES_0x30 (0x3030303030303030ULL)
+#define BYTES_0x06 (0x0606060606060606ULL)
+#define BYTES_0x10 (0x1010101010101010ULL)
+
+// The UTC offset sign lands in byte 2 of the word loaded at str[27], it's checked separately
+#define ISO8601_SIGN_BYTE (0x0000000000FF0000ULL)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool iso8601_digits( const char *str, uint32_t count, uint32_t *value );
+
+#ifdef ISO8601_USE_SWAR
+static uint64_t iso8601_load( const char *str );
+static bool     iso8601_word_ok( uint64_t word, uint64_t digit_mask, uint64_t separators );
+static uint64_t iso8601_pairs( uint64_t word );
+static uint32_t iso8601_eight_digits( uint64_t word );
+static bool     iso8601_parse_swar( const char *str, size_t len, int64_t *seconds, uint32_t *fraction );
+#endif
+
+static bool iso8601_apply_offset( const char *str, int64_t *seconds );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool iso8601_parse_ns( const char *str, size_t len, int64_t *ns )
+{
+#ifdef ISO8601_USE_SWAR
+    int64_t  seconds;
+    uint32_t fraction;
+
+    if( !iso8601_parse_swar( str, len, &seconds, &fraction ) )
+    {
+        return false;
+    }
+
+    *ns = seconds * 1000000000LL + fraction;
+    return true;
+#else
+    return iso8601_parse_ns_reference( str, len, ns );
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool iso8601_parse_ns_cached( iso8601_cache_t *cache, const char *str, size_t len, int64_t *ns )
+{
+    if( len < ISO8601_SALEAE_LENGTH )
+    {
+        return false;
+    }
+
+    if(    !cache->valid
+        || memcmp( cache->prefix, str, ISO8601_PREFIX_LENGTH ) != 0
+        || memcmp( cache->suffix, &str[ISO8601_SUFFIX_OFFSET], ISO8601_SUFFIX_LENGTH ) != 0 )
+    {
+        // New minute, take the full path and remember where the minute starts
+        int64_t full;
+        if( !iso8601_parse_ns( str, len, &full ) )
+        {
+            cache->valid = false;
+            return false;
+        }
+
+        uint32_t second = (uint32_t)( str[17] - '0' ) * 10 + (uint32_t)( str[18] - '0' );
+
+        memcpy( cache->prefix, str, ISO8601_PREFIX_LENGTH );
+        memcpy( cache->suffix, &str[ISO8601_SUFFIX_OFFSET], ISO8601_SUFFIX_LENGTH );
+        cache->prefix_seconds = ( full - ( full % 1000000000LL ) ) / 1000000000LL - second;
+        cache->valid          = true;
+
+        *ns = full;
+        return true;
+    }
+
+    // Same minute and offset, only ":SS.nnnnnnnnn" is left to validate and parse
+    uint32_t second, fraction;
+
+#ifdef ISO8601_USE_SWAR
+    const uint64_t w2 = iso8601_load( &str[16] );
+    const uint64_t wf = iso8601_load( &str[20] );
+
+    if(    !iso8601_word_ok( w2, 0xFFFFFFFF00FFFF00ULL, 0x000000002E00003AULL )
+        || !iso8601_word_ok( wf, 0xFFFFFFFFFFFFFFFFULL, 0 )
+        || (uint32_t)( str[28] - '0' ) > 9 )
+    {
+        return false;
+    }
+
+    second   = (uint32_t)( ( iso8601_pairs( w2 ) >> 8 ) & 0xFF );
+    fraction = iso8601_eight_digits( wf ) * 10 + (uint32_t)( str[28] - '0' );
+#else
+    if(    str[16] != ':' || str[19] != '.'
+        || !iso8601_digits( &str[17], 2, &second )
+        || !iso8601_digits( &str[20], 9, &fraction ) )
+    {
+        return false;
+    }
+#endif
+
+    *ns = ( cache->prefix_seconds + second ) * 1000000000LL + fraction;
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool iso8601_parse_ns_reference( const char *str, size_t len, int64_t *ns )
+{
+    if( len < ISO8601_SALEAE_LENGTH )
+    {
+        return false;
+    }
+
+    // Separators sit at fixed offsets
+    if(    str[4]  != '-' || str[7]  != '-' || str[10] != 'T'
+        || str[13] != ':' || str[16] != ':' || str[19] != '.'
+        || ( str[29] != '+' && str[29] != '-' ) || str[32] != ':' )
+    {
+        return false;
+    }
+
+    uint32_t year, month, day, hour, minute, second, fraction;
+
+    if(    !iso8601_digits( &str[0],  4, &year )
+        || !iso8601_digits( &str[5],  2, &month )
+        || !iso8601_digits( &str[8],  2, &day )
+        || !iso8601_digits( &str[11], 2, &hour )
+        || !iso8601_digits( &str[14], 2, &minute )
+        || !iso8601_digits( &str[17], 2, &second )
+        || !iso8601_digits( &str[20], 9, &fraction ) )
+    {
+        return false;
+    }
+
+    if( month < 1 || month > 12 || day < 1 || day > 31 )
+    {
+        return false;
+    }
+
+    int64_t seconds = iso8601_days_from_civil( year, month, day ) * 86400
+                      + hour * 3600 + minute * 60 + second;
+
+    if( !iso8601_apply_offset( str, &seconds ) )
+    {
+        return false;
+    }
+
+    *ns = seconds * 1000000000LL + fraction;
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Howard Hinnant's days_from_civil, valid for the whole int64 year range we care about
+int64_t iso8601_days_from_civil( int64_t year, uint32_t month, uint32_t day )
+{
+    year -= ( month <= 2 );
+
+    const int64_t  era = ( year >= 0 ? year : year - 399 ) / 400;
+    const uint32_t yoe = (uint32_t)( year - era * 400 );
+    const uint32_t doy = ( 153 * ( month > 2 ? month - 3 : month + 9 ) + 2 ) / 5 + day - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void iso8601_format_ns( int64_t ns, char *out )
+{
+    int64_t seconds  = ns / 1000000000LL;
+    int64_t fraction = ns % 1000000000LL;
+
+    if( fraction < 0 )
+    {
+        fraction += 1000000000LL;
+        seconds -= 1;
+    }
+
+    int64_t days          = seconds / 86400;
+    int64_t second_of_day = seconds % 86400;
+
+    if( second_of_day < 0 )
+    {
+        second_of_day += 86400;
+        days -= 1;
+    }
+
+    // Inverse of days_from_civil
+    days += 719468;
+
+    const int64_t  era   = ( days >= 0 ? days : days - 146096 ) / 146097;
+    const uint32_t doe   = (uint32_t)( days - era * 146097 );
+    const uint32_t yoe   = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+    const uint32_t doy   = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+    const uint32_t mp    = ( 5 * doy + 2 ) / 153;
+    const uint32_t day   = doy - ( 153 * mp + 2 ) / 5 + 1;
+    const uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t  year  = (int64_t)yoe + era * 400 + ( month <= 2 );
+
+    // Oversized buffer so far-off years truncate rather than upset -Wformat-truncation
+    char text[64];
+
+    snprintf( text,
+              sizeof( text ),
+              "%04lld-%02u-%02uT%02u:%02u:%02u.%09lld+00:00",
+              (long long)year,
+              month,
+              day,
+              (uint32_t)( second_of_day / 3600 ),
+              (uint32_t)( second_of_day / 60 % 60 ),
+              (uint32_t)( second_of_day % 60 ),
+              (long long)fraction );
+
+    memcpy( out, text, ISO8601_SALEAE_LENGTH );
+    out[ISO8601_SALEAE_LENGTH] = '\0';
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static bool iso8601_digits( const char *str, uint32_t count, uint32_t *value )
+{
+    uint32_t result = 0;
+
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        uint32_t digit = (uint32_t)( str[i] - '0' );
+
+        if( digit > 9 )
+        {
+            return false;
+        }
+
+        result = result * 10 + digit;
+    }
+
+    *value = result;
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Shift local time back to UTC using the trailing "+hh:mm"
+static bool iso8601_apply_offset( const char *str, int64_t *seconds )
+{
+    uint32_t tz_hour, tz_minute;
+
+    if( !iso8601_digits( &str[30], 2, &tz_hour ) || !iso8601_digits( &str[33], 2, &tz_minute ) )
+    {
+        return false;
+    }
+
+    int64_t offset = (int64_t)tz_hour * 3600 + tz_minute * 60;
+    *seconds -= ( str[29] == '-' ) ? -offset : offset;
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef ISO8601_USE_SWAR
+
+static uint64_t iso8601_load( const char *str )
+{
+    uint64_t word;
+    memcpy( &word, str, sizeof(word) );
+    return word;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Checks all bytes under digit_mask are '0'-'9', and the rest match the separators
+static bool iso8601_word_ok( uint64_t word, uint64_t digit_mask, uint64_t separators )
+{
+    const uint64_t high_nibbles = word & BYTES_0xF0 & digit_mask;
+    const uint64_t over_nine    = ( ( word & BYTES_0x0F ) + BYTES_0x06 ) & BYTES_0x10 & digit_mask;
+
+    return ( ( word & ~digit_mask ) == separators )
+           && ( high_nibbles == ( BYTES_0x30 & digit_mask ) )
+           && ( over_nine == 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Byte i of the result holds the two digit value of input bytes i and i+1.
+// Bytes are <= 15 after masking, so nothing carries between lanes.
+static uint64_t iso8601_pairs( uint64_t word )
+{
+    const uint64_t digits = word & BYTES_0x0F;
+    return digits * 10 + ( digits >> 8 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t iso8601_eight_digits( uint64_t word )
+{
+    uint64_t v = iso8601_pairs( word );
+
+    // Combine pairs into 4 digit groups, then the two groups into one value
+    v = ( ( ( v & 0x000000FF000000FFULL ) * ( 100 + ( 1000000ULL << 32 ) ) )
+          + ( ( ( v >> 16 ) & 0x000000FF000000FFULL ) * ( 1 + ( 10000ULL << 32 ) ) ) ) >> 32;
+
+    return (uint32_t)v;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool iso8601_parse_swar( const char *str, size_t len, int64_t *seconds, uint32_t *fraction )
+{
+    if( len < ISO8601_SALEAE_LENGTH )
+    {
+        return false;
+    }
+
+    // Five overlapping 8-byte loads cover the 35 characters
+    //      w0  "YYYY-MM-"    w1  "DDTHH:MM"    w2  ":SS.nnnn"
+    //      wf  "nnnnnnnn"    w4  "nn+hh:mm"
+    const uint64_t w0 = iso8601_load( &str[0] );
+    const uint64_t w1 = iso8601_load( &str[8] );
+    const uint64_t w2 = iso8601_load( &str[16] );
+    const uint64_t wf = iso8601_load( &str[20] );
+    const uint64_t w4 = iso8601_load( &str[27] ) & ~ISO8601_SIGN_BYTE;
+
+    if(    !iso8601_word_ok( w0, 0x00FFFF00FFFFFFFFULL, 0x2D00002D00000000ULL )
+        || !iso8601_word_ok( w1, 0xFFFF00FFFF00FFFFULL, 0x00003A0000540000ULL )
+        || !iso8601_word_ok( w2, 0xFFFFFFFF00FFFF00ULL, 0x000000002E00003AULL )
+        || !iso8601_word_ok( wf, 0xFFFFFFFFFFFFFFFFULL, 0 )
+        || !iso8601_word_ok( w4, 0xFFFF00FFFF00FFFFULL, 0x00003A0000000000ULL )
+        || ( str[29] != '+' && str[29] != '-' ) )
+    {
+        return false;
+    }
+
+    const uint64_t p0 = iso8601_pairs( w0 );
+    const uint64_t p1 = iso8601_pairs( w1 );
+    const uint64_t p2 = iso8601_pairs( w2 );
+    const uint64_t p4 = iso8601_pairs( w4 );
+
+    const uint32_t year      = (uint32_t)( p0 & 0xFF ) * 100 + (uint32_t)( ( p0 >> 16 ) & 0xFF );
+    const uint32_t month     = (uint32_t)( ( p0 >> 40 ) & 0xFF );
+    const uint32_t day       = (uint32_t)( p1 & 0xFF );
+    const uint32_t hour      = (uint32_t)( ( p1 >> 24 ) & 0xFF );
+    const uint32_t minute    = (uint32_t)( ( p1 >> 48 ) & 0xFF );
+    const uint32_t second    = (uint32_t)( ( p2 >> 8 ) & 0xFF );
+    const uint32_t tz_hour   = (uint32_t)( ( p4 >> 24 ) & 0xFF );
+    const uint32_t tz_minute = (uint32_t)( ( p4 >> 48 ) & 0xFF );
+
+    if( month < 1 || month > 12 || day < 1 || day > 31 )
+    {
+        return false;
+    }
+
+    int64_t offset = (int64_t)tz_hour * 3600 + tz_minute * 60;
+
+    *seconds = iso8601_days_from_civil( year, month, day ) * 86400
+               + hour * 3600 + minute * 60 + second
+               - ( ( str[29] == '-' ) ? -offset : offset );
+
+    *fraction = iso8601_eight_digits( wf ) * 10 + (uint32_t)( ( w4 >> 8 ) & 0x0F );
+    return true;
+}
+
+#endif
+
+/* ----- End ---------------------------------------------------------------- */
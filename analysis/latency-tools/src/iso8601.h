@@ -0,0 +1,70 @@
+#ifndef ISO8601_H
+#define ISO8601_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Saleae Logic 2 exports use a fixed layout timestamp
+//      2023-10-25T23:16:40.773227200+00:00
+#define ISO8601_SALEAE_LENGTH (35u)
+
+// "YYYY-MM-DDTHH:MM" only changes once a minute in a capture,
+// and the "+hh:mm" UTC offset never does
+#define ISO8601_PREFIX_LENGTH (16u)
+#define ISO8601_SUFFIX_OFFSET (29u)
+#define ISO8601_SUFFIX_LENGTH (6u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Remembers the last date/hour/minute prefix and UTC offset so consecutive rows
+// skip the calendar maths. Zero-initialise before first use.
+typedef struct
+{
+    char    prefix[ISO8601_PREFIX_LENGTH];
+    char    suffix[ISO8601_SUFFIX_LENGTH];
+    int64_t prefix_seconds;     // UTC seconds at the start of the cached minute
+    bool    valid;
+} iso8601_cache_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Parses a Saleae style ISO-8601 timestamp into nanoseconds since the unix epoch.
+ *  Returns false if the string doesn't match the expected fixed layout.
+ *  Uses the SWAR implementation on little-endian hosts.
+ */
+
+bool iso8601_parse_ns( const char *str, size_t len, int64_t *ns );
+
+/* -------------------------------------------------------------------------- */
+
+/** Same as iso8601_parse_ns, but re-uses the date/time prefix from the previous call */
+
+bool iso8601_parse_ns_cached( iso8601_cache_t *cache, const char *str, size_t len, int64_t *ns );
+
+/* -------------------------------------------------------------------------- */
+
+/** Digit-at-a-time parser, kept as the reference for benchmarks and big-endian hosts */
+
+bool iso8601_parse_ns_reference( const char *str, size_t len, int64_t *ns );
+
+/* -------------------------------------------------------------------------- */
+
+/** Days since 1970-01-01 for a proleptic Gregorian calendar date */
+
+int64_t iso8601_days_from_civil( int64_t year, uint32_t month, uint32_t day );
+
+/* -------------------------------------------------------------------------- */
+
+/** Writes nanoseconds since the epoch in the Saleae layout (always +00:00).
+ *  out needs room for ISO8601_SALEAE_LENGTH characters plus the terminator.
+ */
+
+void iso8601_format_ns( int64_t ns, char *out );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* ISO8601_H */
@@ -0,0 +1,434 @@
+/* -------------------------------------------------------------------------- */
+
+// Batch version of latency-cleanup for the whole firmware/ tree
+//
+// Walks every folder below the root, pairs the trigger/done edges of each Logic 2
+// export in parallel and tags the results with the transport, payload size and
+// variant implied by the folder and file names.
+//
+// With a cache (-c) only new or changed captures are parsed, and the store,
+// consolidated csv files and charts are only rewritten when one of the
+// captures they're built from changed.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "analysis_cache.h"
+#include "batch_ingest.h"
+#include "content_hash.h"
+#include "latency_columns.h"
+#include "latency_store.h"
+#include "svg_chart.h"
+#include "thread_pool.h"
+
+/* -------------------------------------------------------------------------- */
+
+// Bump when the outputs are written differently, so cached ones get rebuilt
+#define BATCH_OUTPUT_RECIPE "batch-output-1"
+
+/* -------------------------------------------------------------------------- */
+
+typedef std::vector<const batch_capture_t *> capture_set_t;
+
+typedef struct
+{
+    analysis_cache_t *cache;        // null rebuilds everything
+    std::mutex        lock;
+    uint32_t          rebuilt;
+    uint32_t          current;
+    bool              failed;
+} batch_refresh_t;
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool write_store( const char *path, const capture_set_t &captures );
+static bool write_wide_csv( const char *path, const capture_set_t &captures );
+static bool write_charts( const char *path, const std::string &folder, svg_chart_kind_t kind, const capture_set_t &captures );
+static std::string column_name( const batch_capture_t &capture );
+static uint64_t inputs_key( const capture_set_t &captures, const std::string &recipe );
+static void refresh_output( batch_refresh_t *refresh, const std::string &path, uint64_t key, const std::function<bool( void )> &build );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    batch_options_t  options     = { 0, false, 0 };
+    analysis_cache_t cache;
+    const char *     cache_dir   = 0;
+    const char *     store_path  = 0;
+    const char *     csv_path    = 0;
+    const char *     folder_dir  = 0;
+    const char *     chart_dir   = 0;
+    bool             quiet       = false;
+    std::string      root        = ".";
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-j" ) == 0 && i + 1 < argc )
+        {
+            options.worker_count = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            store_path = argv[++i];
+        }
+        else if( strcmp( argv[i], "-w" ) == 0 && i + 1 < argc )
+        {
+            csv_path = argv[++i];
+        }
+        else if( strcmp( argv[i], "-c" ) == 0 && i + 1 < argc )
+        {
+            cache_dir = argv[++i];
+        }
+        else if( strcmp( argv[i], "-F" ) == 0 && i + 1 < argc )
+        {
+            folder_dir = argv[++i];
+        }
+        else if( strcmp( argv[i], "-d" ) == 0 && i + 1 < argc )
+        {
+            chart_dir = argv[++i];
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 )
+        {
+            options.include_sal = true;
+        }
+        else if( strcmp( argv[i], "-q" ) == 0 )
+        {
+            quiet = true;
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            root = argv[i];
+        }
+    }
+
+    if( cache_dir )
+    {
+        if( !analysis_cache_open( &cache, cache_dir ) )
+        {
+            fprintf( stderr, "%s: can't create the cache folder\n", cache_dir );
+            return 1;
+        }
+
+        options.cache = &cache;
+    }
+
+    std::vector<batch_capture_t> captures;
+    batch_stats_t                stats;
+
+    if( !batch_ingest_run( root, options, &captures, &stats ) )
+    {
+        fprintf( stderr, "%s: not a directory\n", root.c_str() );
+        return 1;
+    }
+
+    uint32_t              skipped = 0;
+    edge_pairing_counts_t total   = {};
+
+    for( const batch_capture_t &capture : captures )
+    {
+        if( !capture.ok )
+        {
+            skipped++;
+
+            if( !quiet )
+            {
+                printf( "%-56s skipped: %s\n", capture.path.c_str(), capture.latency.error.c_str() );
+            }
+            continue;
+        }
+
+        const edge_pairing_counts_t &counts = capture.latency.counts;
+
+        total.triggers += counts.triggers;
+        total.lost += counts.lost;
+        total.late += counts.late;
+        total.duplicated += counts.duplicated;
+
+        if( !quiet )
+        {
+            printf( "%-56s %-11s %5u B  %-22s %6zu latencies %4llu lost %4llu late %4llu dup\n",
+                    capture.path.c_str(),
+                    capture.tags.transport.empty() ? "?" : capture.tags.transport.c_str(),
+                    capture.tags.payload_bytes,
+                    capture.tags.build_flags.c_str(),
+                    capture.latency.durations_ms.size(),
+                    (unsigned long long)counts.lost,
+                    (unsigned long long)counts.late,
+                    (unsigned long long)counts.duplicated );
+        }
+    }
+
+    printf( "%llu triggers, %llu lost, %llu late, %llu duplicated\n",
+            (unsigned long long)total.triggers,
+            (unsigned long long)total.lost,
+            (unsigned long long)total.late,
+            (unsigned long long)total.duplicated );
+
+    printf( "%llu captures (%u skipped), %llu rows in %.3f s on %u threads, %.1f Mrows/s, %llu steals\n",
+            (unsigned long long)stats.files,
+            skipped,
+            (unsigned long long)stats.rows,
+            stats.elapsed_s,
+            stats.workers,
+            stats.elapsed_s > 0.0 ? (double)stats.rows / stats.elapsed_s / 1e6 : 0.0,
+            (unsigned long long)stats.steals );
+
+    if( options.cache )
+    {
+        printf( "cache: %llu unchanged, %llu same content, %llu parsed\n",
+                (unsigned long long)cache.hits,
+                (unsigned long long)cache.rehashed,
+                (unsigned long long)cache.parsed );
+    }
+
+    // Every output depends on a known set of captures, grouped by folder for
+    // the consolidated csv files and charts
+    capture_set_t                        all;
+    std::map<std::string, capture_set_t> folders;
+
+    for( const batch_capture_t &capture : captures )
+    {
+        if( capture.ok )
+        {
+            const std::string folder = std::filesystem::path( capture.path ).parent_path().generic_string();
+
+            all.push_back( &capture );
+            folders[folder.empty() ? "root" : folder].push_back( &capture );
+        }
+    }
+
+    batch_refresh_t refresh;
+    refresh.cache   = options.cache;
+    refresh.rebuilt = 0;
+    refresh.current = 0;
+    refresh.failed  = false;
+
+    thread_pool_t pool;
+    thread_pool_start( &pool, options.worker_count );
+
+    if( store_path )
+    {
+        thread_pool_submit( &pool, [&] {
+            refresh_output( &refresh, store_path, inputs_key( all, "store" ), [&] { return write_store( store_path, all ); } );
+        } );
+    }
+
+    if( csv_path )
+    {
+        thread_pool_submit( &pool, [&] {
+            refresh_output( &refresh, csv_path, inputs_key( all, "csv" ), [&] { return write_wide_csv( csv_path, all ); } );
+        } );
+    }
+
+    for( const auto &folder : folders )
+    {
+        // "uart_tests/baudrate-12B-logs" -> "uart_tests-baudrate-12B-logs"
+        std::string flat = folder.first;
+        std::replace( flat.begin(), flat.end(), '/', '-' );
+
+        if( folder_dir )
+        {
+            const std::string path = ( std::filesystem::path( folder_dir ) / ( flat + ".csv" ) ).string();
+
+            thread_pool_submit( &pool, [&, path] {
+                refresh_output( &refresh, path, inputs_key( folder.second, "csv" ), [&] { return write_wide_csv( path.c_str(), folder.second ); } );
+            } );
+        }
+
+        if( chart_dir )
+        {
+            for( svg_chart_kind_t kind : { SVG_CHART_BOX, SVG_CHART_RIDGELINE, SVG_CHART_CDF } )
+            {
+                static const char *kind_names[] = { "box", "ridgeline", "cdf" };
+
+                const std::string path = ( std::filesystem::path( chart_dir ) / ( flat + "-" + kind_names[kind] + ".svg" ) ).string();
+
+                thread_pool_submit( &pool, [&, path, kind] {
+                    refresh_output( &refresh, path, inputs_key( folder.second, kind_names[kind] ), [&] {
+                        return write_charts( path.c_str(), folder.first, kind, folder.second );
+                    } );
+                } );
+            }
+        }
+    }
+
+    thread_pool_stop( &pool );
+
+    if( store_path || csv_path || folder_dir || chart_dir )
+    {
+        printf( "outputs: %u written, %u up to date\n", refresh.rebuilt, refresh.current );
+    }
+
+    if( options.cache && !analysis_cache_save( &cache ) )
+    {
+        fprintf( stderr, "%s: failed to save the cache manifest\n", cache_dir );
+        return 1;
+    }
+
+    return refresh.failed ? 1 : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-j threads] [-s] [-q] [-c cache] [-o all.lstore] [-w all.csv] [-F folder-csvs] [-d charts] [firmware-root]\n", name );
+    printf( "Finds every Logic 2 export below the root (default: working directory) and\n" );
+    printf( "pairs CH0 triggers with CH1 done strobes in parallel.\n" );
+    printf( "  -j  worker threads, defaults to one per hardware thread\n" );
+    printf( "  -s  also decode .sal captures that don't have a csv export\n" );
+    printf( "  -o  write every latency vector to a latency-store file, tagged with\n" );
+    printf( "      transport, payload size and variant flags\n" );
+    printf( "  -w  write a wide csv (one column per capture) for the R scripts\n" );
+    printf( "  -F  write a consolidated csv per capture folder into this folder\n" );
+    printf( "  -d  write box, ridgeline and cdf charts per capture folder into this folder\n" );
+    printf( "  -c  keep results in this cache folder, later runs only parse changed\n" );
+    printf( "      captures and only rewrite outputs whose captures changed\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_store( const char *path, const capture_set_t &captures )
+{
+    std::vector<latency_store_entry_t> entries;
+
+    for( const batch_capture_t *item : captures )
+    {
+        const batch_capture_t &capture = *item;
+
+        latency_store_entry_t entry;
+        entry.column.name          = column_name( capture );
+        entry.column.values        = capture.latency.durations_ms;
+        entry.meta.transport       = capture.tags.transport;
+        entry.meta.build_flags     = capture.tags.build_flags;
+        entry.meta.payload_bytes   = capture.tags.payload_bytes;
+        entry.meta.unit            = "ms";
+        entry.meta.source          = capture.path;
+        entry.meta.type            = LATENCY_STORE_FLOAT64;
+
+        entries.push_back( std::move( entry ) );
+    }
+
+    return latency_store_write( path, entries );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_wide_csv( const char *path, const capture_set_t &captures )
+{
+    std::vector<latency_column_t> columns;
+    std::error_code               ec;
+
+    for( const batch_capture_t *capture : captures )
+    {
+        columns.push_back( { column_name( *capture ), capture->latency.durations_ms } );
+    }
+
+    std::filesystem::create_directories( std::filesystem::path( path ).parent_path(), ec );
+    return latency_columns_write_csv( path, columns );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_charts( const char *path, const std::string &folder, svg_chart_kind_t kind, const capture_set_t &captures )
+{
+    std::vector<svg_chart_series_t> series;
+    svg_chart_options_t             options;
+    std::error_code                 ec;
+
+    for( const batch_capture_t *capture : captures )
+    {
+        series.push_back( { capture->variant, capture->latency.durations_ms } );
+    }
+
+    svg_chart_defaults( &options );
+    options.kind  = kind;
+    options.title = folder;
+
+    std::filesystem::create_directories( std::filesystem::path( path ).parent_path(), ec );
+    return svg_chart_write( path, series, options );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// "esp-tcp/12B-modified.csv" -> "esp-tcp/12B-modified"
+static std::string column_name( const batch_capture_t &capture )
+{
+    const size_t dot = capture.path.find_last_of( '.' );
+
+    return ( dot == std::string::npos ) ? capture.path : capture.path.substr( 0, dot );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Hash of everything an output is built from, 0 if any input has no content
+// hash (no cache), which always rebuilds
+static uint64_t inputs_key( const capture_set_t &captures, const std::string &recipe )
+{
+    uint64_t key = content_hash_string( recipe, content_hash_string( BATCH_OUTPUT_RECIPE, 0 ) );
+
+    for( const batch_capture_t *capture : captures )
+    {
+        if( capture->hash == 0 )
+        {
+            return 0;
+        }
+
+        key = content_hash_combine( key, content_hash_string( column_name( *capture ), 0 ) );
+        key = content_hash_combine( key, capture->hash );
+    }
+
+    return key;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void refresh_output( batch_refresh_t *refresh, const std::string &path, uint64_t key, const std::function<bool( void )> &build )
+{
+    if( refresh->cache && key != 0 && analysis_cache_output_current( refresh->cache, path, key ) )
+    {
+        std::lock_guard<std::mutex> guard( refresh->lock );
+        refresh->current++;
+        return;
+    }
+
+    const bool ok = build();
+
+    if( ok && refresh->cache && key != 0 )
+    {
+        analysis_cache_output_built( refresh->cache, path, key );
+    }
+
+    std::lock_guard<std::mutex> guard( refresh->lock );
+
+    if( ok )
+    {
+        refresh->rebuilt++;
+    }
+    else
+    {
+        fprintf( stderr, "Failed to write %s\n", path.c_str() );
+        refresh->failed = true;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
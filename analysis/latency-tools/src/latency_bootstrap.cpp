@@ -0,0 +1,321 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_bootstrap.h"
+#include "thread_pool.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Replicates per RNG stream. Small enough to balance across workers, large
+// enough that seeding a stream is noise.
+#define BOOTSTRAP_BLOCK_SIZE (64u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+// xoshiro256**, seeded per block through splitmix64
+typedef struct
+{
+    uint64_t s[4];
+} bootstrap_rng_t;
+
+// A sorted sample and the order statistics type 7 needs from each replicate
+typedef struct
+{
+    std::vector<double>   sorted;
+    std::vector<uint64_t> ranks;        // ascending, unique
+    std::vector<uint32_t> low;          // per quantile, index into ranks
+    std::vector<uint32_t> high;
+    std::vector<double>   fraction;
+} bootstrap_sample_t;
+
+// Per worker buffers, allocated once and reused for every replicate
+typedef struct
+{
+    std::vector<uint32_t> counts;
+    std::vector<double>   rank_values;
+    std::vector<double>   quantiles_a;
+    std::vector<double>   quantiles_b;
+} bootstrap_scratch_t;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint64_t bootstrap_splitmix64( uint64_t *state );
+static void bootstrap_rng_seed( bootstrap_rng_t *rng, uint64_t seed, uint64_t stream );
+static uint64_t bootstrap_rng_next( bootstrap_rng_t *rng );
+static uint32_t bootstrap_rng_below( bootstrap_rng_t *rng, uint32_t range );
+
+static void bootstrap_prepare( const std::vector<double> &values, const std::vector<double> &quantiles, bootstrap_sample_t *sample );
+static void bootstrap_replicate( const bootstrap_sample_t *sample, bootstrap_rng_t *rng, bootstrap_scratch_t *scratch, std::vector<double> *quantiles );
+static double bootstrap_type7( const std::vector<double> &sorted, double q );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool latency_bootstrap_quantile_difference( const std::vector<double> &                 a,
+                                            const std::vector<double> &                 b,
+                                            const std::vector<double> &                 quantiles,
+                                            const latency_bootstrap_options_t &         options,
+                                            std::vector<latency_bootstrap_interval_t> * intervals )
+{
+    bootstrap_sample_t sample_a;
+    bootstrap_sample_t sample_b;
+
+    for( double q : quantiles )
+    {
+        if( !( q >= 0.0 && q <= 1.0 ) )
+        {
+            return false;
+        }
+    }
+
+    bootstrap_prepare( a, quantiles, &sample_a );
+    bootstrap_prepare( b, quantiles, &sample_b );
+
+    if( sample_a.sorted.empty() || sample_b.sorted.empty() || quantiles.empty() )
+    {
+        return false;
+    }
+
+    const uint32_t resamples  = options.resamples ? options.resamples : LATENCY_BOOTSTRAP_DEFAULT_RESAMPLES;
+    const double   confidence = ( options.confidence > 0.0 && options.confidence < 1.0 )
+                                    ? options.confidence
+                                    : LATENCY_BOOTSTRAP_DEFAULT_CONFIDENCE;
+    const uint32_t blocks     = ( resamples + BOOTSTRAP_BLOCK_SIZE - 1 ) / BOOTSTRAP_BLOCK_SIZE;
+    const size_t   count      = quantiles.size();
+
+    // Replicate r of quantile i lands in differences[i * resamples + r]
+    std::vector<double>   differences( count * resamples );
+    std::atomic<uint32_t> next_block( 0 );
+
+    thread_pool_t pool;
+    thread_pool_start( &pool, options.worker_count );
+
+    const size_t workers = std::min<size_t>( pool.workers.size(), blocks );
+
+    for( size_t w = 0; w < workers; w++ )
+    {
+        thread_pool_submit( &pool, [&] {
+            bootstrap_scratch_t scratch;
+            bootstrap_rng_t     rng;
+
+            scratch.quantiles_a.resize( count );
+            scratch.quantiles_b.resize( count );
+
+            for( uint32_t block = next_block++; block < blocks; block = next_block++ )
+            {
+                const uint32_t first = block * BOOTSTRAP_BLOCK_SIZE;
+                const uint32_t last  = std::min( first + BOOTSTRAP_BLOCK_SIZE, resamples );
+
+                bootstrap_rng_seed( &rng, options.seed, block );
+
+                for( uint32_t r = first; r < last; r++ )
+                {
+                    bootstrap_replicate( &sample_a, &rng, &scratch, &scratch.quantiles_a );
+                    bootstrap_replicate( &sample_b, &rng, &scratch, &scratch.quantiles_b );
+
+                    for( size_t i = 0; i < count; i++ )
+                    {
+                        differences[i * resamples + r] = scratch.quantiles_b[i] - scratch.quantiles_a[i];
+                    }
+                }
+            }
+        } );
+    }
+
+    thread_pool_stop( &pool );
+
+    intervals->clear();
+
+    const double tail = ( 1.0 - confidence ) / 2.0;
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        std::vector<double> replicates( differences.begin() + i * resamples,
+                                        differences.begin() + ( i + 1 ) * resamples );
+        std::sort( replicates.begin(), replicates.end() );
+
+        latency_bootstrap_interval_t interval;
+
+        interval.q          = quantiles[i];
+        interval.a          = bootstrap_type7( sample_a.sorted, quantiles[i] );
+        interval.b          = bootstrap_type7( sample_b.sorted, quantiles[i] );
+        interval.difference = interval.b - interval.a;
+        interval.lower      = bootstrap_type7( replicates, tail );
+        interval.upper      = bootstrap_type7( replicates, 1.0 - tail );
+
+        const auto positive = std::upper_bound( replicates.begin(), replicates.end(), 0.0 );
+        interval.p_greater  = (double)( replicates.end() - positive ) / (double)resamples;
+
+        intervals->push_back( interval );
+    }
+
+    return true;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static uint64_t bootstrap_splitmix64( uint64_t *state )
+{
+    uint64_t z = ( *state += 0x9E3779B97F4A7C15ull );
+    z          = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z          = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+    return z ^ ( z >> 31 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void bootstrap_rng_seed( bootstrap_rng_t *rng, uint64_t seed, uint64_t stream )
+{
+    uint64_t state = seed ^ ( stream * 0xD1B54A32D192ED03ull );
+
+    for( int i = 0; i < 4; i++ )
+    {
+        rng->s[i] = bootstrap_splitmix64( &state );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t bootstrap_rng_next( bootstrap_rng_t *rng )
+{
+    uint64_t *      s      = rng->s;
+    const uint64_t  x      = s[1] * 5;
+    const uint64_t  result = ( ( x << 7 ) | ( x >> 57 ) ) * 9;
+    const uint64_t  t      = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = ( s[3] << 45 ) | ( s[3] >> 19 );
+
+    return result;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Lemire's multiply and shift, rejecting the few values that would bias the result
+static uint32_t bootstrap_rng_below( bootstrap_rng_t *rng, uint32_t range )
+{
+    uint64_t product = ( bootstrap_rng_next( rng ) >> 32 ) * range;
+    uint32_t low     = (uint32_t)product;
+
+    if( low < range )
+    {
+        const uint32_t threshold = (uint32_t)( -range ) % range;
+
+        while( low < threshold )
+        {
+            product = ( bootstrap_rng_next( rng ) >> 32 ) * range;
+            low     = (uint32_t)product;
+        }
+    }
+
+    return (uint32_t)( product >> 32 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void bootstrap_prepare( const std::vector<double> &values, const std::vector<double> &quantiles, bootstrap_sample_t *sample )
+{
+    for( double value : values )
+    {
+        if( !isnan( value ) )
+        {
+            sample->sorted.push_back( value );
+        }
+    }
+
+    std::sort( sample->sorted.begin(), sample->sorted.end() );
+
+    const uint64_t n = sample->sorted.size();
+
+    if( n == 0 )
+    {
+        return;
+    }
+
+    for( double q : quantiles )
+    {
+        const double   h     = (double)( n - 1 ) * q;
+        const uint64_t below = (uint64_t)floor( h );
+
+        sample->ranks.push_back( below );
+        sample->ranks.push_back( std::min( below + 1, n - 1 ) );
+    }
+
+    std::sort( sample->ranks.begin(), sample->ranks.end() );
+    sample->ranks.erase( std::unique( sample->ranks.begin(), sample->ranks.end() ), sample->ranks.end() );
+
+    for( double q : quantiles )
+    {
+        const double   h     = (double)( n - 1 ) * q;
+        const uint64_t below = (uint64_t)floor( h );
+        const uint64_t above = std::min( below + 1, n - 1 );
+
+        sample->low.push_back( (uint32_t)( std::lower_bound( sample->ranks.begin(), sample->ranks.end(), below ) - sample->ranks.begin() ) );
+        sample->high.push_back( (uint32_t)( std::lower_bound( sample->ranks.begin(), sample->ranks.end(), above ) - sample->ranks.begin() ) );
+        sample->fraction.push_back( h - (double)below );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+// The source sample is sorted, so a resample is fully described by how many
+// times each index was drawn. Walking those counts finds any order statistic
+// in O(n) without sorting the replicate.
+static void bootstrap_replicate( const bootstrap_sample_t *sample, bootstrap_rng_t *rng, bootstrap_scratch_t *scratch, std::vector<double> *quantiles )
+{
+    const uint32_t n = (uint32_t)sample->sorted.size();
+
+    scratch->counts.assign( n, 0 );
+    scratch->rank_values.resize( sample->ranks.size() );
+
+    for( uint32_t i = 0; i < n; i++ )
+    {
+        scratch->counts[bootstrap_rng_below( rng, n )]++;
+    }
+
+    uint64_t cumulative = 0;
+    size_t   next       = 0;
+
+    for( uint32_t j = 0; j < n && next < sample->ranks.size(); j++ )
+    {
+        cumulative += scratch->counts[j];
+
+        while( next < sample->ranks.size() && sample->ranks[next] < cumulative )
+        {
+            scratch->rank_values[next++] = sample->sorted[j];
+        }
+    }
+
+    for( size_t i = 0; i < sample->fraction.size(); i++ )
+    {
+        const double low  = scratch->rank_values[sample->low[i]];
+        const double high = scratch->rank_values[sample->high[i]];
+
+        ( *quantiles )[i] = low + sample->fraction[i] * ( high - low );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double bootstrap_type7( const std::vector<double> &sorted, double q )
+{
+    const double h     = (double)( sorted.size() - 1 ) * q;
+    const size_t below = (size_t)floor( h );
+
+    if( below + 1 >= sorted.size() )
+    {
+        return sorted[below];
+    }
+
+    return sorted[below] + ( h - (double)below ) * ( sorted[below + 1] - sorted[below] );
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,52 @@
+#ifndef LATENCY_BOOTSTRAP_H
+#define LATENCY_BOOTSTRAP_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <vector>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define LATENCY_BOOTSTRAP_DEFAULT_RESAMPLES  (20000u)
+#define LATENCY_BOOTSTRAP_DEFAULT_CONFIDENCE (0.95)
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    uint32_t resamples;         // bootstrap replicates, 0 = default
+    uint32_t worker_count;      // 0 = one per hardware thread
+    uint64_t seed;
+    double   confidence;        // two sided, e.g. 0.95
+} latency_bootstrap_options_t;
+
+// Difference b - a of one quantile, with a percentile bootstrap interval
+typedef struct
+{
+    double q;
+    double a;                   // observed quantile of each sample
+    double b;
+    double difference;
+    double lower;
+    double upper;
+    double p_greater;           // fraction of replicates where b > a
+} latency_bootstrap_interval_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Resamples a and b with replacement and returns a confidence interval for
+ *  quantile(b) - quantile(a) at each of quantiles (R type 7). NaN values are
+ *  ignored. Replicates are generated in fixed blocks with their own RNG
+ *  stream, so results only depend on the seed and not on the thread count.
+ */
+
+bool latency_bootstrap_quantile_difference( const std::vector<double> &                 a,
+                                            const std::vector<double> &                 b,
+                                            const std::vector<double> &                 quantiles,
+                                            const latency_bootstrap_options_t &         options,
+                                            std::vector<latency_bootstrap_interval_t> * intervals );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LATENCY_BOOTSTRAP_H */
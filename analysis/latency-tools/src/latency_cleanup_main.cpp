@@ -0,0 +1,169 @@
+/* -------------------------------------------------------------------------- */
+
+// Native version of analysis/saleae-latency-log-cleanup.R
+//
+// Streams each Saleae Logic 2 csv export once, pairs the trigger (CH0) with the
+// following 'done' strobe (CH1) and writes a column of durations per file.
+// Raw .sal captures are decoded directly, skipping the export step.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "capture_latency.h"
+#include "latency_columns.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define DEFAULT_OUTPUT_NAME "consolidated_df.csv"
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool process_file( const std::string &path, latency_column_t *column );
+static std::string column_name( const std::string &path );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    std::string              output = DEFAULT_OUTPUT_NAME;
+    const char *             scan   = ".csv";
+    std::vector<std::string> inputs;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 )
+        {
+            scan = ".sal";
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    // Like the R script, default to every csv (or capture) in the working directory
+    if( inputs.empty() )
+    {
+        std::error_code ec;
+        for( const auto &entry : std::filesystem::directory_iterator( ".", ec ) )
+        {
+            const std::string name = entry.path().filename().string();
+
+            if( entry.is_regular_file()
+                && capture_latency_has_extension( name, scan )
+                && name != std::filesystem::path( output ).filename().string() )
+            {
+                inputs.push_back( name );
+            }
+        }
+
+        std::sort( inputs.begin(), inputs.end() );
+    }
+
+    std::vector<latency_column_t> columns;
+
+    for( const std::string &path : inputs )
+    {
+        printf( "Processing file: %s\n", path.c_str() );
+
+        latency_column_t column;
+        if( !process_file( path, &column ) )
+        {
+            return 1;
+        }
+
+        columns.push_back( std::move( column ) );
+    }
+
+    if( !latency_columns_write_csv( output.c_str(), columns ) )
+    {
+        fprintf( stderr, "Failed to write %s\n", output.c_str() );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-o %s] [-s] [export.csv | capture.sal ...]\n", name, DEFAULT_OUTPUT_NAME );
+    printf( "Pairs CH0 trigger edges with CH1 done edges and writes one column of\n" );
+    printf( "durations (ms) per input file. Without inputs, every .csv in the working\n" );
+    printf( "directory is processed, or every .sal capture with -s. Triggers that were\n" );
+    printf( "lost, completed late (after the next trigger) or completed twice are counted\n" );
+    printf( "for each file, late completions are kept in the durations.\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool process_file( const std::string &path, latency_column_t *column )
+{
+    capture_latency_t result;
+
+    if( !capture_latency_read( path, &result ) )
+    {
+        fprintf( stderr, "%s: %s\n", path.c_str(), result.error.c_str() );
+        return false;
+    }
+
+    const edge_pairing_counts_t &counts = result.counts;
+
+    printf( "  %llu triggers: %llu paired, %llu lost, %llu late, %llu duplicated",
+            (unsigned long long)counts.triggers,
+            (unsigned long long)counts.paired,
+            (unsigned long long)counts.lost,
+            (unsigned long long)counts.late,
+            (unsigned long long)counts.duplicated );
+
+    if( counts.glitches )
+    {
+        printf( ", %llu trigger glitches merged", (unsigned long long)counts.glitches );
+    }
+
+    if( counts.orphaned )
+    {
+        printf( ", %llu done edges before the first trigger", (unsigned long long)counts.orphaned );
+    }
+
+    printf( "\n" );
+
+    column->name   = column_name( path );
+    column->values = std::move( result.durations_ms );
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static std::string column_name( const std::string &path )
+{
+    std::string name = std::filesystem::path( path ).filename().string();
+
+    if( capture_latency_has_extension( name, ".csv" ) || capture_latency_has_extension( name, ".sal" ) )
+    {
+        name.resize( name.size() - 4 );
+    }
+
+    return name;
+}
+
+/* -------------------------------------------------------------------------- */
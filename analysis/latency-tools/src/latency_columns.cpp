@@ -0,0 +1,231 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool latency_columns_read_file( const char *path, std::string *text );
+static bool latency_columns_next_line( const std::string &text, size_t *pos, const char **line, size_t *len );
+static std::string latency_columns_unquote( const char *cell, size_t len );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool latency_columns_write_csv( const char *path, const std::vector<latency_column_t> &columns )
+{
+    FILE *f = fopen( path, "wb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    size_t rows = 0;
+
+    for( size_t c = 0; c < columns.size(); c++ )
+    {
+        fprintf( f, "%s\"%s\"", c ? "," : "", columns[c].name.c_str() );
+
+        if( columns[c].values.size() > rows )
+        {
+            rows = columns[c].values.size();
+        }
+    }
+    fputc( '\n', f );
+
+    for( size_t r = 0; r < rows; r++ )
+    {
+        for( size_t c = 0; c < columns.size(); c++ )
+        {
+            if( c )
+            {
+                fputc( ',', f );
+            }
+
+            // R prints 15 significant digits by default
+            if( r < columns[c].values.size() && !isnan( columns[c].values[r] ) )
+            {
+                fprintf( f, "%.15g", columns[c].values[r] );
+            }
+            else
+            {
+                fputs( "NA", f );
+            }
+        }
+        fputc( '\n', f );
+    }
+
+    return fclose( f ) == 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool latency_columns_read_csv( const char *path, std::vector<latency_column_t> *columns )
+{
+    std::string text;
+    size_t      pos  = 0;
+    const char *line = 0;
+    size_t      len  = 0;
+
+    columns->clear();
+
+    if( !latency_columns_read_file( path, &text ) || !latency_columns_next_line( text, &pos, &line, &len ) )
+    {
+        return false;
+    }
+
+    // Header, names may or may not be quoted depending on what wrote the file
+    size_t start = 0;
+
+    for( size_t i = 0; i <= len; i++ )
+    {
+        if( i == len || line[i] == ',' )
+        {
+            latency_column_t column;
+            column.name = latency_columns_unquote( line + start, i - start );
+            columns->push_back( std::move( column ) );
+            start = i + 1;
+        }
+    }
+
+    while( latency_columns_next_line( text, &pos, &line, &len ) )
+    {
+        if( len == 0 )
+        {
+            continue;
+        }
+
+        size_t column = 0;
+        start         = 0;
+
+        for( size_t i = 0; i <= len; i++ )
+        {
+            if( i != len && line[i] != ',' )
+            {
+                continue;
+            }
+
+            if( column >= columns->size() )
+            {
+                return false;
+            }
+
+            const char *cell   = line + start;
+            size_t      length = i - start;
+            double      value  = NAN;
+
+            if( length > 0 && !( length == 2 && cell[0] == 'N' && cell[1] == 'A' ) )
+            {
+                char  number[64];
+                char *end = 0;
+
+                if( length >= sizeof( number ) )
+                {
+                    return false;
+                }
+
+                memcpy( number, cell, length );
+                number[length] = '\0';
+                value          = strtod( number, &end );
+
+                if( end != number + length )
+                {
+                    return false;
+                }
+            }
+
+            ( *columns )[column].values.push_back( value );
+            column++;
+            start = i + 1;
+        }
+
+        // Short rows are treated as NA for the missing columns
+        for( ; column < columns->size(); column++ )
+        {
+            ( *columns )[column].values.push_back( NAN );
+        }
+    }
+
+    for( latency_column_t &column : *columns )
+    {
+        while( !column.values.empty() && isnan( column.values.back() ) )
+        {
+            column.values.pop_back();
+        }
+    }
+
+    return true;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static bool latency_columns_read_file( const char *path, std::string *text )
+{
+    FILE *f = fopen( path, "rb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    char   chunk[65536];
+    size_t n = 0;
+
+    while( ( n = fread( chunk, 1, sizeof( chunk ), f ) ) > 0 )
+    {
+        text->append( chunk, n );
+    }
+
+    const bool ok = !ferror( f );
+    fclose( f );
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool latency_columns_next_line( const std::string &text, size_t *pos, const char **line, size_t *len )
+{
+    if( *pos >= text.size() )
+    {
+        return false;
+    }
+
+    size_t end = text.find( '\n', *pos );
+
+    if( end == std::string::npos )
+    {
+        end = text.size();
+    }
+
+    *line = text.data() + *pos;
+    *len  = end - *pos;
+    *pos  = end + 1;
+
+    if( *len > 0 && ( *line )[*len - 1] == '\r' )
+    {
+        ( *len )--;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static std::string latency_columns_unquote( const char *cell, size_t len )
+{
+    if( len >= 2 && cell[0] == '"' && cell[len - 1] == '"' )
+    {
+        return std::string( cell + 1, len - 2 );
+    }
+
+    return std::string( cell, len );
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,36 @@
+#ifndef LATENCY_COLUMNS_H
+#define LATENCY_COLUMNS_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <string>
+#include <vector>
+
+/* ----- Types -------------------------------------------------------------- */
+
+// One column of the "wide" latency csv files used by the R charts
+typedef struct
+{
+    std::string         name;
+    std::vector<double> values;     // milliseconds, NaN for NA
+} latency_column_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Writes columns in the same layout as R's write.csv( df, row.names = FALSE ),
+ *  i.e. quoted header names and NA padding for shorter columns.
+ */
+
+bool latency_columns_write_csv( const char *path, const std::vector<latency_column_t> &columns );
+
+/* -------------------------------------------------------------------------- */
+
+/** Reads a wide csv (quoted or bare header names). Empty and NA cells inside a
+ *  column become NaN, trailing padding is dropped so each column keeps its own length.
+ */
+
+bool latency_columns_read_csv( const char *path, std::vector<latency_column_t> *columns );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LATENCY_COLUMNS_H */
@@ -0,0 +1,328 @@
+/* -------------------------------------------------------------------------- */
+
+// Is variant b really faster than variant a?
+//
+// Bootstraps confidence intervals for the difference in median/tail latency
+// between two columns, e.g. esp32-nimble-override-connparams.csv against
+// esp32-nimble-hci-fix.csv. Without an explicit :column every column name the
+// two files share is compared.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "capture_latency.h"
+#include "latency_bootstrap.h"
+#include "latency_columns.h"
+#include "latency_store.h"
+
+/* -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    std::string                               column;
+    std::vector<latency_bootstrap_interval_t> intervals;
+} compare_result_t;
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool load_columns( const std::string &spec, std::vector<latency_column_t> *columns, std::string *selected );
+static bool parse_quantiles( const char *text, std::vector<double> *quantiles );
+static bool write_results( FILE *f, const std::vector<compare_result_t> &results );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    latency_bootstrap_options_t options   = { 0, 0, 1, 0.0 };
+    std::vector<double>         quantiles = { 0.5, 0.9, 0.99 };
+    const char *                output    = 0;
+    std::vector<std::string>    inputs;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-n" ) == 0 && i + 1 < argc )
+        {
+            options.resamples = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-j" ) == 0 && i + 1 < argc )
+        {
+            options.worker_count = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-c" ) == 0 && i + 1 < argc )
+        {
+            options.confidence = strtod( argv[++i], 0 );
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+        {
+            options.seed = strtoull( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-q" ) == 0 && i + 1 < argc )
+        {
+            if( !parse_quantiles( argv[++i], &quantiles ) )
+            {
+                fprintf( stderr, "Quantiles must be a comma separated list between 0 and 1\n" );
+                return 1;
+            }
+        }
+        else if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    if( inputs.size() != 2 )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    std::vector<latency_column_t> columns_a;
+    std::vector<latency_column_t> columns_b;
+    std::string                   selected_a;
+    std::string                   selected_b;
+
+    if( !load_columns( inputs[0], &columns_a, &selected_a ) || !load_columns( inputs[1], &columns_b, &selected_b ) )
+    {
+        return 1;
+    }
+
+    // Explicit columns compare one pair, otherwise match on name
+    std::vector<std::pair<const latency_column_t *, const latency_column_t *>> pairs;
+
+    for( const latency_column_t &a : columns_a )
+    {
+        for( const latency_column_t &b : columns_b )
+        {
+            const bool explicit_pair = !selected_a.empty() || !selected_b.empty();
+
+            if( ( explicit_pair && ( selected_a.empty() || a.name == selected_a ) && ( selected_b.empty() || b.name == selected_b ) )
+                || ( !explicit_pair && a.name == b.name ) )
+            {
+                pairs.push_back( { &a, &b } );
+            }
+        }
+    }
+
+    if( pairs.empty() )
+    {
+        fprintf( stderr, "No matching columns, use file.csv:column to pick them\n" );
+        return 1;
+    }
+
+    std::vector<compare_result_t> results;
+    const auto                    started = std::chrono::steady_clock::now();
+
+    for( const auto &pair : pairs )
+    {
+        compare_result_t result;
+        result.column = ( pair.first->name == pair.second->name ) ? pair.first->name
+                                                                  : pair.first->name + " vs " + pair.second->name;
+
+        if( !latency_bootstrap_quantile_difference( pair.first->values, pair.second->values, quantiles, options, &result.intervals ) )
+        {
+            fprintf( stderr, "%s: not enough samples\n", result.column.c_str() );
+            continue;
+        }
+
+        results.push_back( std::move( result ) );
+    }
+
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - started ).count();
+
+    printf( "%-16s %7s %12s %12s %12s %25s %8s\n", "column", "q", "a", "b", "b - a", "interval", "P(b>a)" );
+
+    for( const compare_result_t &result : results )
+    {
+        for( const latency_bootstrap_interval_t &interval : result.intervals )
+        {
+            const bool excludes_zero = interval.lower > 0.0 || interval.upper < 0.0;
+
+            printf( "%-16s %7g %12.6g %12.6g %12.6g  [%10.5g, %10.5g] %8.4f %s\n",
+                    result.column.c_str(),
+                    interval.q,
+                    interval.a,
+                    interval.b,
+                    interval.difference,
+                    interval.lower,
+                    interval.upper,
+                    interval.p_greater,
+                    excludes_zero ? "*" : "" );
+        }
+    }
+
+    printf( "\n%zu comparisons, %u resamples each in %.1f ms (* = interval excludes zero)\n",
+            results.size(),
+            options.resamples ? options.resamples : LATENCY_BOOTSTRAP_DEFAULT_RESAMPLES,
+            elapsed * 1000.0 );
+
+    if( output )
+    {
+        FILE *f = fopen( output, "wb" );
+
+        if( !f || !write_results( f, results ) || fclose( f ) != 0 )
+        {
+            fprintf( stderr, "Failed to write %s\n", output );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-n resamples] [-j threads] [-c confidence] [-s seed] [-q 0.5,0.9,0.99] [-o out.csv]\n", name );
+    printf( "          a.csv[:column] b.csv[:column]\n" );
+    printf( "Bootstrap confidence intervals for quantile(b) - quantile(a). Inputs can be wide\n" );
+    printf( "csv files or latency-store files. Defaults: %u resamples, %g confidence.\n",
+            LATENCY_BOOTSTRAP_DEFAULT_RESAMPLES,
+            LATENCY_BOOTSTRAP_DEFAULT_CONFIDENCE );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// "file.csv:1024B" selects one column, the suffix is only taken as a column when
+// the whole argument isn't an existing file
+static bool load_columns( const std::string &spec, std::vector<latency_column_t> *columns, std::string *selected )
+{
+    std::string  path  = spec;
+    const size_t colon = spec.rfind( ':' );
+    FILE *       probe = fopen( spec.c_str(), "rb" );
+
+    if( probe )
+    {
+        fclose( probe );
+    }
+    else if( colon != std::string::npos )
+    {
+        path      = spec.substr( 0, colon );
+        *selected = spec.substr( colon + 1 );
+    }
+
+    if( capture_latency_has_extension( path, ".lstore" ) )
+    {
+        latency_store_t store;
+
+        if( !latency_store_open( &store, path.c_str() ) )
+        {
+            fprintf( stderr, "%s: not a latency store\n", path.c_str() );
+            return false;
+        }
+
+        for( uint32_t c = 0; c < latency_store_column_count( &store ); c++ )
+        {
+            latency_store_column_t view;
+            latency_store_column( &store, c, &view );
+
+            latency_column_t column;
+            column.name = view.name;
+            column.values.reserve( view.count );
+
+            for( uint64_t v = 0; v < view.count; v++ )
+            {
+                column.values.push_back( latency_store_value( &view, v ) );
+            }
+
+            columns->push_back( std::move( column ) );
+        }
+
+        latency_store_close( &store );
+    }
+    else if( !latency_columns_read_csv( path.c_str(), columns ) )
+    {
+        fprintf( stderr, "%s: not a readable wide latency csv\n", path.c_str() );
+        return false;
+    }
+
+    if( !selected->empty() )
+    {
+        for( const latency_column_t &column : *columns )
+        {
+            if( column.name == *selected )
+            {
+                return true;
+            }
+        }
+
+        fprintf( stderr, "%s: no column named %s\n", path.c_str(), selected->c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool parse_quantiles( const char *text, std::vector<double> *quantiles )
+{
+    quantiles->clear();
+
+    while( *text )
+    {
+        char *       end = 0;
+        const double q   = strtod( text, &end );
+
+        if( end == text || !( q >= 0.0 && q <= 1.0 ) )
+        {
+            return false;
+        }
+
+        quantiles->push_back( q );
+        text = ( *end == ',' ) ? end + 1 : end;
+
+        if( *end != ',' && *end != '\0' )
+        {
+            return false;
+        }
+    }
+
+    return !quantiles->empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_results( FILE *f, const std::vector<compare_result_t> &results )
+{
+    fputs( "\"column\",\"quantile\",\"a\",\"b\",\"difference\",\"lower\",\"upper\",\"p_greater\"\n", f );
+
+    for( const compare_result_t &result : results )
+    {
+        for( const latency_bootstrap_interval_t &interval : result.intervals )
+        {
+            fprintf( f,
+                     "\"%s\",%g,%.7g,%.7g,%.7g,%.7g,%.7g,%.6g\n",
+                     result.column.c_str(),
+                     interval.q,
+                     interval.a,
+                     interval.b,
+                     interval.difference,
+                     interval.lower,
+                     interval.upper,
+                     interval.p_greater );
+        }
+    }
+
+    return !ferror( f );
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,143 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <algorithm>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_kde.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define KDE_KERNEL_CUTOFF     (4.0)         // bandwidths, the tail past this is < 0.01%
+#define KDE_MAX_KERNEL_POINTS (16384)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static double kde_type7( const std::vector<double> &sorted, double q );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+double latency_kde_bandwidth( const std::vector<double> &sorted )
+{
+    const size_t n = sorted.size();
+
+    if( n < 2 )
+    {
+        return 1.0;
+    }
+
+    double sum = 0.0;
+
+    for( double value : sorted )
+    {
+        sum += value;
+    }
+
+    const double mean    = sum / (double)n;
+    double       squares = 0.0;
+
+    for( double value : sorted )
+    {
+        squares += ( value - mean ) * ( value - mean );
+    }
+
+    const double sd  = sqrt( squares / (double)( n - 1 ) );
+    const double iqr = ( kde_type7( sorted, 0.75 ) - kde_type7( sorted, 0.25 ) ) / 1.34;
+
+    // bw.nrd0 falls back through sd, |x[1]| and 1 for degenerate samples
+    double spread = std::min( sd, iqr );
+    spread        = ( spread > 0.0 ) ? spread : ( sd > 0.0 ) ? sd : ( sorted[0] != 0.0 ) ? fabs( sorted[0] ) : 1.0;
+
+    return 0.9 * spread * pow( (double)n, -0.2 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool latency_kde_estimate( const std::vector<double> &sorted,
+                           double                     adjust,
+                           double                     x_min,
+                           double                     x_max,
+                           uint32_t                   grid,
+                           latency_kde_t *            kde )
+{
+    if( sorted.empty() || !( x_max > x_min ) || grid < 2 )
+    {
+        return false;
+    }
+
+    const double bandwidth = latency_kde_bandwidth( sorted ) * ( ( adjust > 0.0 ) ? adjust : 1.0 );
+    const double delta     = ( x_max - x_min ) / (double)( grid - 1 );
+    const int    half      = (int)std::min<double>( ceil( KDE_KERNEL_CUTOFF * bandwidth / delta ), KDE_MAX_KERNEL_POINTS );
+
+    // Bin onto a grid padded by the kernel width so samples just outside the
+    // plotted range still contribute to the edges
+    const int           padded = (int)grid + 2 * half;
+    std::vector<double> bins( padded, 0.0 );
+
+    for( double value : sorted )
+    {
+        const double position = ( value - x_min ) / delta + half;
+
+        if( position < 0.0 || position > (double)( padded - 1 ) )
+        {
+            continue;
+        }
+
+        const int    low    = std::min( (int)position, padded - 2 );
+        const double weight = position - low;
+
+        bins[low] += 1.0 - weight;
+        bins[low + 1] += weight;
+    }
+
+    // Normalise the discrete kernel so each sample contributes unit area
+    std::vector<double> kernel( 2 * half + 1 );
+    double              kernel_sum = 0.0;
+
+    for( int k = -half; k <= half; k++ )
+    {
+        const double z     = k * delta / bandwidth;
+        kernel[k + half]   = exp( -0.5 * z * z );
+        kernel_sum        += kernel[k + half];
+    }
+
+    const double scale = 1.0 / ( kernel_sum * delta * (double)sorted.size() );
+
+    kde->bandwidth = bandwidth;
+    kde->x_min     = x_min;
+    kde->x_max     = x_max;
+    kde->density.assign( grid, 0.0 );
+
+    for( uint32_t i = 0; i < grid; i++ )
+    {
+        const int centre = (int)i + half;
+        double    sum    = 0.0;
+
+        for( int k = -half; k <= half; k++ )
+        {
+            sum += bins[centre + k] * kernel[k + half];
+        }
+
+        kde->density[i] = sum * scale;
+    }
+
+    return true;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static double kde_type7( const std::vector<double> &sorted, double q )
+{
+    const double h     = (double)( sorted.size() - 1 ) * q;
+    const size_t below = (size_t)floor( h );
+
+    if( below + 1 >= sorted.size() )
+    {
+        return sorted[below];
+    }
+
+    return sorted[below] + ( h - (double)below ) * ( sorted[below + 1] - sorted[below] );
+}
+
+/* ----- End ---------------------------------------------------------------- */
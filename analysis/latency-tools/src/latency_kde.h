@@ -0,0 +1,49 @@
+#ifndef LATENCY_KDE_H
+#define LATENCY_KDE_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <vector>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define LATENCY_KDE_DEFAULT_GRID (512u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Gaussian density evaluated on an evenly spaced grid from x_min to x_max
+typedef struct
+{
+    double              bandwidth;
+    double              x_min;
+    double              x_max;
+    std::vector<double> density;
+} latency_kde_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Silverman's rule of thumb, the same as R's bw.nrd0() that density(),
+ *  ggridges and ggdist default to. values must be sorted.
+ */
+
+double latency_kde_bandwidth( const std::vector<double> &sorted );
+
+/* -------------------------------------------------------------------------- */
+
+/** Binned kernel density estimate: samples are linearly binned onto the grid
+ *  and convolved with a Gaussian truncated at 4 bandwidths, O(grid x kernel)
+ *  instead of O(samples x grid). adjust scales the automatic bandwidth like
+ *  ggplot's adjust argument. values must be sorted, NaN free.
+ */
+
+bool latency_kde_estimate( const std::vector<double> &sorted,
+                           double                     adjust,
+                           double                     x_min,
+                           double                     x_max,
+                           uint32_t                   grid,
+                           latency_kde_t *            kde );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LATENCY_KDE_H */
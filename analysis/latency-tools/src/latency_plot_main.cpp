@@ -0,0 +1,434 @@
+/* -------------------------------------------------------------------------- */
+
+// Native replacement for ridgeline.R, cdf.R and uart-overhead-facet-ridgelines.R
+//
+// Renders box/half-eye, ridgeline and CDF charts straight from a latency store
+// or the wide csv files, with the density bandwidth and x axis bounds picked
+// from the data. With -d every source file in the inputs gets its own charts,
+// rendered in parallel, which is what CI uses to regenerate everything.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "capture_latency.h"
+#include "latency_columns.h"
+#include "latency_store.h"
+#include "svg_chart.h"
+#include "thread_pool.h"
+
+/* -------------------------------------------------------------------------- */
+
+// Columns grouped by the file they originally came from
+typedef struct
+{
+    std::string                     source;
+    std::string                     unit;
+    std::vector<svg_chart_series_t> series;
+} plot_source_t;
+
+typedef struct
+{
+    std::vector<std::string> columns;       // -c filter, empty = all
+    std::string              packetsize;    // -p filter, empty = all
+    std::string              unit;          // -u override
+} plot_filter_t;
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool load_sources( const std::string &path, const plot_filter_t &filter, std::vector<plot_source_t> *sources );
+static bool keep_column( const plot_filter_t &filter, const std::string &name );
+static void add_series( std::vector<plot_source_t> *sources, const std::string &source, const std::string &unit, svg_chart_series_t series );
+static bool parse_kinds( const char *text, std::vector<svg_chart_kind_t> *kinds );
+static const char *kind_name( svg_chart_kind_t kind );
+static std::vector<std::string> split_list( const char *text );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    svg_chart_options_t           options;
+    std::vector<svg_chart_kind_t> kinds   = { SVG_CHART_BOX };
+    plot_filter_t                 filter;
+    const char *                  output  = 0;
+    const char *                  folder  = 0;
+    bool                          titled  = false;
+    uint32_t                      workers = 0;
+    std::vector<std::string>      inputs;
+
+    svg_chart_defaults( &options );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-k" ) == 0 && i + 1 < argc )
+        {
+            if( !parse_kinds( argv[++i], &kinds ) )
+            {
+                fprintf( stderr, "Chart kinds are box, ridgeline, cdf or all\n" );
+                return 1;
+            }
+        }
+        else if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-d" ) == 0 && i + 1 < argc )
+        {
+            folder = argv[++i];
+        }
+        else if( strcmp( argv[i], "-t" ) == 0 && i + 1 < argc )
+        {
+            options.title = argv[++i];
+            titled        = true;
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+        {
+            options.subtitle = argv[++i];
+        }
+        else if( strcmp( argv[i], "-x" ) == 0 && i + 1 < argc )
+        {
+            // "0,195", either side can be left empty for automatic
+            const char *bounds = argv[++i];
+            const char *comma  = strchr( bounds, ',' );
+
+            options.x_min = ( bounds[0] && bounds[0] != ',' ) ? strtod( bounds, 0 ) : NAN;
+            options.x_max = ( comma && comma[1] ) ? strtod( comma + 1, 0 ) : NAN;
+        }
+        else if( strcmp( argv[i], "-a" ) == 0 && i + 1 < argc )
+        {
+            options.adjust = strtod( argv[++i], 0 );
+        }
+        else if( strcmp( argv[i], "-w" ) == 0 && i + 1 < argc )
+        {
+            options.width = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-c" ) == 0 && i + 1 < argc )
+        {
+            filter.columns = split_list( argv[++i] );
+        }
+        else if( strcmp( argv[i], "-p" ) == 0 && i + 1 < argc )
+        {
+            filter.packetsize = argv[++i];
+        }
+        else if( strcmp( argv[i], "-u" ) == 0 && i + 1 < argc )
+        {
+            filter.unit = argv[++i];
+        }
+        else if( strcmp( argv[i], "-j" ) == 0 && i + 1 < argc )
+        {
+            workers = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    if( inputs.empty() || ( !output && !folder ) || ( output && kinds.size() != 1 ) )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    std::vector<plot_source_t> sources;
+
+    for( const std::string &path : inputs )
+    {
+        if( !load_sources( path, filter, &sources ) )
+        {
+            return 1;
+        }
+    }
+
+    if( sources.empty() )
+    {
+        fprintf( stderr, "No columns matched\n" );
+        return 1;
+    }
+
+    // One chart from everything that was loaded
+    if( output )
+    {
+        plot_source_t combined = { "", sources[0].unit, {} };
+
+        for( const plot_source_t &source : sources )
+        {
+            combined.series.insert( combined.series.end(), source.series.begin(), source.series.end() );
+        }
+
+        options.kind    = kinds[0];
+        options.x_label = ( combined.unit == "ns" ) ? "Duration (nanoseconds)" : "Duration (milliseconds)";
+
+        if( !svg_chart_write( output, combined.series, options ) )
+        {
+            fprintf( stderr, "Failed to render %s\n", output );
+            return 1;
+        }
+
+        return 0;
+    }
+
+    // A chart per source and kind, rendered in parallel
+    std::error_code ec;
+    std::filesystem::create_directories( folder, ec );
+
+    thread_pool_t pool;
+    std::mutex    lock;
+    uint32_t      written = 0;
+    bool          failed  = false;
+
+    thread_pool_start( &pool, workers );
+
+    for( const plot_source_t &source : sources )
+    {
+        for( svg_chart_kind_t kind : kinds )
+        {
+            thread_pool_submit( &pool, [&, kind] {
+                svg_chart_options_t chart = options;
+
+                const std::string stem = std::filesystem::path( source.source ).stem().string();
+                const std::string path = ( std::filesystem::path( folder ) / ( stem + "-" + kind_name( kind ) + ".svg" ) ).string();
+
+                chart.kind    = kind;
+                chart.title   = titled ? options.title : stem;
+                chart.x_label = ( source.unit == "ns" ) ? "Duration (nanoseconds)" : "Duration (milliseconds)";
+
+                const bool ok = svg_chart_write( path.c_str(), source.series, chart );
+
+                std::lock_guard<std::mutex> guard( lock );
+
+                if( ok )
+                {
+                    written++;
+                }
+                else
+                {
+                    fprintf( stderr, "Failed to render %s\n", path.c_str() );
+                    failed = true;
+                }
+            } );
+        }
+    }
+
+    thread_pool_stop( &pool );
+
+    printf( "%u charts written to %s\n", written, folder );
+    return failed ? 1 : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-k box|ridgeline|cdf|all] (-o chart.svg | -d folder) [options] input.lstore|input.csv ...\n", name );
+    printf( "  -o  one chart with every selected column, needs a single -k\n" );
+    printf( "  -d  one chart per source csv and kind, named <source>-<kind>.svg\n" );
+    printf( "  -t  title, -s subtitle\n" );
+    printf( "  -x  min,max x axis bounds, default from the data (either side may be empty)\n" );
+    printf( "  -a  bandwidth adjust, default 0.3 like the R scripts\n" );
+    printf( "  -c  comma separated column names, -p packet size prefix (e.g. 1024B)\n" );
+    printf( "  -u  unit of csv inputs (ms or ns), stores carry their own\n" );
+    printf( "  -w  width in pixels, -j render threads\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool load_sources( const std::string &path, const plot_filter_t &filter, std::vector<plot_source_t> *sources )
+{
+    if( capture_latency_has_extension( path, ".lstore" ) )
+    {
+        latency_store_t store;
+
+        if( !latency_store_open( &store, path.c_str() ) )
+        {
+            fprintf( stderr, "%s: not a latency store\n", path.c_str() );
+            return false;
+        }
+
+        for( uint32_t c = 0; c < latency_store_column_count( &store ); c++ )
+        {
+            latency_store_column_t column;
+            latency_store_column( &store, c, &column );
+
+            if( !keep_column( filter, column.name ) )
+            {
+                continue;
+            }
+
+            svg_chart_series_t series;
+            series.name = column.name;
+            series.values.reserve( column.count );
+
+            for( uint64_t v = 0; v < column.count; v++ )
+            {
+                series.values.push_back( latency_store_value( &column, v ) );
+            }
+
+            add_series( sources, column.source, filter.unit.empty() ? column.unit : filter.unit, std::move( series ) );
+        }
+
+        latency_store_close( &store );
+        return true;
+    }
+
+    std::vector<latency_column_t> columns;
+
+    if( !latency_columns_read_csv( path.c_str(), &columns ) )
+    {
+        fprintf( stderr, "%s: not a readable wide latency csv\n", path.c_str() );
+        return false;
+    }
+
+    const std::string source = std::filesystem::path( path ).filename().string();
+
+    for( latency_column_t &column : columns )
+    {
+        if( keep_column( filter, column.name ) )
+        {
+            add_series( sources, source, filter.unit.empty() ? "ms" : filter.unit, { column.name, std::move( column.values ) } );
+        }
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool keep_column( const plot_filter_t &filter, const std::string &name )
+{
+    // Same packetsize rule as the R scripts, everything before the first '-'
+    if( !filter.packetsize.empty() && name.substr( 0, name.find( '-' ) ) != filter.packetsize )
+    {
+        return false;
+    }
+
+    if( filter.columns.empty() )
+    {
+        return true;
+    }
+
+    for( const std::string &column : filter.columns )
+    {
+        if( column == name )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void add_series( std::vector<plot_source_t> *sources, const std::string &source, const std::string &unit, svg_chart_series_t series )
+{
+    for( plot_source_t &existing : *sources )
+    {
+        if( existing.source == source )
+        {
+            existing.series.push_back( std::move( series ) );
+            return;
+        }
+    }
+
+    sources->push_back( { source, unit, {} } );
+    sources->back().series.push_back( std::move( series ) );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool parse_kinds( const char *text, std::vector<svg_chart_kind_t> *kinds )
+{
+    kinds->clear();
+
+    for( const std::string &kind : split_list( text ) )
+    {
+        if( kind == "box" )
+        {
+            kinds->push_back( SVG_CHART_BOX );
+        }
+        else if( kind == "ridgeline" )
+        {
+            kinds->push_back( SVG_CHART_RIDGELINE );
+        }
+        else if( kind == "cdf" )
+        {
+            kinds->push_back( SVG_CHART_CDF );
+        }
+        else if( kind == "all" )
+        {
+            *kinds = { SVG_CHART_BOX, SVG_CHART_RIDGELINE, SVG_CHART_CDF };
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !kinds->empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static const char *kind_name( svg_chart_kind_t kind )
+{
+    switch( kind )
+    {
+        case SVG_CHART_RIDGELINE:
+            return "ridgeline";
+        case SVG_CHART_CDF:
+            return "cdf";
+        default:
+            return "box";
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static std::vector<std::string> split_list( const char *text )
+{
+    std::vector<std::string> items;
+    std::string              item;
+
+    for( const char *c = text;; c++ )
+    {
+        if( *c == ',' || *c == '\0' )
+        {
+            if( !item.empty() )
+            {
+                items.push_back( item );
+            }
+
+            item.clear();
+
+            if( *c == '\0' )
+            {
+                break;
+            }
+        }
+        else
+        {
+            item += *c;
+        }
+    }
+
+    return items;
+}
+
+/* -------------------------------------------------------------------------- */
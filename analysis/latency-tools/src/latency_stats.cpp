@@ -0,0 +1,216 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_stats.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define STATS_DOUBLE_MANTISSA_BITS (52u)
+#define STATS_DOUBLE_EXPONENT_BIAS (1023)
+#define STATS_MAX_SUB_BUCKET_BITS  (16u)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint32_t latency_stats_bucket( const latency_stats_t *stats, double value );
+static double latency_stats_order_statistic( const latency_stats_t *stats, uint64_t rank );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void latency_stats_init( latency_stats_t *stats, uint32_t sub_bucket_bits )
+{
+    if( sub_bucket_bits == 0 || sub_bucket_bits > STATS_MAX_SUB_BUCKET_BITS )
+    {
+        sub_bucket_bits = LATENCY_STATS_SUB_BUCKET_BITS;
+    }
+
+    const uint32_t octaves = LATENCY_STATS_MAX_EXPONENT - LATENCY_STATS_MIN_EXPONENT;
+
+    stats->sub_bucket_bits = sub_bucket_bits;
+    stats->buckets.assign( (size_t)octaves << sub_bucket_bits, 0 );
+    stats->count = 0;
+    stats->mean  = 0.0;
+    stats->m2    = 0.0;
+    stats->min   = INFINITY;
+    stats->max   = -INFINITY;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void latency_stats_add( latency_stats_t *stats, double value )
+{
+    if( isnan( value ) )
+    {
+        return;
+    }
+
+    stats->buckets[latency_stats_bucket( stats, value )]++;
+    stats->count++;
+
+    const double delta = value - stats->mean;
+    stats->mean += delta / (double)stats->count;
+    stats->m2 += delta * ( value - stats->mean );
+
+    stats->min = ( value < stats->min ) ? value : stats->min;
+    stats->max = ( value > stats->max ) ? value : stats->max;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool latency_stats_merge( latency_stats_t *stats, const latency_stats_t *from )
+{
+    if( stats->sub_bucket_bits != from->sub_bucket_bits || stats->buckets.size() != from->buckets.size() )
+    {
+        return false;
+    }
+
+    if( from->count == 0 )
+    {
+        return true;
+    }
+
+    for( size_t i = 0; i < stats->buckets.size(); i++ )
+    {
+        stats->buckets[i] += from->buckets[i];
+    }
+
+    // Chan et al. pairwise update of the running moments
+    const double n_a   = (double)stats->count;
+    const double n_b   = (double)from->count;
+    const double n     = n_a + n_b;
+    const double delta = from->mean - stats->mean;
+
+    stats->mean += delta * n_b / n;
+    stats->m2 += from->m2 + delta * delta * n_a * n_b / n;
+    stats->count += from->count;
+
+    stats->min = ( from->min < stats->min ) ? from->min : stats->min;
+    stats->max = ( from->max > stats->max ) ? from->max : stats->max;
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+double latency_stats_quantile( const latency_stats_t *stats, double q )
+{
+    if( stats->count == 0 || isnan( q ) )
+    {
+        return NAN;
+    }
+
+    q = ( q < 0.0 ) ? 0.0 : ( q > 1.0 ) ? 1.0 : q;
+
+    // Type 7: h = (n - 1) q, interpolate between the order statistics either side
+    const double   h     = (double)( stats->count - 1 ) * q;
+    const uint64_t below = (uint64_t)floor( h );
+    const double   frac  = h - (double)below;
+    const double   low   = latency_stats_order_statistic( stats, below );
+
+    if( frac == 0.0 || below + 1 >= stats->count )
+    {
+        return low;
+    }
+
+    return low + frac * ( latency_stats_order_statistic( stats, below + 1 ) - low );
+}
+
+/* -------------------------------------------------------------------------- */
+
+void latency_stats_summarise( const latency_stats_t *stats, latency_summary_t *summary )
+{
+    summary->count    = stats->count;
+    summary->min      = stats->count ? stats->min : NAN;
+    summary->max      = stats->count ? stats->max : NAN;
+    summary->mean     = stats->count ? stats->mean : NAN;
+    summary->variance = ( stats->count > 1 ) ? stats->m2 / (double)( stats->count - 1 ) : NAN;
+    summary->stddev   = sqrt( summary->variance );
+    summary->p25      = latency_stats_quantile( stats, 0.25 );
+    summary->p50      = latency_stats_quantile( stats, 0.50 );
+    summary->p75      = latency_stats_quantile( stats, 0.75 );
+    summary->p90      = latency_stats_quantile( stats, 0.90 );
+    summary->p99      = latency_stats_quantile( stats, 0.99 );
+    summary->p999     = latency_stats_quantile( stats, 0.999 );
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// The exponent and top mantissa bits of a positive double are already a
+// log-linear bucket number, no log() needed
+static uint32_t latency_stats_bucket( const latency_stats_t *stats, double value )
+{
+    if( !( value > 0.0 ) )
+    {
+        return 0;
+    }
+
+    uint64_t bits = 0;
+    memcpy( &bits, &value, sizeof( bits ) );
+
+    const int32_t exponent = (int32_t)( ( bits >> STATS_DOUBLE_MANTISSA_BITS ) & 0x7FF ) - STATS_DOUBLE_EXPONENT_BIAS;
+
+    if( exponent < LATENCY_STATS_MIN_EXPONENT )
+    {
+        return 0;
+    }
+
+    if( exponent >= LATENCY_STATS_MAX_EXPONENT )
+    {
+        return (uint32_t)stats->buckets.size() - 1;
+    }
+
+    const uint32_t sub = (uint32_t)( bits >> ( STATS_DOUBLE_MANTISSA_BITS - stats->sub_bucket_bits ) )
+                         & ( ( 1u << stats->sub_bucket_bits ) - 1 );
+
+    return ( (uint32_t)( exponent - LATENCY_STATS_MIN_EXPONENT ) << stats->sub_bucket_bits ) | sub;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Estimated value of the rank'th smallest sample (0 based)
+static double latency_stats_order_statistic( const latency_stats_t *stats, uint64_t rank )
+{
+    // The extremes are tracked exactly
+    if( rank == 0 )
+    {
+        return stats->min;
+    }
+
+    if( rank + 1 >= stats->count )
+    {
+        return stats->max;
+    }
+
+    const uint32_t bits       = stats->sub_bucket_bits;
+    const double   sub_count  = (double)( 1u << bits );
+    uint64_t       cumulative = 0;
+
+    for( size_t i = 0; i < stats->buckets.size(); i++ )
+    {
+        const uint64_t in_bucket = stats->buckets[i];
+
+        if( cumulative + in_bucket <= rank )
+        {
+            cumulative += in_bucket;
+            continue;
+        }
+
+        const int32_t exponent = (int32_t)( i >> bits ) + LATENCY_STATS_MIN_EXPONENT;
+        const double  sub      = (double)( i & ( ( 1u << bits ) - 1 ) );
+        const double  lower    = ldexp( 1.0 + sub / sub_count, exponent );
+        const double  upper    = ldexp( 1.0 + ( sub + 1.0 ) / sub_count, exponent );
+
+        // Spread the bucket's samples evenly across its width
+        const double position = ( (double)( rank - cumulative ) + 0.5 ) / (double)in_bucket;
+        const double value    = lower + ( upper - lower ) * position;
+
+        return ( value < stats->min ) ? stats->min : ( value > stats->max ) ? stats->max : value;
+    }
+
+    return stats->max;
+}
+
+/* ----- End ---------------------------------------------------------------- */
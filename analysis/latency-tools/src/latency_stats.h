@@ -0,0 +1,81 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <vector>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Log-linear (HDR style) buckets: every power of two between 2^MIN and 2^MAX is
+// split into 2^sub_bucket_bits equal buckets. 8 bits keeps quantiles within
+// ~0.4% of the true value, ~100kB per histogram.
+#define LATENCY_STATS_SUB_BUCKET_BITS (8u)
+#define LATENCY_STATS_MIN_EXPONENT    (-20)     // ~1ns when recording milliseconds
+#define LATENCY_STATS_MAX_EXPONENT    (30)      // ~12 days
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Single pass, bounded memory and mergeable across files or threads
+typedef struct
+{
+    uint32_t              sub_bucket_bits;
+    std::vector<uint64_t> buckets;
+    uint64_t              count;
+    double                mean;     // running mean and sum of squared deviations (Welford)
+    double                m2;
+    double                min;
+    double                max;
+} latency_stats_t;
+
+// The columns overall-comparison-barcharts.R builds with dplyr, plus the tails
+typedef struct
+{
+    uint64_t count;
+    double   min;
+    double   max;
+    double   mean;
+    double   variance;      // sample variance, same as R's var()
+    double   stddev;
+    double   p25;
+    double   p50;
+    double   p75;
+    double   p90;
+    double   p99;
+    double   p999;
+} latency_summary_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Pass 0 for the default precision */
+
+void latency_stats_init( latency_stats_t *stats, uint32_t sub_bucket_bits );
+
+/* -------------------------------------------------------------------------- */
+
+/** Records one sample, NaN (NA) is ignored */
+
+void latency_stats_add( latency_stats_t *stats, double value );
+
+/* -------------------------------------------------------------------------- */
+
+/** Adds from into stats. Both need the same precision. */
+
+bool latency_stats_merge( latency_stats_t *stats, const latency_stats_t *from );
+
+/* -------------------------------------------------------------------------- */
+
+/** Estimates quantile q (0..1) with R's default (type 7) interpolation between
+ *  order statistics. Samples are spread evenly through their bucket.
+ */
+
+double latency_stats_quantile( const latency_stats_t *stats, double q );
+
+/* -------------------------------------------------------------------------- */
+
+void latency_stats_summarise( const latency_stats_t *stats, latency_summary_t *summary );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LATENCY_STATS_H */
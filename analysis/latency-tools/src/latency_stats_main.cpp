@@ -0,0 +1,308 @@
+/* -------------------------------------------------------------------------- */
+
+// Summary tables for the latency charts without loading columns into R
+//
+// Groups columns the way overall-comparison-barcharts.R does ("1024B-TCP" ->
+// packetsize "1024B", subgroup "TCP"), streams every value into a mergeable
+// histogram and prints median/quartiles/tails per group. Inputs are read in
+// parallel and groups with the same name are merged across files.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "capture_latency.h"
+#include "latency_columns.h"
+#include "latency_stats.h"
+#include "latency_store.h"
+#include "thread_pool.h"
+
+/* -------------------------------------------------------------------------- */
+
+typedef std::pair<std::string, std::string>       group_key_t;     // subgroup, packetsize
+typedef std::map<group_key_t, latency_stats_t>    group_map_t;
+
+typedef struct
+{
+    bool        per_column;
+    uint32_t    precision;
+    std::mutex  lock;
+    group_map_t groups;
+    bool        failed;
+} stats_job_t;
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static group_key_t group_key( const std::string &name, bool per_column );
+static latency_stats_t *group_stats( group_map_t *groups, const group_key_t &key, uint32_t precision );
+static void process_input( stats_job_t *job, const std::string &path );
+static bool write_summary( FILE *f, const std::vector<std::pair<group_key_t, latency_summary_t>> &rows );
+static void print_value( FILE *f, double value );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    stats_job_t              job;
+    const char *             output  = 0;
+    uint32_t                 workers = 0;
+    std::vector<std::string> inputs;
+
+    job.per_column = false;
+    job.precision  = 0;
+    job.failed     = false;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-j" ) == 0 && i + 1 < argc )
+        {
+            workers = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-p" ) == 0 && i + 1 < argc )
+        {
+            job.precision = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-c" ) == 0 )
+        {
+            job.per_column = true;
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    if( inputs.empty() )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    thread_pool_t pool;
+    thread_pool_start( &pool, workers );
+
+    for( const std::string &path : inputs )
+    {
+        thread_pool_submit( &pool, [&job, path] { process_input( &job, path ); } );
+    }
+
+    thread_pool_stop( &pool );
+
+    if( job.failed )
+    {
+        return 1;
+    }
+
+    std::vector<std::pair<group_key_t, latency_summary_t>> rows;
+
+    for( const auto &group : job.groups )
+    {
+        latency_summary_t summary;
+        latency_stats_summarise( &group.second, &summary );
+        rows.push_back( { group.first, summary } );
+    }
+
+    // Same ordering as arrange(upper_quantile)
+    std::stable_sort( rows.begin(),
+                      rows.end(),
+                      []( const auto &a, const auto &b ) { return a.second.p75 < b.second.p75; } );
+
+    write_summary( stdout, rows );
+
+    if( output )
+    {
+        FILE *f = fopen( output, "wb" );
+
+        if( !f || !write_summary( f, rows ) || fclose( f ) != 0 )
+        {
+            fprintf( stderr, "Failed to write %s\n", output );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-c] [-j threads] [-p bits] [-o summary.csv] input.lstore|input.csv ...\n", name );
+    printf( "Single pass median/mean/quartiles/min/max/variance plus p90/p99/p99.9 for each\n" );
+    printf( "group of columns, using bounded-memory mergeable histograms.\n" );
+    printf( "  -c  one row per column instead of the packetsize/subgroup grouping\n" );
+    printf( "  -p  histogram sub-bucket bits, default %u (~0.4%% quantile error)\n", LATENCY_STATS_SUB_BUCKET_BITS );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// gsub("-.*", "", name) and gsub(".*-", "", name) from the R script
+static group_key_t group_key( const std::string &name, bool per_column )
+{
+    if( per_column )
+    {
+        return { name, "" };
+    }
+
+    const size_t first = name.find( '-' );
+    const size_t last  = name.rfind( '-' );
+
+    const std::string packetsize = ( first == std::string::npos ) ? name : name.substr( 0, first );
+    const std::string subgroup   = ( last == std::string::npos ) ? name : name.substr( last + 1 );
+
+    return { subgroup, packetsize };
+}
+
+/* -------------------------------------------------------------------------- */
+
+static latency_stats_t *group_stats( group_map_t *groups, const group_key_t &key, uint32_t precision )
+{
+    auto found = groups->find( key );
+
+    if( found == groups->end() )
+    {
+        found = groups->emplace( key, latency_stats_t() ).first;
+        latency_stats_init( &found->second, precision );
+    }
+
+    return &found->second;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void process_input( stats_job_t *job, const std::string &path )
+{
+    group_map_t local;
+
+    if( capture_latency_has_extension( path, ".lstore" ) )
+    {
+        latency_store_t store;
+
+        if( !latency_store_open( &store, path.c_str() ) )
+        {
+            fprintf( stderr, "%s: not a latency store\n", path.c_str() );
+            std::lock_guard<std::mutex> guard( job->lock );
+            job->failed = true;
+            return;
+        }
+
+        // Values stream straight out of the mapping, nothing is copied
+        for( uint32_t c = 0; c < latency_store_column_count( &store ); c++ )
+        {
+            latency_store_column_t column;
+            latency_store_column( &store, c, &column );
+
+            latency_stats_t *stats = group_stats( &local, group_key( column.name, job->per_column ), job->precision );
+
+            for( uint64_t v = 0; v < column.count; v++ )
+            {
+                latency_stats_add( stats, latency_store_value( &column, v ) );
+            }
+        }
+
+        latency_store_close( &store );
+    }
+    else
+    {
+        std::vector<latency_column_t> columns;
+
+        if( !latency_columns_read_csv( path.c_str(), &columns ) )
+        {
+            fprintf( stderr, "%s: not a readable wide latency csv\n", path.c_str() );
+            std::lock_guard<std::mutex> guard( job->lock );
+            job->failed = true;
+            return;
+        }
+
+        for( const latency_column_t &column : columns )
+        {
+            if( column.values.empty() )
+            {
+                continue;
+            }
+
+            latency_stats_t *stats = group_stats( &local, group_key( column.name, job->per_column ), job->precision );
+
+            for( double value : column.values )
+            {
+                latency_stats_add( stats, value );
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> guard( job->lock );
+
+    for( const auto &group : local )
+    {
+        latency_stats_merge( group_stats( &job->groups, group.first, job->precision ), &group.second );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_summary( FILE *f, const std::vector<std::pair<group_key_t, latency_summary_t>> &rows )
+{
+    fputs( "\"subgroup\",\"packetsize\",\"median\",\"mean\",\"lower_quantile\",\"upper_quantile\","
+           "\"min\",\"max\",\"variance\",\"num_samples\",\"p90\",\"p99\",\"p999\",\"stddev\"\n",
+           f );
+
+    for( const auto &row : rows )
+    {
+        const latency_summary_t &s = row.second;
+
+        fprintf( f, "\"%s\",\"%s\"", row.first.first.c_str(), row.first.second.c_str() );
+
+        for( double value : { s.p50, s.mean, s.p25, s.p75, s.min, s.max, s.variance } )
+        {
+            print_value( f, value );
+        }
+
+        fprintf( f, ",%llu", (unsigned long long)s.count );
+
+        for( double value : { s.p90, s.p99, s.p999, s.stddev } )
+        {
+            print_value( f, value );
+        }
+
+        fputc( '\n', f );
+    }
+
+    return !ferror( f );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_value( FILE *f, double value )
+{
+    if( isnan( value ) )
+    {
+        fputs( ",NA", f );
+    }
+    else
+    {
+        fprintf( f, ",%.7g", value );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,358 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_store.h"
+#include "dataset_naming.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+static_assert( sizeof( latency_store_header_t ) == 48, "store header layout changed" );
+static_assert( sizeof( latency_store_column_header_t ) == 48, "store column layout changed" );
+
+// Largest integer a double holds exactly, bigger values stay float64
+#define LATENCY_STORE_MAX_EXACT (9007199254740992.0)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint64_t latency_store_align( uint64_t offset );
+static uint32_t latency_store_add_string( std::string *strings, const std::string &value );
+static const char *latency_store_string( const latency_store_t *store, uint32_t offset );
+static bool latency_store_write_padding( FILE *f, uint64_t *position, uint64_t target );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool latency_store_write( const char *path, const std::vector<latency_store_entry_t> &entries )
+{
+    latency_store_header_t                     header;
+    std::vector<latency_store_column_header_t> columns( entries.size() );
+    std::string                                strings;
+
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, LATENCY_STORE_MAGIC, sizeof( header.magic ) );
+    header.version        = LATENCY_STORE_VERSION;
+    header.column_count   = (uint32_t)entries.size();
+    header.columns_offset = sizeof( header );
+
+    for( size_t i = 0; i < entries.size(); i++ )
+    {
+        const latency_store_entry_t &entry = entries[i];
+
+        memset( &columns[i], 0, sizeof( columns[i] ) );
+        columns[i].count         = entry.column.values.size();
+        columns[i].type          = entry.meta.type;
+        columns[i].payload_bytes = entry.meta.payload_bytes;
+        columns[i].name          = latency_store_add_string( &strings, entry.column.name );
+        columns[i].transport     = latency_store_add_string( &strings, entry.meta.transport );
+        columns[i].build_flags   = latency_store_add_string( &strings, entry.meta.build_flags );
+        columns[i].unit          = latency_store_add_string( &strings, entry.meta.unit );
+        columns[i].source        = latency_store_add_string( &strings, entry.meta.source );
+    }
+
+    header.strings_offset = header.columns_offset + columns.size() * sizeof( latency_store_column_header_t );
+    header.strings_size   = strings.size();
+
+    uint64_t offset = latency_store_align( header.strings_offset + header.strings_size );
+
+    for( latency_store_column_header_t &column : columns )
+    {
+        column.data_offset = offset;
+        offset             = latency_store_align( offset + column.count * sizeof( double ) );
+    }
+
+    header.file_size = offset;
+
+    FILE *f = fopen( path, "wb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    uint64_t position = 0;
+    bool     ok       = true;
+
+    ok = ok && fwrite( &header, sizeof( header ), 1, f ) == 1;
+    ok = ok && ( columns.empty() || fwrite( columns.data(), sizeof( columns[0] ), columns.size(), f ) == columns.size() );
+    ok = ok && ( strings.empty() || fwrite( strings.data(), 1, strings.size(), f ) == strings.size() );
+    position = header.strings_offset + header.strings_size;
+
+    for( size_t i = 0; ok && i < entries.size(); i++ )
+    {
+        const std::vector<double> &values = entries[i].column.values;
+
+        ok = latency_store_write_padding( f, &position, columns[i].data_offset );
+
+        if( ok && columns[i].type == LATENCY_STORE_INT64 )
+        {
+            std::vector<int64_t> converted( values.size() );
+
+            for( size_t v = 0; v < values.size(); v++ )
+            {
+                converted[v] = isnan( values[v] ) ? LATENCY_STORE_INT64_NA : (int64_t)values[v];
+            }
+
+            ok = converted.empty() || fwrite( converted.data(), sizeof( int64_t ), converted.size(), f ) == converted.size();
+        }
+        else if( ok )
+        {
+            ok = values.empty() || fwrite( values.data(), sizeof( double ), values.size(), f ) == values.size();
+        }
+
+        position += values.size() * sizeof( double );
+    }
+
+    ok = ok && latency_store_write_padding( f, &position, header.file_size );
+
+    return ( fclose( f ) == 0 ) && ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool latency_store_open( latency_store_t *store, const char *path )
+{
+    memset( store, 0, sizeof( *store ) );
+    store->fd = open( path, O_RDONLY );
+
+    if( store->fd < 0 )
+    {
+        return false;
+    }
+
+    struct stat info;
+
+    if( fstat( store->fd, &info ) != 0 || (size_t)info.st_size < sizeof( latency_store_header_t ) )
+    {
+        latency_store_close( store );
+        return false;
+    }
+
+    void *mapping = mmap( 0, (size_t)info.st_size, PROT_READ, MAP_SHARED, store->fd, 0 );
+
+    if( mapping == MAP_FAILED )
+    {
+        latency_store_close( store );
+        return false;
+    }
+
+    store->base   = (const uint8_t *)mapping;
+    store->size   = (size_t)info.st_size;
+    store->header = (const latency_store_header_t *)store->base;
+
+    const latency_store_header_t *header = store->header;
+
+    // Validate the tables once here so the accessors can trust them
+    bool ok = memcmp( header->magic, LATENCY_STORE_MAGIC, sizeof( header->magic ) ) == 0
+              && header->version == LATENCY_STORE_VERSION
+              && header->file_size == store->size
+              && header->columns_offset == sizeof( latency_store_header_t )
+              && header->column_count <= ( store->size - header->columns_offset ) / sizeof( latency_store_column_header_t )
+              && header->strings_offset == header->columns_offset + (uint64_t)header->column_count * sizeof( latency_store_column_header_t )
+              && header->strings_size <= store->size - header->strings_offset
+              && ( header->strings_size == 0 || store->base[header->strings_offset + header->strings_size - 1] == '\0' );
+
+    if( ok )
+    {
+        store->columns = (const latency_store_column_header_t *)( store->base + header->columns_offset );
+
+        for( uint32_t i = 0; ok && i < header->column_count; i++ )
+        {
+            const latency_store_column_header_t *column = &store->columns[i];
+
+            ok = ( column->type == LATENCY_STORE_FLOAT64 || column->type == LATENCY_STORE_INT64 )
+                 && column->data_offset % LATENCY_STORE_ALIGNMENT == 0
+                 && column->data_offset <= store->size
+                 && column->count <= ( store->size - column->data_offset ) / sizeof( double )
+                 && latency_store_string( store, column->name )
+                 && latency_store_string( store, column->transport )
+                 && latency_store_string( store, column->build_flags )
+                 && latency_store_string( store, column->unit )
+                 && latency_store_string( store, column->source );
+        }
+    }
+
+    if( !ok )
+    {
+        latency_store_close( store );
+        return false;
+    }
+
+    // Stats passes walk columns front to back
+    madvise( mapping, store->size, MADV_SEQUENTIAL );
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void latency_store_close( latency_store_t *store )
+{
+    if( store->base )
+    {
+        munmap( (void *)store->base, store->size );
+    }
+
+    if( store->fd >= 0 )
+    {
+        close( store->fd );
+    }
+
+    memset( store, 0, sizeof( *store ) );
+    store->fd = -1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t latency_store_column_count( const latency_store_t *store )
+{
+    return store->header ? store->header->column_count : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool latency_store_column( const latency_store_t *store, uint32_t index, latency_store_column_t *column )
+{
+    if( index >= latency_store_column_count( store ) )
+    {
+        return false;
+    }
+
+    const latency_store_column_header_t *header = &store->columns[index];
+    const void *                         data   = store->base + header->data_offset;
+
+    column->name          = latency_store_string( store, header->name );
+    column->transport     = latency_store_string( store, header->transport );
+    column->build_flags   = latency_store_string( store, header->build_flags );
+    column->unit          = latency_store_string( store, header->unit );
+    column->source        = latency_store_string( store, header->source );
+    column->payload_bytes = header->payload_bytes;
+    column->type          = (latency_store_type_t)header->type;
+    column->count         = header->count;
+    column->f64           = ( column->type == LATENCY_STORE_FLOAT64 ) ? (const double *)data : 0;
+    column->i64           = ( column->type == LATENCY_STORE_INT64 ) ? (const int64_t *)data : 0;
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int32_t latency_store_find( const latency_store_t *store, const char *name )
+{
+    for( uint32_t i = 0; i < latency_store_column_count( store ); i++ )
+    {
+        if( strcmp( latency_store_string( store, store->columns[i].name ), name ) == 0 )
+        {
+            return (int32_t)i;
+        }
+    }
+
+    return -1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+double latency_store_value( const latency_store_column_t *column, uint64_t index )
+{
+    if( column->type == LATENCY_STORE_INT64 )
+    {
+        const int64_t value = column->i64[index];
+        return ( value == LATENCY_STORE_INT64_NA ) ? NAN : (double)value;
+    }
+
+    return column->f64[index];
+}
+
+/* -------------------------------------------------------------------------- */
+
+void latency_store_infer_meta( const std::string &source, const latency_column_t &column, latency_store_meta_t *meta )
+{
+    dataset_tags_t tags = {};
+
+    // Column names are more specific than the file they came from
+    dataset_naming_infer( column.name, &tags );
+    dataset_naming_infer( source, &tags );
+
+    meta->transport     = tags.transport;
+    meta->build_flags   = tags.build_flags;
+    meta->payload_bytes = tags.payload_bytes;
+    meta->source        = source;
+
+    if( meta->unit.empty() )
+    {
+        meta->unit = "ms";
+    }
+
+    // Whole-number columns (the ns resolution STM32 logs) are stored as int64
+    meta->type = LATENCY_STORE_INT64;
+
+    for( double value : column.values )
+    {
+        if( !isnan( value ) && ( value != floor( value ) || fabs( value ) > LATENCY_STORE_MAX_EXACT ) )
+        {
+            meta->type = LATENCY_STORE_FLOAT64;
+            break;
+        }
+    }
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static uint64_t latency_store_align( uint64_t offset )
+{
+    return ( offset + LATENCY_STORE_ALIGNMENT - 1 ) & ~(uint64_t)( LATENCY_STORE_ALIGNMENT - 1 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t latency_store_add_string( std::string *strings, const std::string &value )
+{
+    const uint32_t offset = (uint32_t)strings->size();
+
+    strings->append( value );
+    strings->push_back( '\0' );
+
+    return offset;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static const char *latency_store_string( const latency_store_t *store, uint32_t offset )
+{
+    // The table is NUL terminated (checked on open), so any in-range offset is a valid string
+    if( offset >= store->header->strings_size )
+    {
+        return 0;
+    }
+
+    return (const char *)( store->base + store->header->strings_offset + offset );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool latency_store_write_padding( FILE *f, uint64_t *position, uint64_t target )
+{
+    static const uint8_t zeros[LATENCY_STORE_ALIGNMENT] = { 0 };
+
+    while( *position < target )
+    {
+        const uint64_t count = ( target - *position < sizeof( zeros ) ) ? target - *position : sizeof( zeros );
+
+        if( fwrite( zeros, 1, count, f ) != count )
+        {
+            return false;
+        }
+
+        *position += count;
+    }
+
+    return true;
+}
+
+/* ----- End ---------------------------------------------------------------- */
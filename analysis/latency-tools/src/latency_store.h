@@ -0,0 +1,155 @@
+#ifndef LATENCY_STORE_H
+#define LATENCY_STORE_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define LATENCY_STORE_MAGIC     "LATSTORE"
+#define LATENCY_STORE_VERSION   (1u)
+#define LATENCY_STORE_ALIGNMENT (64u)       // column data starts on a cache line
+
+// int64 columns have no NaN, this marks an NA cell instead
+#define LATENCY_STORE_INT64_NA  INT64_MIN
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef enum
+{
+    LATENCY_STORE_FLOAT64 = 1,
+    LATENCY_STORE_INT64   = 2,
+} latency_store_type_t;
+
+// On-disk layout, little-endian, everything naturally aligned so the mapped file
+// can be read in place:
+//
+//  header | column headers[column_count] | strings | padding | column data ...
+typedef struct
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t columns_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint64_t file_size;
+} latency_store_header_t;
+
+typedef struct
+{
+    uint64_t data_offset;
+    uint64_t count;
+    uint32_t type;              // latency_store_type_t
+    uint32_t payload_bytes;     // 0 if unknown
+    uint32_t name;              // offsets of NUL terminated strings in the string table
+    uint32_t transport;
+    uint32_t build_flags;
+    uint32_t unit;
+    uint32_t source;
+    uint32_t reserved;
+} latency_store_column_header_t;
+
+// What the writer needs to know about each column on top of the values
+typedef struct
+{
+    std::string          transport;     // "tcp", "nimble", "nrf24" ...
+    std::string          build_flags;   // comma separated, "dma,release"
+    std::string          unit;          // "ms" or "ns"
+    std::string          source;        // file the column was converted from
+    uint32_t             payload_bytes;
+    latency_store_type_t type;
+} latency_store_meta_t;
+
+typedef struct
+{
+    latency_column_t     column;
+    latency_store_meta_t meta;
+} latency_store_entry_t;
+
+// Read-only view of a mapped store
+typedef struct
+{
+    int                                  fd;
+    const uint8_t *                      base;
+    size_t                               size;
+    const latency_store_header_t *       header;
+    const latency_store_column_header_t *columns;
+} latency_store_t;
+
+// Read-only view of one column, the pointers are into the mapping
+typedef struct
+{
+    const char *         name;
+    const char *         transport;
+    const char *         build_flags;
+    const char *         unit;
+    const char *         source;
+    uint32_t             payload_bytes;
+    latency_store_type_t type;
+    uint64_t             count;
+    const double *       f64;       // set for LATENCY_STORE_FLOAT64
+    const int64_t *      i64;       // set for LATENCY_STORE_INT64
+} latency_store_column_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Writes entries to a new store. Columns marked LATENCY_STORE_INT64 must only
+ *  hold whole numbers (or NaN).
+ */
+
+bool latency_store_write( const char *path, const std::vector<latency_store_entry_t> &entries );
+
+/* -------------------------------------------------------------------------- */
+
+/** Maps a store read-only and validates the header, column table and strings.
+ *  Nothing is copied, opening is O(columns) regardless of the sample count.
+ */
+
+bool latency_store_open( latency_store_t *store, const char *path );
+
+/* -------------------------------------------------------------------------- */
+
+void latency_store_close( latency_store_t *store );
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t latency_store_column_count( const latency_store_t *store );
+
+/* -------------------------------------------------------------------------- */
+
+/** Fills a view of the column at index */
+
+bool latency_store_column( const latency_store_t *store, uint32_t index, latency_store_column_t *column );
+
+/* -------------------------------------------------------------------------- */
+
+/** Returns the index of the first column with a matching name, or -1 */
+
+int32_t latency_store_find( const latency_store_t *store, const char *name );
+
+/* -------------------------------------------------------------------------- */
+
+/** Reads one value as a double, NA cells come back as NaN */
+
+double latency_store_value( const latency_store_column_t *column, uint64_t index );
+
+/* -------------------------------------------------------------------------- */
+
+/** Fills in transport, payload size, build flags and the storage type from the
+ *  column and file naming used in analysis/ (e.g. "1024B-TCP" in esp32-tcp-modified.csv).
+ */
+
+void latency_store_infer_meta( const std::string &source, const latency_column_t &column, latency_store_meta_t *meta );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LATENCY_STORE_H */
@@ -0,0 +1,312 @@
+/* -------------------------------------------------------------------------- */
+
+// Converts the wide analysis csv files into memory-mappable column stores and back
+//
+//  latency-store convert [-o out.lstore] [-u ns] [-t transport] [-f flags] in.csv ...
+//  latency-store info store.lstore ...
+//  latency-store export [-o out.csv] store.lstore
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+#include "latency_store.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define STORE_EXTENSION ".lstore"
+
+/* -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    std::string              output;
+    std::string              unit;
+    std::string              transport;
+    std::string              build_flags;
+    std::vector<std::string> inputs;
+} store_options_t;
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool parse_options( int argc, char *argv[], store_options_t *options );
+static std::string replace_extension( const std::string &path, const char *extension );
+static bool load_csv( const std::string &path, const store_options_t &options, std::vector<latency_store_entry_t> *entries );
+static int command_convert( const store_options_t &options );
+static int command_info( const store_options_t &options );
+static int command_export( const store_options_t &options );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    store_options_t options;
+
+    if( argc < 2 || !parse_options( argc - 2, argv + 2, &options ) )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    if( strcmp( argv[1], "convert" ) == 0 )
+    {
+        return command_convert( options );
+    }
+    else if( strcmp( argv[1], "info" ) == 0 )
+    {
+        return command_info( options );
+    }
+    else if( strcmp( argv[1], "export" ) == 0 )
+    {
+        return command_export( options );
+    }
+
+    print_usage( argv[0] );
+    return strcmp( argv[1], "-h" ) == 0 ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s convert [-o out%s] [-u ms|ns] [-t transport] [-f flags] in.csv ...\n", name, STORE_EXTENSION );
+    printf( "       %s info store%s ...\n", name, STORE_EXTENSION );
+    printf( "       %s export [-o out.csv] store%s\n", name, STORE_EXTENSION );
+    printf( "convert writes one store per csv next to the input, or a single combined store\n" );
+    printf( "with -o. Transport, payload size and build flags are inferred from the column\n" );
+    printf( "and file names unless given. export writes the wide csv layout the R scripts read.\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool parse_options( int argc, char *argv[], store_options_t *options )
+{
+    for( int i = 0; i < argc; i++ )
+    {
+        const bool has_value = ( i + 1 < argc );
+
+        if( strcmp( argv[i], "-o" ) == 0 && has_value )
+        {
+            options->output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-u" ) == 0 && has_value )
+        {
+            options->unit = argv[++i];
+        }
+        else if( strcmp( argv[i], "-t" ) == 0 && has_value )
+        {
+            options->transport = argv[++i];
+        }
+        else if( strcmp( argv[i], "-f" ) == 0 && has_value )
+        {
+            options->build_flags = argv[++i];
+        }
+        else if( argv[i][0] == '-' )
+        {
+            return false;
+        }
+        else
+        {
+            options->inputs.push_back( argv[i] );
+        }
+    }
+
+    return !options->inputs.empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static std::string replace_extension( const std::string &path, const char *extension )
+{
+    const size_t slash = path.find_last_of( '/' );
+    const size_t dot   = path.find_last_of( '.' );
+
+    if( dot != std::string::npos && ( slash == std::string::npos || dot > slash ) )
+    {
+        return path.substr( 0, dot ) + extension;
+    }
+
+    return path + extension;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool load_csv( const std::string &path, const store_options_t &options, std::vector<latency_store_entry_t> *entries )
+{
+    std::vector<latency_column_t> columns;
+
+    if( !latency_columns_read_csv( path.c_str(), &columns ) )
+    {
+        fprintf( stderr, "%s: not a readable wide latency csv\n", path.c_str() );
+        return false;
+    }
+
+    const size_t slash  = path.find_last_of( '/' );
+    std::string  source = ( slash == std::string::npos ) ? path : path.substr( slash + 1 );
+
+    for( latency_column_t &column : columns )
+    {
+        // Spacer columns like the blank one in hc-05-test-data-faster.csv
+        if( column.name.empty() && column.values.empty() )
+        {
+            continue;
+        }
+
+        latency_store_entry_t entry;
+        entry.meta.unit = options.unit;
+        latency_store_infer_meta( source, column, &entry.meta );
+
+        if( !options.transport.empty() )
+        {
+            entry.meta.transport = options.transport;
+        }
+
+        if( !options.build_flags.empty() )
+        {
+            entry.meta.build_flags = options.build_flags;
+        }
+
+        entry.column = std::move( column );
+        entries->push_back( std::move( entry ) );
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int command_convert( const store_options_t &options )
+{
+    std::vector<latency_store_entry_t> combined;
+
+    for( const std::string &input : options.inputs )
+    {
+        std::vector<latency_store_entry_t> entries;
+
+        if( !load_csv( input, options, options.output.empty() ? &entries : &combined ) )
+        {
+            return 1;
+        }
+
+        if( options.output.empty() )
+        {
+            const std::string output = replace_extension( input, STORE_EXTENSION );
+
+            if( !latency_store_write( output.c_str(), entries ) )
+            {
+                fprintf( stderr, "Failed to write %s\n", output.c_str() );
+                return 1;
+            }
+
+            printf( "%s -> %s (%zu columns)\n", input.c_str(), output.c_str(), entries.size() );
+        }
+    }
+
+    if( !options.output.empty() )
+    {
+        if( !latency_store_write( options.output.c_str(), combined ) )
+        {
+            fprintf( stderr, "Failed to write %s\n", options.output.c_str() );
+            return 1;
+        }
+
+        printf( "%s (%zu columns)\n", options.output.c_str(), combined.size() );
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int command_info( const store_options_t &options )
+{
+    for( const std::string &input : options.inputs )
+    {
+        latency_store_t store;
+
+        if( !latency_store_open( &store, input.c_str() ) )
+        {
+            fprintf( stderr, "%s: not a latency store\n", input.c_str() );
+            return 1;
+        }
+
+        printf( "%s: %u columns\n", input.c_str(), latency_store_column_count( &store ) );
+
+        for( uint32_t i = 0; i < latency_store_column_count( &store ); i++ )
+        {
+            latency_store_column_t column;
+            latency_store_column( &store, i, &column );
+
+            printf( "  %-28s %-7s %6llu x %s  transport=%s payload=%u flags=%s source=%s\n",
+                    column.name,
+                    column.type == LATENCY_STORE_INT64 ? "int64" : "float64",
+                    (unsigned long long)column.count,
+                    column.unit,
+                    column.transport[0] ? column.transport : "?",
+                    column.payload_bytes,
+                    column.build_flags,
+                    column.source );
+        }
+
+        latency_store_close( &store );
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int command_export( const store_options_t &options )
+{
+    if( options.inputs.size() != 1 )
+    {
+        fprintf( stderr, "export takes a single store\n" );
+        return 1;
+    }
+
+    const std::string &input  = options.inputs[0];
+    const std::string  output = options.output.empty() ? replace_extension( input, ".csv" ) : options.output;
+    latency_store_t    store;
+
+    if( !latency_store_open( &store, input.c_str() ) )
+    {
+        fprintf( stderr, "%s: not a latency store\n", input.c_str() );
+        return 1;
+    }
+
+    std::vector<latency_column_t> columns( latency_store_column_count( &store ) );
+
+    for( uint32_t i = 0; i < columns.size(); i++ )
+    {
+        latency_store_column_t column;
+        latency_store_column( &store, i, &column );
+
+        columns[i].name = column.name;
+        columns[i].values.resize( column.count );
+
+        for( uint64_t v = 0; v < column.count; v++ )
+        {
+            columns[i].values[v] = latency_store_value( &column, v );
+        }
+    }
+
+    latency_store_close( &store );
+
+    if( !latency_columns_write_csv( output.c_str(), columns ) )
+    {
+        fprintf( stderr, "Failed to write %s\n", output.c_str() );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,557 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <algorithm>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "link_sim.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define LINK_NRF24_MAX_PACKET (32u)
+#define LINK_LORA_MAX_PACKET  (255u)
+
+// 802.15.4 O-QPSK at 2.4 GHz
+#define LINK_802154_US_PER_BYTE   (32.0)
+#define LINK_802154_TURNAROUND_US (192.0)
+#define LINK_802154_BACKOFF_US    (320.0)
+#define LINK_802154_CCA_US        (128.0)
+
+/* ----- Types -------------------------------------------------------------- */
+
+enum
+{
+    UART_EVENT_CHUNK_DONE = LINK_EVENT_MODEL,
+};
+
+enum
+{
+    NRF24_EVENT_AIR_END = LINK_EVENT_MODEL,     // a data packet left the antenna
+    NRF24_EVENT_ACKED,
+    NRF24_EVENT_NO_ACK,
+};
+
+enum
+{
+    LORA_EVENT_AIR_END = LINK_EVENT_MODEL,
+};
+
+enum
+{
+    BLE_EVENT_CONNECTION = LINK_EVENT_MODEL,
+};
+
+enum
+{
+    IEEE802154_EVENT_FRAME = LINK_EVENT_MODEL,  // ready to send the frame at offset
+    IEEE802154_EVENT_CCA,
+    IEEE802154_EVENT_AIR_END,
+    IEEE802154_EVENT_ACKED,
+    IEEE802154_EVENT_NO_ACK,
+};
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static void uart_trigger( link_sim_t *sim );
+static void uart_handle( link_sim_t *sim, const link_event_t *event );
+static void uart_send_chunk( link_sim_t *sim, double delay_us );
+
+static void nrf24_trigger( link_sim_t *sim );
+static void nrf24_handle( link_sim_t *sim, const link_event_t *event );
+static void nrf24_send_packet( link_sim_t *sim, double delay_us );
+static uint32_t nrf24_packet_length( const link_sim_t *sim );
+static uint32_t nrf24_air_length( const link_sim_t *sim );
+
+static void lora_trigger( link_sim_t *sim );
+static void lora_handle( link_sim_t *sim, const link_event_t *event );
+static void lora_send_packet( link_sim_t *sim );
+static double lora_symbol_us( const link_lora_t *lora );
+static double lora_time_on_air_us( const link_lora_t *lora, uint32_t length );
+
+static void ble_trigger( link_sim_t *sim );
+static void ble_handle( link_sim_t *sim, const link_event_t *event );
+
+static void ieee802154_trigger( link_sim_t *sim );
+static void ieee802154_handle( link_sim_t *sim, const link_event_t *event );
+static void ieee802154_backoff( link_sim_t *sim );
+static uint32_t ieee802154_frame_length( const link_sim_t *sim );
+
+/* ----- Private Variables -------------------------------------------------- */
+
+static const link_model_t link_models[LINK_KIND_COUNT] = {
+    { "uart", uart_trigger, uart_handle },
+    { "nrf24", nrf24_trigger, nrf24_handle },
+    { "lora", lora_trigger, lora_handle },
+    { "ble", ble_trigger, ble_handle },
+    { "802154", ieee802154_trigger, ieee802154_handle },
+};
+
+/* ----- Public Functions --------------------------------------------------- */
+
+const link_model_t *link_model_for( link_kind_t kind )
+{
+    return &link_models[( kind < LINK_KIND_COUNT ) ? kind : LINK_KIND_UART];
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// UART: the sender starts as soon as the trigger is handled, DMA transfers
+// can be split into chunks with a setup gap between them. The receiver's
+// done edge follows the last stop bit, or an idle character later when it
+// waits for the DMA idle line interrupt.
+static void uart_trigger( link_sim_t *sim )
+{
+    const link_uart_t *uart     = &sim->config->uart;
+    const double       delay_us = uart->tx_overhead_us + ( ( uart->mode != LINK_UART_POLL ) ? uart->irq_us : 0.0 );
+
+    uart_send_chunk( sim, delay_us );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void uart_handle( link_sim_t *sim, const link_event_t *event )
+{
+    const link_uart_t *uart = &sim->config->uart;
+
+    if( event->kind != UART_EVENT_CHUNK_DONE )
+    {
+        return;
+    }
+
+    if( sim->offset < sim->config->payload_bytes )
+    {
+        uart_send_chunk( sim, 0.0 );
+        return;
+    }
+
+    // The receiver samples the start bit anywhere within a bit time
+    const double bit_us  = 1e6 / uart->baud;
+    double       done_us = uart->rx_overhead_us + link_sim_uniform( sim ) * bit_us;
+
+    if( uart->mode == LINK_UART_DMA )
+    {
+        done_us += uart->dma_idle_chars * uart->bits_per_byte * bit_us;
+    }
+
+    if( uart->mode != LINK_UART_POLL )
+    {
+        done_us += uart->irq_us;
+    }
+
+    link_sim_schedule( sim, done_us, LINK_EVENT_DELIVER, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void uart_send_chunk( link_sim_t *sim, double delay_us )
+{
+    const link_uart_t *uart      = &sim->config->uart;
+    const uint32_t     remaining = sim->config->payload_bytes - sim->offset;
+    uint32_t           length    = remaining;
+
+    if( uart->mode == LINK_UART_DMA )
+    {
+        if( uart->dma_chunk && uart->dma_chunk < remaining )
+        {
+            length = uart->dma_chunk;
+        }
+
+        delay_us += uart->dma_setup_us;
+    }
+
+    delay_us += (double)length * uart->bits_per_byte * 1e6 / uart->baud;
+    sim->offset += length;
+
+    link_sim_schedule( sim, delay_us, UART_EVENT_CHUNK_DONE, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// nRF24: each packet is clocked into the FIFO, sent after the PLL settles and
+// waits for the auto ACK. A lost packet or ACK costs the ACK window and the
+// auto retransmit delay, after ARC retransmits the packet is dropped. The
+// receiver raises its interrupt a few bits after the packet ends and the
+// payload is clocked back out over SPI.
+static void nrf24_trigger( link_sim_t *sim )
+{
+    nrf24_send_packet( sim, 0.0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void nrf24_handle( link_sim_t *sim, const link_event_t *event )
+{
+    const link_nrf24_t *nrf24  = &sim->config->nrf24;
+    const double        bit_us = 1000.0 / nrf24->rate_kbps;
+
+    // PID, CRC, no payload
+    const double ack_window_us = nrf24->settle_us + ( 8.0 * ( 1 + nrf24->address_bytes + nrf24->crc_bytes ) + 9.0 ) * bit_us;
+
+    switch( event->kind )
+    {
+        case NRF24_EVENT_AIR_END:
+        {
+            const bool received = !link_sim_chance( sim, nrf24->data_loss );
+
+            // A retransmit of a packet the receiver already has is dropped by PID
+            if( received && !sim->received )
+            {
+                sim->received = true;
+
+                if( sim->offset + nrf24_packet_length( sim ) >= sim->config->payload_bytes )
+                {
+                    const double read_us = nrf24->rx_delay_bits * bit_us
+                                           + nrf24->spi_us_per_byte * (double)( nrf24_air_length( sim ) + 1 )
+                                           + nrf24->rx_overhead_us;
+
+                    link_sim_schedule( sim, read_us, LINK_EVENT_DELIVER, 0 );
+                }
+            }
+
+            const bool acked = received && !link_sim_chance( sim, nrf24->ack_loss );
+
+            link_sim_schedule( sim, ack_window_us, acked ? NRF24_EVENT_ACKED : NRF24_EVENT_NO_ACK, 0 );
+            break;
+        }
+
+        case NRF24_EVENT_ACKED:
+            sim->offset += nrf24_packet_length( sim );
+            sim->attempt  = 0;
+            sim->received = false;
+
+            if( sim->offset < sim->config->payload_bytes )
+            {
+                nrf24_send_packet( sim, nrf24->irq_us );
+            }
+            break;
+
+        case NRF24_EVENT_NO_ACK:
+            // MAX_RT, the rest of the frame is never sent
+            if( ++sim->attempt > nrf24->arc )
+            {
+                break;
+            }
+
+            link_sim_schedule( sim, nrf24->ard_us, NRF24_EVENT_AIR_END, 0 );
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void nrf24_send_packet( link_sim_t *sim, double delay_us )
+{
+    const link_nrf24_t *nrf24  = &sim->config->nrf24;
+    const uint32_t      length = nrf24_air_length( sim );
+    const double        bit_us = 1000.0 / nrf24->rate_kbps;
+
+    // Preamble, address, 9 bit packet control, payload, CRC
+    const double air_us = ( 8.0 * ( 1 + nrf24->address_bytes + length + nrf24->crc_bytes ) + 9.0 ) * bit_us;
+
+    delay_us += nrf24->tx_overhead_us + nrf24->spi_us_per_byte * (double)( length + 1 ) + nrf24->settle_us + air_us;
+
+    link_sim_schedule( sim, delay_us, NRF24_EVENT_AIR_END, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t nrf24_packet_length( const link_sim_t *sim )
+{
+    const uint32_t packet = std::min( std::max( sim->config->nrf24.packet_bytes, 1u ), LINK_NRF24_MAX_PACKET );
+
+    return std::min( packet, sim->config->payload_bytes - sim->offset );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t nrf24_air_length( const link_sim_t *sim )
+{
+    if( sim->config->nrf24.padded )
+    {
+        return std::min( std::max( sim->config->nrf24.packet_bytes, 1u ), LINK_NRF24_MAX_PACKET );
+    }
+
+    return nrf24_packet_length( sim );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// LoRa: packets go out one after another, each loaded over SPI first. The
+// receiver's RxDone follows the end of the packet and the payload is read
+// back over SPI.
+static void lora_trigger( link_sim_t *sim )
+{
+    lora_send_packet( sim );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void lora_handle( link_sim_t *sim, const link_event_t *event )
+{
+    const link_lora_t *lora = &sim->config->lora;
+
+    if( event->kind != LORA_EVENT_AIR_END )
+    {
+        return;
+    }
+
+    sim->offset += event->arg;
+
+    if( sim->offset < sim->config->payload_bytes )
+    {
+        lora_send_packet( sim );
+        return;
+    }
+
+    const double read_us = lora->rx_delay_symbols * lora_symbol_us( lora )
+                           + lora->spi_us_per_byte * (double)event->arg
+                           + lora->rx_overhead_us;
+
+    link_sim_schedule( sim, read_us, LINK_EVENT_DELIVER, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void lora_send_packet( link_sim_t *sim )
+{
+    const link_lora_t *lora   = &sim->config->lora;
+    const uint32_t     packet = std::min( std::max( lora->packet_bytes, 1u ), LINK_LORA_MAX_PACKET );
+    const uint32_t     length = std::min( packet, sim->config->payload_bytes - sim->offset );
+
+    const double delay_us = lora->tx_overhead_us
+                            + lora->spi_us_per_byte * (double)length
+                            + lora_time_on_air_us( lora, length );
+
+    link_sim_schedule( sim, delay_us, LORA_EVENT_AIR_END, (uint16_t)length );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double lora_symbol_us( const link_lora_t *lora )
+{
+    return (double)( 1u << lora->spreading_factor ) * 1e6 / lora->bandwidth_hz;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Semtech's time on air formula (SX1276 datasheet 4.1.1.7)
+static double lora_time_on_air_us( const link_lora_t *lora, uint32_t length )
+{
+    const double symbol_us = lora_symbol_us( lora );
+    const int    sf        = (int)lora->spreading_factor;
+    const int    de        = ( lora->low_data_rate < 0 ) ? ( symbol_us > 16000.0 ) : ( lora->low_data_rate != 0 );
+    const double numerator = 8.0 * length - 4.0 * sf + 28.0 + 16.0 * ( lora->crc ? 1 : 0 );
+    const double symbols   = 8.0 + std::max( ceil( numerator / ( 4.0 * ( sf - 2 * de ) ) ) * ( lora->coding_rate + 4 ), 0.0 );
+
+    return ( lora->preamble_symbols + 4.25 + symbols ) * symbol_us;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// BLE: data queued at least lead_us before a connection event goes out in
+// it, one PDU per exchange with the peer's empty reply, as long as the
+// event's budget lasts. The trigger lands at a random phase of the
+// connection interval.
+static void ble_trigger( link_sim_t *sim )
+{
+    const link_ble_t *ble = &sim->config->ble;
+
+    // Connection events at phase + k * interval since the trigger edge
+    double event_us = link_sim_uniform( sim ) * ble->interval_us;
+
+    while( event_us < sim->now_us + ble->lead_us )
+    {
+        event_us += ble->interval_us;
+    }
+
+    link_sim_schedule( sim, event_us - sim->now_us, BLE_EVENT_CONNECTION, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void ble_handle( link_sim_t *sim, const link_event_t *event )
+{
+    const link_ble_t *ble     = &sim->config->ble;
+    const double      byte_us = 8000.0 / ble->phy_kbps;
+    const double      budget  = std::min( ble->event_length_us, ble->interval_us - ble->ifs_us );
+    const uint32_t    chunk   = std::max( ble->chunk_bytes, 1u );
+    double            used_us = 0.0;
+
+    if( event->kind != BLE_EVENT_CONNECTION )
+    {
+        return;
+    }
+
+    while( sim->offset < sim->config->payload_bytes )
+    {
+        const uint32_t length  = std::min( chunk, sim->config->payload_bytes - sim->offset );
+        const double   pdu_us  = (double)( length + ble->pdu_overhead_bytes ) * byte_us;
+        const double   done_us = used_us + pdu_us + ble->ifs_us + (double)ble->empty_pdu_bytes * byte_us;
+
+        // Always room for one exchange, otherwise wait for the next event
+        if( used_us > 0.0 && done_us > budget )
+        {
+            break;
+        }
+
+        // A missed PDU isn't acknowledged and goes again
+        if( !link_sim_chance( sim, ble->packet_loss ) )
+        {
+            sim->offset += length;
+
+            if( sim->offset >= sim->config->payload_bytes )
+            {
+                link_sim_schedule( sim, used_us + pdu_us + ble->rx_overhead_us, LINK_EVENT_DELIVER, 0 );
+                return;
+            }
+        }
+
+        used_us = done_us + ble->ifs_us;
+    }
+
+    link_sim_schedule( sim, ble->interval_us, BLE_EVENT_CONNECTION, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// 802.15.4: frames go out after an optional unslotted CSMA-CA and the RX to
+// TX turnaround. With ACKs on, a missing ACK means a retransmit once the ACK
+// wait runs out, up to max_retries times before the frame is dropped.
+static void ieee802154_trigger( link_sim_t *sim )
+{
+    link_sim_schedule( sim, sim->config->ieee802154.tx_overhead_us, IEEE802154_EVENT_FRAME, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void ieee802154_handle( link_sim_t *sim, const link_event_t *event )
+{
+    const link_802154_t *mac = &sim->config->ieee802154;
+
+    switch( event->kind )
+    {
+        case IEEE802154_EVENT_FRAME:
+            if( mac->csma )
+            {
+                sim->backoffs = 0;
+                sim->exponent = mac->min_be;
+                ieee802154_backoff( sim );
+            }
+            else
+            {
+                const double air_us = (double)( ieee802154_frame_length( sim ) + mac->frame_overhead_bytes ) * LINK_802154_US_PER_BYTE;
+
+                link_sim_schedule( sim, LINK_802154_TURNAROUND_US + air_us, IEEE802154_EVENT_AIR_END, 0 );
+            }
+            break;
+
+        case IEEE802154_EVENT_CCA:
+            if( link_sim_chance( sim, mac->busy ) )
+            {
+                // Channel access failure drops the frame
+                if( ++sim->backoffs > mac->max_backoffs )
+                {
+                    break;
+                }
+
+                sim->exponent = std::min( sim->exponent + 1, mac->max_be );
+                ieee802154_backoff( sim );
+            }
+            else
+            {
+                const double air_us = (double)( ieee802154_frame_length( sim ) + mac->frame_overhead_bytes ) * LINK_802154_US_PER_BYTE;
+
+                link_sim_schedule( sim, LINK_802154_TURNAROUND_US + air_us, IEEE802154_EVENT_AIR_END, 0 );
+            }
+            break;
+
+        case IEEE802154_EVENT_AIR_END:
+        {
+            const bool received = !link_sim_chance( sim, mac->frame_loss );
+
+            // Retransmits of a frame the receiver has are filtered by sequence number
+            if( received && !sim->received )
+            {
+                sim->received = true;
+
+                if( sim->offset + ieee802154_frame_length( sim ) >= sim->config->payload_bytes )
+                {
+                    link_sim_schedule( sim, mac->rx_overhead_us, LINK_EVENT_DELIVER, 0 );
+                }
+            }
+
+            if( !mac->ack )
+            {
+                // Fire and forget, a lost frame leaves a hole nobody notices
+                if( !received )
+                {
+                    break;
+                }
+
+                sim->offset += ieee802154_frame_length( sim );
+                sim->received = false;
+
+                if( sim->offset < sim->config->payload_bytes )
+                {
+                    link_sim_schedule( sim, mac->next_overhead_us, IEEE802154_EVENT_FRAME, 0 );
+                }
+            }
+            else if( received && !link_sim_chance( sim, mac->ack_loss ) )
+            {
+                const double ack_us = LINK_802154_TURNAROUND_US + (double)mac->ack_bytes * LINK_802154_US_PER_BYTE;
+
+                link_sim_schedule( sim, ack_us, IEEE802154_EVENT_ACKED, 0 );
+            }
+            else
+            {
+                link_sim_schedule( sim, mac->ack_wait_us, IEEE802154_EVENT_NO_ACK, 0 );
+            }
+            break;
+        }
+
+        case IEEE802154_EVENT_ACKED:
+            sim->offset += ieee802154_frame_length( sim );
+            sim->attempt  = 0;
+            sim->received = false;
+
+            if( sim->offset < sim->config->payload_bytes )
+            {
+                link_sim_schedule( sim, mac->ack_overhead_us + mac->next_overhead_us, IEEE802154_EVENT_FRAME, 0 );
+            }
+            break;
+
+        case IEEE802154_EVENT_NO_ACK:
+            if( ++sim->attempt <= mac->max_retries )
+            {
+                link_sim_schedule( sim, 0.0, IEEE802154_EVENT_FRAME, 0 );
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void ieee802154_backoff( link_sim_t *sim )
+{
+    const double backoff_us = (double)link_sim_below( sim, 1u << sim->exponent ) * LINK_802154_BACKOFF_US;
+
+    link_sim_schedule( sim, backoff_us + LINK_802154_CCA_US, IEEE802154_EVENT_CCA, 0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t ieee802154_frame_length( const link_sim_t *sim )
+{
+    const uint32_t packet = std::max( sim->config->ieee802154.packet_bytes, 1u );
+
+    return std::min( packet, sim->config->payload_bytes - sim->offset );
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,555 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "link_sim.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef enum
+{
+    LINK_SETTING_DOUBLE,
+    LINK_SETTING_U32,
+    LINK_SETTING_I32,
+    LINK_SETTING_BOOL,
+    LINK_SETTING_UART_MODE,
+} link_setting_type_t;
+
+// A key=value setting, kind LINK_KIND_COUNT for the ones every kind has
+typedef struct
+{
+    link_kind_t         kind;
+    const char         *key;
+    link_setting_type_t type;
+    size_t              offset;
+} link_setting_t;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool link_setting_set( const link_setting_t *setting, link_config_t *config, const std::string &value );
+static std::string link_setting_get( const link_setting_t *setting, const link_config_t &config );
+static bool link_event_later( const link_event_t &a, const link_event_t &b );
+static uint64_t link_splitmix64( uint64_t *state );
+static uint64_t link_rng_next( link_sim_t *sim );
+
+/* ----- Private Variables -------------------------------------------------- */
+
+static const link_setting_t link_settings[] = {
+    { LINK_KIND_COUNT, "payload_bytes", LINK_SETTING_U32, offsetof( link_config_t, payload_bytes ) },
+    { LINK_KIND_COUNT, "jitter_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, jitter_us ) },
+
+    { LINK_KIND_UART, "baud", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.baud ) },
+    { LINK_KIND_UART, "bits_per_byte", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.bits_per_byte ) },
+    { LINK_KIND_UART, "mode", LINK_SETTING_UART_MODE, offsetof( link_config_t, uart.mode ) },
+    { LINK_KIND_UART, "dma_chunk", LINK_SETTING_U32, offsetof( link_config_t, uart.dma_chunk ) },
+    { LINK_KIND_UART, "dma_setup_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.dma_setup_us ) },
+    { LINK_KIND_UART, "dma_idle_chars", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.dma_idle_chars ) },
+    { LINK_KIND_UART, "irq_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.irq_us ) },
+    { LINK_KIND_UART, "tx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.tx_overhead_us ) },
+    { LINK_KIND_UART, "rx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, uart.rx_overhead_us ) },
+
+    { LINK_KIND_NRF24, "rate_kbps", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.rate_kbps ) },
+    { LINK_KIND_NRF24, "address_bytes", LINK_SETTING_U32, offsetof( link_config_t, nrf24.address_bytes ) },
+    { LINK_KIND_NRF24, "crc_bytes", LINK_SETTING_U32, offsetof( link_config_t, nrf24.crc_bytes ) },
+    { LINK_KIND_NRF24, "packet_bytes", LINK_SETTING_U32, offsetof( link_config_t, nrf24.packet_bytes ) },
+    { LINK_KIND_NRF24, "padded", LINK_SETTING_BOOL, offsetof( link_config_t, nrf24.padded ) },
+    { LINK_KIND_NRF24, "spi_us_per_byte", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.spi_us_per_byte ) },
+    { LINK_KIND_NRF24, "settle_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.settle_us ) },
+    { LINK_KIND_NRF24, "tx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.tx_overhead_us ) },
+    { LINK_KIND_NRF24, "rx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.rx_overhead_us ) },
+    { LINK_KIND_NRF24, "rx_delay_bits", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.rx_delay_bits ) },
+    { LINK_KIND_NRF24, "irq_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.irq_us ) },
+    { LINK_KIND_NRF24, "ard_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.ard_us ) },
+    { LINK_KIND_NRF24, "arc", LINK_SETTING_U32, offsetof( link_config_t, nrf24.arc ) },
+    { LINK_KIND_NRF24, "data_loss", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.data_loss ) },
+    { LINK_KIND_NRF24, "ack_loss", LINK_SETTING_DOUBLE, offsetof( link_config_t, nrf24.ack_loss ) },
+
+    { LINK_KIND_LORA, "bandwidth_hz", LINK_SETTING_DOUBLE, offsetof( link_config_t, lora.bandwidth_hz ) },
+    { LINK_KIND_LORA, "spreading_factor", LINK_SETTING_U32, offsetof( link_config_t, lora.spreading_factor ) },
+    { LINK_KIND_LORA, "coding_rate", LINK_SETTING_U32, offsetof( link_config_t, lora.coding_rate ) },
+    { LINK_KIND_LORA, "preamble_symbols", LINK_SETTING_U32, offsetof( link_config_t, lora.preamble_symbols ) },
+    { LINK_KIND_LORA, "crc", LINK_SETTING_BOOL, offsetof( link_config_t, lora.crc ) },
+    { LINK_KIND_LORA, "low_data_rate", LINK_SETTING_I32, offsetof( link_config_t, lora.low_data_rate ) },
+    { LINK_KIND_LORA, "packet_bytes", LINK_SETTING_U32, offsetof( link_config_t, lora.packet_bytes ) },
+    { LINK_KIND_LORA, "spi_us_per_byte", LINK_SETTING_DOUBLE, offsetof( link_config_t, lora.spi_us_per_byte ) },
+    { LINK_KIND_LORA, "tx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, lora.tx_overhead_us ) },
+    { LINK_KIND_LORA, "rx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, lora.rx_overhead_us ) },
+    { LINK_KIND_LORA, "rx_delay_symbols", LINK_SETTING_DOUBLE, offsetof( link_config_t, lora.rx_delay_symbols ) },
+
+    { LINK_KIND_BLE, "interval_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.interval_us ) },
+    { LINK_KIND_BLE, "phy_kbps", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.phy_kbps ) },
+    { LINK_KIND_BLE, "chunk_bytes", LINK_SETTING_U32, offsetof( link_config_t, ble.chunk_bytes ) },
+    { LINK_KIND_BLE, "pdu_overhead_bytes", LINK_SETTING_U32, offsetof( link_config_t, ble.pdu_overhead_bytes ) },
+    { LINK_KIND_BLE, "empty_pdu_bytes", LINK_SETTING_U32, offsetof( link_config_t, ble.empty_pdu_bytes ) },
+    { LINK_KIND_BLE, "ifs_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.ifs_us ) },
+    { LINK_KIND_BLE, "event_length_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.event_length_us ) },
+    { LINK_KIND_BLE, "lead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.lead_us ) },
+    { LINK_KIND_BLE, "packet_loss", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.packet_loss ) },
+    { LINK_KIND_BLE, "rx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ble.rx_overhead_us ) },
+
+    { LINK_KIND_802154, "packet_bytes", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.packet_bytes ) },
+    { LINK_KIND_802154, "frame_overhead_bytes", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.frame_overhead_bytes ) },
+    { LINK_KIND_802154, "csma", LINK_SETTING_BOOL, offsetof( link_config_t, ieee802154.csma ) },
+    { LINK_KIND_802154, "min_be", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.min_be ) },
+    { LINK_KIND_802154, "max_be", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.max_be ) },
+    { LINK_KIND_802154, "max_backoffs", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.max_backoffs ) },
+    { LINK_KIND_802154, "busy", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.busy ) },
+    { LINK_KIND_802154, "ack", LINK_SETTING_BOOL, offsetof( link_config_t, ieee802154.ack ) },
+    { LINK_KIND_802154, "ack_bytes", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.ack_bytes ) },
+    { LINK_KIND_802154, "ack_wait_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.ack_wait_us ) },
+    { LINK_KIND_802154, "max_retries", LINK_SETTING_U32, offsetof( link_config_t, ieee802154.max_retries ) },
+    { LINK_KIND_802154, "frame_loss", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.frame_loss ) },
+    { LINK_KIND_802154, "ack_loss", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.ack_loss ) },
+    { LINK_KIND_802154, "tx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.tx_overhead_us ) },
+    { LINK_KIND_802154, "next_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.next_overhead_us ) },
+    { LINK_KIND_802154, "ack_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.ack_overhead_us ) },
+    { LINK_KIND_802154, "rx_overhead_us", LINK_SETTING_DOUBLE, offsetof( link_config_t, ieee802154.rx_overhead_us ) },
+};
+
+#define LINK_SETTING_COUNT ( sizeof( link_settings ) / sizeof( link_settings[0] ) )
+
+static const char *const link_kind_names[LINK_KIND_COUNT] = { "uart", "nrf24", "lora", "ble", "802154" };
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void link_config_default( link_kind_t kind, link_config_t *config )
+{
+    memset( config, 0, sizeof( *config ) );
+
+    config->kind          = kind;
+    config->payload_bytes = 12;
+
+    // STM32F4 LL firmware, increasing-baudrate-tests.csv and uart-test-data.csv
+    config->uart.baud           = 115200;
+    config->uart.bits_per_byte  = 10;
+    config->uart.mode           = LINK_UART_POLL;
+    config->uart.dma_setup_us   = 2.0;
+    config->uart.dma_idle_chars = 1.0;
+    config->uart.irq_us         = 0.3;
+    config->uart.tx_overhead_us = 1.25;
+    config->uart.rx_overhead_us = 1.25;
+
+    // nrf24 firmware: 3 byte address, 2 byte CRC, ARD 1000us, ARC 5, SPI at /8
+    config->nrf24.rate_kbps       = 2000;
+    config->nrf24.address_bytes   = 3;
+    config->nrf24.crc_bytes       = 2;
+    config->nrf24.packet_bytes    = 32;
+    config->nrf24.spi_us_per_byte = 1.09;
+    config->nrf24.settle_us       = 130;
+    config->nrf24.tx_overhead_us  = 12.4;
+    config->nrf24.rx_overhead_us  = 12.4;
+    config->nrf24.rx_delay_bits   = 7;
+    config->nrf24.irq_us          = 7.6;
+    config->nrf24.ard_us          = 1000;
+    config->nrf24.arc             = 5;
+    config->nrf24.ack_loss        = 0.16;
+
+    // rfm95 firmware: 250 kHz, SF7, 4/5, 8 symbol preamble, CRC on
+    config->lora.bandwidth_hz     = 250000;
+    config->lora.spreading_factor = 7;
+    config->lora.coding_rate      = 1;
+    config->lora.preamble_symbols = 8;
+    config->lora.crc              = true;
+    config->lora.low_data_rate    = -1;
+    config->lora.packet_bytes     = 255;
+    config->lora.spi_us_per_byte  = 2.9;
+    config->lora.tx_overhead_us   = 200;
+    config->lora.rx_overhead_us   = 130;
+    config->lora.rx_delay_symbols = 0.79;
+
+    // nRF52 NUS firmware: 2M PHY, encrypted link, 197 B writes, 30 ms interval
+    config->ble.interval_us        = 30000;
+    config->ble.phy_kbps           = 2000;
+    config->ble.chunk_bytes        = 197;
+    config->ble.pdu_overhead_bytes = 22;
+    config->ble.empty_pdu_bytes    = 11;
+    config->ble.ifs_us             = 150;
+    config->ble.event_length_us    = 30000;
+    config->ble.lead_us            = 500;
+    config->ble.rx_overhead_us     = 500;
+
+    // ESP32-C6 firmware: no CCA, 116 B frames with a 9 byte MHR
+    config->ieee802154.packet_bytes         = 116;
+    config->ieee802154.frame_overhead_bytes = 17;
+    config->ieee802154.min_be               = 3;
+    config->ieee802154.max_be               = 5;
+    config->ieee802154.max_backoffs         = 4;
+    config->ieee802154.ack_bytes            = 11;
+    config->ieee802154.ack_wait_us          = 864;
+    config->ieee802154.max_retries          = 3;
+    config->ieee802154.tx_overhead_us       = 527.5;
+    config->ieee802154.next_overhead_us     = 374.5;
+    config->ieee802154.ack_overhead_us      = 475;
+    config->ieee802154.rx_overhead_us       = 527.5;
+
+    // How long the firmware takes to notice the trigger varies per stack
+    switch( kind )
+    {
+        case LINK_KIND_NRF24:
+            config->jitter_us = 1.0;
+            break;
+        case LINK_KIND_LORA:
+            config->jitter_us = 30.0;
+            break;
+        case LINK_KIND_802154:
+            config->jitter_us = 545.0;
+            break;
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool link_config_parse( const std::string &spec, link_config_t *config, std::string *error )
+{
+    const size_t      colon = spec.find( ':' );
+    const std::string name  = spec.substr( 0, colon );
+    link_kind_t       kind  = LINK_KIND_COUNT;
+
+    for( uint32_t k = 0; k < LINK_KIND_COUNT; k++ )
+    {
+        if( name == link_kind_names[k] )
+        {
+            kind = (link_kind_t)k;
+        }
+    }
+
+    if( kind == LINK_KIND_COUNT )
+    {
+        *error = "unknown link '" + name + "', expected uart, nrf24, lora, ble or 802154";
+        return false;
+    }
+
+    link_config_default( kind, config );
+
+    if( colon == std::string::npos )
+    {
+        return true;
+    }
+
+    size_t start = colon + 1;
+
+    while( start <= spec.size() )
+    {
+        size_t end = spec.find( ',', start );
+
+        if( end == std::string::npos )
+        {
+            end = spec.size();
+        }
+
+        const std::string pair   = spec.substr( start, end - start );
+        const size_t      equals = pair.find( '=' );
+        bool              found  = false;
+
+        if( equals == std::string::npos )
+        {
+            *error = "expected key=value, got '" + pair + "'";
+            return false;
+        }
+
+        const std::string key   = pair.substr( 0, equals );
+        const std::string value = pair.substr( equals + 1 );
+
+        for( size_t i = 0; i < LINK_SETTING_COUNT && !found; i++ )
+        {
+            const link_setting_t *setting = &link_settings[i];
+
+            if( ( setting->kind == kind || setting->kind == LINK_KIND_COUNT ) && key == setting->key )
+            {
+                if( !link_setting_set( setting, config, value ) )
+                {
+                    *error = "bad value for " + key + ": '" + value + "'";
+                    return false;
+                }
+
+                found = true;
+            }
+        }
+
+        if( !found )
+        {
+            *error = "unknown " + name + " setting '" + key + "'";
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void link_config_describe( const link_config_t &config, std::vector<std::string> *lines )
+{
+    lines->clear();
+
+    for( size_t i = 0; i < LINK_SETTING_COUNT; i++ )
+    {
+        const link_setting_t *setting = &link_settings[i];
+
+        if( setting->kind == config.kind || setting->kind == LINK_KIND_COUNT )
+        {
+            lines->push_back( std::string( setting->key ) + "=" + link_setting_get( setting, config ) );
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool link_config_has( link_kind_t kind, const std::string &key )
+{
+    for( size_t i = 0; i < LINK_SETTING_COUNT; i++ )
+    {
+        if( ( link_settings[i].kind == kind || link_settings[i].kind == LINK_KIND_COUNT ) && key == link_settings[i].key )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const char *link_kind_name( link_kind_t kind )
+{
+    return ( kind < LINK_KIND_COUNT ) ? link_kind_names[kind] : "unknown";
+}
+
+/* -------------------------------------------------------------------------- */
+
+void link_sim_init( link_sim_t *sim, const link_config_t *config, uint64_t seed )
+{
+    uint64_t state = seed;
+
+    sim->config = config;
+    sim->model  = link_model_for( config->kind );
+    sim->queue.clear();
+    sim->queue.reserve( 16 );
+
+    for( int i = 0; i < 4; i++ )
+    {
+        sim->rng[i] = link_splitmix64( &state );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+double link_sim_trigger( link_sim_t *sim )
+{
+    sim->queue.clear();
+    sim->order     = 0;
+    sim->delivered = false;
+    sim->offset    = 0;
+    sim->attempt   = 0;
+    sim->backoffs  = 0;
+    sim->exponent  = 0;
+    sim->received  = false;
+
+    // The trigger edge is time zero
+    sim->now_us = ( sim->config->jitter_us > 0.0 ) ? link_sim_uniform( sim ) * sim->config->jitter_us : 0.0;
+
+    sim->model->trigger( sim );
+
+    while( !sim->queue.empty() )
+    {
+        std::pop_heap( sim->queue.begin(), sim->queue.end(), link_event_later );
+
+        const link_event_t event = sim->queue.back();
+        sim->queue.pop_back();
+        sim->now_us = event.time_us;
+
+        if( event.kind == LINK_EVENT_DELIVER )
+        {
+            sim->delivered    = true;
+            sim->delivered_us = sim->now_us;
+            return sim->now_us;
+        }
+
+        sim->model->handle( sim, &event );
+    }
+
+    // Nothing left to happen, the frame was lost
+    return NAN;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void link_sim_run( const link_config_t &config, uint64_t triggers, uint64_t seed, std::vector<double> *latencies_ms )
+{
+    link_sim_t sim;
+
+    link_sim_init( &sim, &config, seed );
+    latencies_ms->reserve( latencies_ms->size() + triggers );
+
+    for( uint64_t i = 0; i < triggers; i++ )
+    {
+        latencies_ms->push_back( link_sim_trigger( &sim ) / 1000.0 );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void link_sim_schedule( link_sim_t *sim, double delay_us, uint16_t kind, uint16_t arg )
+{
+    sim->queue.push_back( { sim->now_us + delay_us, sim->order++, kind, arg } );
+    std::push_heap( sim->queue.begin(), sim->queue.end(), link_event_later );
+}
+
+/* -------------------------------------------------------------------------- */
+
+double link_sim_uniform( link_sim_t *sim )
+{
+    // Top 53 bits, exactly representable
+    return (double)( link_rng_next( sim ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool link_sim_chance( link_sim_t *sim, double p )
+{
+    return p > 0.0 && link_sim_uniform( sim ) < p;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t link_sim_below( link_sim_t *sim, uint32_t range )
+{
+    // Lemire's multiply-shift, the bias is far below anything simulated here
+    return (uint32_t)( ( ( link_rng_next( sim ) >> 32 ) * range ) >> 32 );
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static bool link_setting_set( const link_setting_t *setting, link_config_t *config, const std::string &value )
+{
+    uint8_t    *field = (uint8_t *)config + setting->offset;
+    const char *text  = value.c_str();
+    char       *end   = nullptr;
+
+    switch( setting->type )
+    {
+        case LINK_SETTING_DOUBLE:
+            *(double *)field = strtod( text, &end );
+            break;
+        case LINK_SETTING_U32:
+            *(uint32_t *)field = (uint32_t)strtoul( text, &end, 10 );
+            break;
+        case LINK_SETTING_I32:
+            *(int32_t *)field = (int32_t)strtol( text, &end, 10 );
+            break;
+        case LINK_SETTING_BOOL:
+            if( value != "0" && value != "1" )
+            {
+                return false;
+            }
+
+            *(bool *)field = ( value == "1" );
+            return true;
+        case LINK_SETTING_UART_MODE:
+            if( value == "poll" )
+            {
+                *(link_uart_mode_t *)field = LINK_UART_POLL;
+            }
+            else if( value == "irq" )
+            {
+                *(link_uart_mode_t *)field = LINK_UART_IRQ;
+            }
+            else if( value == "dma" )
+            {
+                *(link_uart_mode_t *)field = LINK_UART_DMA;
+            }
+            else
+            {
+                return false;
+            }
+
+            return true;
+    }
+
+    return end && end != text && *end == '\0';
+}
+
+/* -------------------------------------------------------------------------- */
+
+static std::string link_setting_get( const link_setting_t *setting, const link_config_t &config )
+{
+    const uint8_t *field = (const uint8_t *)&config + setting->offset;
+    char           text[32];
+
+    switch( setting->type )
+    {
+        case LINK_SETTING_DOUBLE:
+            snprintf( text, sizeof( text ), "%g", *(const double *)field );
+            break;
+        case LINK_SETTING_U32:
+            snprintf( text, sizeof( text ), "%u", *(const uint32_t *)field );
+            break;
+        case LINK_SETTING_I32:
+            snprintf( text, sizeof( text ), "%d", *(const int32_t *)field );
+            break;
+        case LINK_SETTING_BOOL:
+            snprintf( text, sizeof( text ), "%d", *(const bool *)field ? 1 : 0 );
+            break;
+        case LINK_SETTING_UART_MODE:
+        {
+            static const char *const modes[] = { "poll", "irq", "dma" };
+            snprintf( text, sizeof( text ), "%s", modes[*(const link_uart_mode_t *)field] );
+            break;
+        }
+    }
+
+    return text;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Heap order, the earliest event on top
+static bool link_event_later( const link_event_t &a, const link_event_t &b )
+{
+    return ( a.time_us > b.time_us ) || ( a.time_us == b.time_us && a.order > b.order );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t link_splitmix64( uint64_t *state )
+{
+    uint64_t z = ( *state += 0x9E3779B97F4A7C15ull );
+
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+
+    return z ^ ( z >> 31 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// xoshiro256**, same generator as the bootstrap
+static uint64_t link_rng_next( link_sim_t *sim )
+{
+    uint64_t      *s      = sim->rng;
+    const uint64_t x      = s[1] * 5;
+    const uint64_t result = ( ( x << 7 ) | ( x >> 57 ) ) * 9;
+    const uint64_t t      = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = ( s[3] << 45 ) | ( s[3] >> 19 );
+
+    return result;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,253 @@
+#ifndef LINK_SIM_H
+#define LINK_SIM_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef enum
+{
+    LINK_KIND_UART,
+    LINK_KIND_NRF24,
+    LINK_KIND_LORA,
+    LINK_KIND_BLE,
+    LINK_KIND_802154,
+    LINK_KIND_COUNT,
+} link_kind_t;
+
+typedef enum
+{
+    LINK_UART_POLL,
+    LINK_UART_IRQ,
+    LINK_UART_DMA,
+} link_uart_mode_t;
+
+// Wired UART between two boards, 8N1 by default
+typedef struct
+{
+    double           baud;
+    double           bits_per_byte;
+    link_uart_mode_t mode;
+    uint32_t         dma_chunk;         // bytes per TX DMA transfer, 0 for one transfer
+    double           dma_setup_us;      // before each TX DMA transfer
+    double           dma_idle_chars;    // RX idle line detection after the last byte
+    double           irq_us;            // extra for IRQ driven transfers
+    double           tx_overhead_us;    // trigger to first start bit
+    double           rx_overhead_us;    // last stop bit to the done edge
+} link_uart_t;
+
+// nRF24L01+ Enhanced ShockBurst with auto ACK
+typedef struct
+{
+    double   rate_kbps;                 // 250, 1000 or 2000
+    uint32_t address_bytes;
+    uint32_t crc_bytes;
+    uint32_t packet_bytes;              // payload per packet, 32 at most
+    bool     padded;                    // fixed width pipe, short packets go out full size
+    double   spi_us_per_byte;
+    double   settle_us;                 // standby to TX/RX, and the PRX turnaround for the ACK
+    double   tx_overhead_us;            // per packet, before the payload is loaded
+    double   rx_overhead_us;
+    double   rx_delay_bits;             // end of packet to the RX_DR interrupt
+    double   irq_us;                    // TX_DS handling before the next packet
+    double   ard_us;                    // auto retransmit delay
+    uint32_t arc;                       // auto retransmit count
+    double   data_loss;                 // per attempt
+    double   ack_loss;
+} link_nrf24_t;
+
+// SX127x LoRa, explicit header
+typedef struct
+{
+    double   bandwidth_hz;
+    uint32_t spreading_factor;          // 7-12
+    uint32_t coding_rate;               // 1-4 for 4/5-4/8
+    uint32_t preamble_symbols;          // programmed length, 4.25 more are added
+    bool     crc;
+    int32_t  low_data_rate;             // 1 on, 0 off, -1 when symbols exceed 16 ms
+    uint32_t packet_bytes;              // payload per packet, 255 at most
+    double   spi_us_per_byte;
+    double   tx_overhead_us;            // per packet
+    double   rx_overhead_us;
+    double   rx_delay_symbols;          // end of packet to RxDone
+} link_lora_t;
+
+// BLE GATT writes or notifications, quantised to connection events
+typedef struct
+{
+    double   interval_us;
+    double   phy_kbps;                  // 1000 or 2000
+    uint32_t chunk_bytes;               // ATT payload per write or notification
+    uint32_t pdu_overhead_bytes;        // preamble, access address, header, L2CAP, ATT, MIC, CRC
+    uint32_t empty_pdu_bytes;           // the peer's reply
+    double   ifs_us;
+    double   event_length_us;           // connection event budget
+    double   lead_us;                   // data must be queued this long before an event
+    double   packet_loss;               // per PDU, retried in the same event
+    double   rx_overhead_us;
+} link_ble_t;
+
+// IEEE 802.15.4 O-QPSK at 250 kbps
+typedef struct
+{
+    uint32_t packet_bytes;              // payload per frame
+    uint32_t frame_overhead_bytes;      // SHR, PHR, MHR and FCS
+    bool     csma;                      // unslotted CSMA-CA before each frame
+    uint32_t min_be;
+    uint32_t max_be;
+    uint32_t max_backoffs;
+    double   busy;                      // chance a CCA finds the channel busy
+    bool     ack;
+    uint32_t ack_bytes;                 // on air
+    double   ack_wait_us;
+    uint32_t max_retries;
+    double   frame_loss;
+    double   ack_loss;
+    double   tx_overhead_us;            // trigger to the first frame
+    double   next_overhead_us;          // TX done to the next frame
+    double   ack_overhead_us;           // extra for a TX done after an ACK
+    double   rx_overhead_us;
+} link_802154_t;
+
+typedef struct
+{
+    link_kind_t   kind;
+    uint32_t      payload_bytes;        // per trigger
+    double        jitter_us;            // uniform, before the trigger is acted on
+    link_uart_t   uart;
+    link_nrf24_t  nrf24;
+    link_lora_t   lora;
+    link_ble_t    ble;
+    link_802154_t ieee802154;
+} link_config_t;
+
+typedef struct
+{
+    double   time_us;
+    uint32_t order;                     // ties run in the order scheduled
+    uint16_t kind;
+    uint16_t arg;
+} link_event_t;
+
+typedef struct link_sim_s link_sim_t;
+
+// A link model is a pair of callbacks, one to start a trigger and one for
+// the events it schedules. Models keep per-trigger progress in the sim.
+typedef struct
+{
+    const char *name;
+    void ( *trigger )( link_sim_t *sim );
+    void ( *handle )( link_sim_t *sim, const link_event_t *event );
+} link_model_t;
+
+struct link_sim_s
+{
+    const link_config_t      *config;
+    const link_model_t       *model;
+    std::vector<link_event_t> queue;    // binary min heap on time
+    uint32_t                  order;
+    double                    now_us;
+    double                    delivered_us;
+    bool                      delivered;
+    uint32_t                  offset;   // bytes the sender is done with
+    uint32_t                  attempt;
+    uint32_t                  backoffs;
+    uint32_t                  exponent;
+    bool                      received; // the current packet reached the receiver
+    uint64_t                  rng[4];
+};
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Event kinds below this are the core's, models number theirs from here
+#define LINK_EVENT_DELIVER (0u)
+#define LINK_EVENT_MODEL   (1u)
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** The calibrated defaults for a kind, see link-sim-validate */
+
+void link_config_default( link_kind_t kind, link_config_t *config );
+
+/* -------------------------------------------------------------------------- */
+
+/** Parses "kind:key=value,..." e.g. "nrf24:rate_kbps=250,payload_bytes=128"
+ *  on top of the kind's defaults. Booleans are 0 or 1, the UART mode is
+ *  poll, irq or dma.
+ */
+
+bool link_config_parse( const std::string &spec, link_config_t *config, std::string *error );
+
+/* -------------------------------------------------------------------------- */
+
+/** One "key=value" line per setting of config's kind */
+
+void link_config_describe( const link_config_t &config, std::vector<std::string> *lines );
+
+/* -------------------------------------------------------------------------- */
+
+/** Whether kind has a setting called key, payload_bytes and jitter_us always */
+
+bool link_config_has( link_kind_t kind, const std::string &key );
+
+/* -------------------------------------------------------------------------- */
+
+const char *link_kind_name( link_kind_t kind );
+
+/* -------------------------------------------------------------------------- */
+
+void link_sim_init( link_sim_t *sim, const link_config_t *config, uint64_t seed );
+
+/* -------------------------------------------------------------------------- */
+
+/** Runs one trigger to completion. Returns the trigger to done edge latency
+ *  in us, or NaN when the frame never arrived.
+ */
+
+double link_sim_trigger( link_sim_t *sim );
+
+/* -------------------------------------------------------------------------- */
+
+/** Simulates triggers one after another and appends their latencies (ms,
+ *  NaN when lost) to latencies_ms. Results only depend on the seed.
+ */
+
+void link_sim_run( const link_config_t &config, uint64_t triggers, uint64_t seed, std::vector<double> *latencies_ms );
+
+/* -------------------------------------------------------------------------- */
+
+/** For models: queues an event delay_us from now */
+
+void link_sim_schedule( link_sim_t *sim, double delay_us, uint16_t kind, uint16_t arg );
+
+/* -------------------------------------------------------------------------- */
+
+/** For models: uniform in [0, 1) */
+
+double link_sim_uniform( link_sim_t *sim );
+
+/* -------------------------------------------------------------------------- */
+
+/** For models: true with probability p */
+
+bool link_sim_chance( link_sim_t *sim, double p );
+
+/* -------------------------------------------------------------------------- */
+
+/** For models: uniform in [0, range) */
+
+uint32_t link_sim_below( link_sim_t *sim, uint32_t range );
+
+/* -------------------------------------------------------------------------- */
+
+/** The model for each kind, defined in link_models.cpp */
+
+const link_model_t *link_model_for( link_kind_t kind );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LINK_SIM_H */
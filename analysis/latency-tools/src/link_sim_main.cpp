@@ -0,0 +1,162 @@
+/* -------------------------------------------------------------------------- */
+
+// Simulates the trigger to done edge latency of a link from a handful of
+// timing parameters, to try out settings (packet sizes, baud rates, ACKs...)
+// before flashing them. Each spec is a link kind plus overrides of its
+// calibrated defaults, e.g. "nrf24:rate_kbps=250,payload_bytes=128".
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+#include "latency_stats.h"
+#include "link_sim.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define LINK_SIM_DEFAULT_TRIGGERS (1000000u)
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    std::string              output;
+    uint64_t                 triggers = LINK_SIM_DEFAULT_TRIGGERS;
+    uint64_t                 seed     = 1;
+    bool                     describe = false;
+    std::vector<std::string> specs;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-n" ) == 0 && i + 1 < argc )
+        {
+            triggers = strtoull( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+        {
+            seed = strtoull( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-v" ) == 0 )
+        {
+            describe = true;
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            specs.push_back( argv[i] );
+        }
+    }
+
+    if( specs.empty() || !triggers )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    std::vector<link_config_t> configs( specs.size() );
+
+    for( size_t i = 0; i < specs.size(); i++ )
+    {
+        std::string error;
+
+        if( !link_config_parse( specs[i], &configs[i], &error ) )
+        {
+            fprintf( stderr, "%s: %s\n", specs[i].c_str(), error.c_str() );
+            return 1;
+        }
+    }
+
+    std::vector<latency_column_t> columns;
+
+    printf( "%-40s %10s %10s %10s %10s %8s %10s\n", "link", "p50 ms", "p90 ms", "p99 ms", "max ms", "lost", "M trig/s" );
+
+    for( size_t i = 0; i < specs.size(); i++ )
+    {
+        const std::string   &spec   = specs[i];
+        const link_config_t &config = configs[i];
+        latency_column_t     column = { spec, {} };
+
+        const auto started = std::chrono::steady_clock::now();
+
+        link_sim_run( config, triggers, seed, &column.values );
+
+        const double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - started ).count();
+
+        latency_stats_t   stats;
+        latency_summary_t summary;
+
+        latency_stats_init( &stats, 0 );
+
+        for( double ms : column.values )
+        {
+            latency_stats_add( &stats, ms );
+        }
+
+        latency_stats_summarise( &stats, &summary );
+
+        printf( "%-40s %10.4f %10.4f %10.4f %10.4f %8llu %10.2f\n",
+                spec.c_str(),
+                summary.p50,
+                summary.p90,
+                summary.p99,
+                summary.max,
+                (unsigned long long)( triggers - summary.count ),
+                (double)triggers / elapsed_s / 1e6 );
+
+        if( describe )
+        {
+            std::vector<std::string> lines;
+
+            link_config_describe( config, &lines );
+
+            for( const std::string &line : lines )
+            {
+                printf( "    %s\n", line.c_str() );
+            }
+        }
+
+        columns.push_back( std::move( column ) );
+    }
+
+    if( !output.empty() && !latency_columns_write_csv( output.c_str(), columns ) )
+    {
+        fprintf( stderr, "Failed to write %s\n", output.c_str() );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-n triggers] [-s seed] [-v] [-o sim_df.csv] kind[:key=value,...] ...\n", name );
+    printf( "Kinds are uart, nrf24, lora, ble and 802154, each starting from the\n" );
+    printf( "settings calibrated against the captures in analysis/. -v lists every\n" );
+    printf( "setting of a spec, -o writes one column of latencies (ms) per spec with\n" );
+    printf( "NA for lost frames. Default %u triggers, seed 1.\n", LINK_SIM_DEFAULT_TRIGGERS );
+}
+
+/* -------------------------------------------------------------------------- */
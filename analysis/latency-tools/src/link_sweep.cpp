@@ -0,0 +1,335 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_stats.h"
+#include "link_sweep.h"
+#include "thread_pool.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Keeps a typo in a range from expanding into millions of points
+#define LINK_SWEEP_MAX_AXIS_VALUES (10000u)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool link_sweep_parse_range( const std::string &range, link_sweep_axis_t *axis, std::string *error );
+static void link_sweep_simulate( link_sweep_point_t *point, uint64_t triggers, uint64_t seed );
+static bool link_sweep_dominates( const link_sweep_point_t &a, const link_sweep_point_t &b, link_sweep_metric_t metric );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool link_sweep_parse_axis( const std::string &text, link_sweep_axis_t *axis, std::string *error )
+{
+    const size_t equals = text.find( '=' );
+
+    axis->key.clear();
+    axis->values.clear();
+
+    if( equals == std::string::npos || equals == 0 || equals + 1 == text.size() )
+    {
+        *error = "expected key=values, got '" + text + "'";
+        return false;
+    }
+
+    axis->key = text.substr( 0, equals );
+
+    const std::string values = text.substr( equals + 1 );
+
+    if( values.find( ':' ) != std::string::npos )
+    {
+        return link_sweep_parse_range( values, axis, error );
+    }
+
+    size_t start = 0;
+
+    while( start <= values.size() )
+    {
+        size_t end = values.find( ',', start );
+
+        if( end == std::string::npos )
+        {
+            end = values.size();
+        }
+
+        if( end == start )
+        {
+            *error = "empty value in '" + text + "'";
+            return false;
+        }
+
+        axis->values.push_back( values.substr( start, end - start ) );
+        start = end + 1;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool link_sweep_expand( const std::vector<std::string>       &bases,
+                        const std::vector<link_sweep_axis_t> &axes,
+                        std::vector<link_sweep_point_t>      *points,
+                        std::string                          *error )
+{
+    std::vector<bool> applied( axes.size(), false );
+
+    points->clear();
+
+    for( const std::string &base : bases )
+    {
+        link_config_t config;
+
+        if( !link_config_parse( base, &config, error ) )
+        {
+            *error = base + ": " + *error;
+            return false;
+        }
+
+        std::vector<const link_sweep_axis_t *> used;
+
+        for( size_t a = 0; a < axes.size(); a++ )
+        {
+            if( link_config_has( config.kind, axes[a].key ) )
+            {
+                used.push_back( &axes[a] );
+                applied[a] = true;
+            }
+        }
+
+        // Odometer over the axes this kind has, the last one turning fastest
+        std::vector<size_t> index( used.size(), 0 );
+
+        for( ;; )
+        {
+            link_sweep_point_t point;
+            std::string        spec = base;
+
+            for( size_t a = 0; a < used.size(); a++ )
+            {
+                spec += ( spec.find( ':' ) == std::string::npos ) ? ":" : ",";
+                spec += used[a]->key + "=" + used[a]->values[index[a]];
+            }
+
+            if( !link_config_parse( spec, &point.config, error ) )
+            {
+                *error = spec + ": " + *error;
+                return false;
+            }
+
+            point.spec      = spec;
+            point.triggers  = 0;
+            point.delivered = 0;
+            point.p50       = NAN;
+            point.p90       = NAN;
+            point.p99       = NAN;
+            point.max       = NAN;
+            point.frontier  = false;
+            points->push_back( point );
+
+            size_t a = used.size();
+
+            while( a > 0 && ++index[a - 1] == used[a - 1]->values.size() )
+            {
+                index[--a] = 0;
+            }
+
+            if( a == 0 )
+            {
+                break;
+            }
+        }
+    }
+
+    // Most likely a typo
+    for( size_t a = 0; a < axes.size(); a++ )
+    {
+        if( !applied[a] )
+        {
+            *error = "none of the links has a setting called '" + axes[a].key + "'";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void link_sweep_run( std::vector<link_sweep_point_t> *points, uint64_t triggers, uint64_t seed, uint32_t worker_count )
+{
+    thread_pool_t pool;
+
+    thread_pool_start( &pool, worker_count );
+
+    // One task per point, the sims are independent and the expensive ones
+    // get spread out by the work stealing
+    for( size_t i = 0; i < points->size(); i++ )
+    {
+        link_sweep_point_t *point = &( *points )[i];
+
+        thread_pool_submit( &pool, [point, triggers, seed, i] { link_sweep_simulate( point, triggers, seed + i ); } );
+    }
+
+    thread_pool_stop( &pool );
+}
+
+/* -------------------------------------------------------------------------- */
+
+void link_sweep_frontier( std::vector<link_sweep_point_t> *points, link_sweep_metric_t metric, bool per_kind )
+{
+    // Grids are at most a few thousand points, the pairwise check is fine
+    for( link_sweep_point_t &point : *points )
+    {
+        point.frontier = !isnan( link_sweep_latency( point, metric ) );
+
+        for( size_t j = 0; j < points->size() && point.frontier; j++ )
+        {
+            const link_sweep_point_t &other = ( *points )[j];
+
+            if( ( !per_kind || other.config.kind == point.config.kind ) && link_sweep_dominates( other, point, metric ) )
+            {
+                point.frontier = false;
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+double link_sweep_latency( const link_sweep_point_t &point, link_sweep_metric_t metric )
+{
+    switch( metric )
+    {
+        case LINK_SWEEP_P50:
+            return point.p50;
+        case LINK_SWEEP_P90:
+            return point.p90;
+        case LINK_SWEEP_P99:
+            return point.p99;
+        case LINK_SWEEP_MAX:
+            return point.max;
+    }
+
+    return NAN;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static bool link_sweep_parse_range( const std::string &range, link_sweep_axis_t *axis, std::string *error )
+{
+    const char *text = range.c_str();
+    char       *end  = nullptr;
+
+    const double from = strtod( text, &end );
+
+    if( end == text || *end != ':' )
+    {
+        *error = "expected from:to:step, got '" + range + "'";
+        return false;
+    }
+
+    text = end + 1;
+
+    const double to = strtod( text, &end );
+
+    if( end == text || *end != ':' )
+    {
+        *error = "expected from:to:step, got '" + range + "'";
+        return false;
+    }
+
+    text = end + 1;
+
+    const bool   geometric = ( *text == '*' );
+    const char  *start     = geometric ? text + 1 : text;
+    const double step      = strtod( start, &end );
+
+    if( end == start || *end != '\0' || ( geometric ? !( step > 1.0 ) : !( step > 0.0 ) ) || to < from )
+    {
+        *error = "bad range '" + range + "', the step must move from up to to";
+        return false;
+    }
+
+    // Index based, so rounding doesn't accumulate over a long range
+    for( uint32_t i = 0;; i++ )
+    {
+        const double value = geometric ? from * pow( step, (double)i ) : from + step * (double)i;
+
+        if( value > to * ( 1.0 + 1e-9 ) )
+        {
+            break;
+        }
+
+        if( axis->values.size() == LINK_SWEEP_MAX_AXIS_VALUES )
+        {
+            *error = "range '" + range + "' has too many values";
+            return false;
+        }
+
+        char formatted[32];
+        snprintf( formatted, sizeof( formatted ), "%.10g", value );
+        axis->values.push_back( formatted );
+    }
+
+    return !axis->values.empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void link_sweep_simulate( link_sweep_point_t *point, uint64_t triggers, uint64_t seed )
+{
+    link_sim_t        sim;
+    latency_stats_t   stats;
+    latency_summary_t summary;
+
+    // Histogram rather than the raw latencies, big grids stay small in memory
+    latency_stats_init( &stats, 0 );
+    link_sim_init( &sim, &point->config, seed );
+
+    for( uint64_t i = 0; i < triggers; i++ )
+    {
+        latency_stats_add( &stats, link_sim_trigger( &sim ) / 1000.0 );
+    }
+
+    point->triggers  = triggers;
+    point->delivered = stats.count;
+
+    if( stats.count )
+    {
+        latency_stats_summarise( &stats, &summary );
+
+        point->p50 = summary.p50;
+        point->p90 = summary.p90;
+        point->p99 = summary.p99;
+        point->max = summary.max;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool link_sweep_dominates( const link_sweep_point_t &a, const link_sweep_point_t &b, link_sweep_metric_t metric )
+{
+    const double a_latency = link_sweep_latency( a, metric );
+    const double b_latency = link_sweep_latency( b, metric );
+
+    if( isnan( a_latency ) )
+    {
+        return false;
+    }
+
+    // Cross multiplied delivered fractions, exact for any trigger counts
+    const double a_delivered = (double)a.delivered * (double)b.triggers;
+    const double b_delivered = (double)b.delivered * (double)a.triggers;
+
+    const bool no_worse = a_latency <= b_latency && a.config.payload_bytes >= b.config.payload_bytes && a_delivered >= b_delivered;
+    const bool better   = a_latency < b_latency || a.config.payload_bytes > b.config.payload_bytes || a_delivered > b_delivered;
+
+    return no_worse && better;
+}
+
+/* ----- End ---------------------------------------------------------------- */
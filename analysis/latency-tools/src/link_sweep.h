@@ -0,0 +1,88 @@
+#ifndef LINK_SWEEP_H
+#define LINK_SWEEP_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "link_sim.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+// One setting and the values it takes across the grid
+typedef struct
+{
+    std::string              key;
+    std::vector<std::string> values;
+} link_sweep_axis_t;
+
+typedef struct
+{
+    std::string   spec;         // base spec plus this point's settings
+    link_config_t config;
+    uint64_t      triggers;
+    uint64_t      delivered;
+    double        p50;          // ms, NaN when nothing arrived
+    double        p90;
+    double        p99;
+    double        max;
+    bool          frontier;     // no other point is at least as good on every axis
+} link_sweep_point_t;
+
+typedef enum
+{
+    LINK_SWEEP_P50,
+    LINK_SWEEP_P90,
+    LINK_SWEEP_P99,
+    LINK_SWEEP_MAX,
+} link_sweep_metric_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Parses "key=a,b,c", "key=from:to:step" or "key=from:to:*factor", the
+ *  last two inclusive of to when the steps land on it.
+ */
+
+bool link_sweep_parse_axis( const std::string &text, link_sweep_axis_t *axis, std::string *error );
+
+/* -------------------------------------------------------------------------- */
+
+/** Every combination of the axes for each base spec, in order. Axes a kind
+ *  doesn't have are skipped for that kind, so one grid can cover several
+ *  links, but every axis has to apply to at least one of them.
+ */
+
+bool link_sweep_expand( const std::vector<std::string>       &bases,
+                        const std::vector<link_sweep_axis_t> &axes,
+                        std::vector<link_sweep_point_t>      *points,
+                        std::string                          *error );
+
+/* -------------------------------------------------------------------------- */
+
+/** Simulates every point across worker_count threads (0 for one per hardware
+ *  thread). Point i always uses seed + i, so results don't depend on the
+ *  scheduling.
+ */
+
+void link_sweep_run( std::vector<link_sweep_point_t> *points, uint64_t triggers, uint64_t seed, uint32_t worker_count );
+
+/* -------------------------------------------------------------------------- */
+
+/** Marks the points on the Pareto frontier of latency (lower is better)
+ *  against payload size and delivered fraction (higher is better), either
+ *  across every link or separately for each kind.
+ */
+
+void link_sweep_frontier( std::vector<link_sweep_point_t> *points, link_sweep_metric_t metric, bool per_kind );
+
+/* -------------------------------------------------------------------------- */
+
+double link_sweep_latency( const link_sweep_point_t &point, link_sweep_metric_t metric );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* LINK_SWEEP_H */
@@ -0,0 +1,269 @@
+/* -------------------------------------------------------------------------- */
+
+// Runs the link simulator over a grid of settings on every core and prints
+// the Pareto frontier of latency against payload size and delivered
+// fraction, to shortlist radio settings before putting them on the bench.
+//
+//   link-sweep nrf24 lora payload_bytes=12,128,1024 rate_kbps=250,1000,2000
+//              spreading_factor=7:12:1
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "link_sweep.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define LINK_SWEEP_DEFAULT_TRIGGERS (100000u)
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool is_axis( const std::string &arg );
+static bool write_points( FILE *f, const std::vector<link_sweep_point_t> &points );
+static void print_value( FILE *f, double value );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    const char                    *output   = 0;
+    uint64_t                       triggers = LINK_SWEEP_DEFAULT_TRIGGERS;
+    uint64_t                       seed     = 1;
+    uint32_t                       workers  = 0;
+    link_sweep_metric_t            metric   = LINK_SWEEP_P99;
+    bool                           per_kind = false;
+    std::vector<std::string>       bases;
+    std::vector<link_sweep_axis_t> axes;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-n" ) == 0 && i + 1 < argc )
+        {
+            triggers = strtoull( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+        {
+            seed = strtoull( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-j" ) == 0 && i + 1 < argc )
+        {
+            workers = (uint32_t)strtoul( argv[++i], 0, 10 );
+        }
+        else if( strcmp( argv[i], "-m" ) == 0 && i + 1 < argc )
+        {
+            const std::string name = argv[++i];
+
+            if( name == "p50" )
+            {
+                metric = LINK_SWEEP_P50;
+            }
+            else if( name == "p90" )
+            {
+                metric = LINK_SWEEP_P90;
+            }
+            else if( name == "p99" )
+            {
+                metric = LINK_SWEEP_P99;
+            }
+            else if( name == "max" )
+            {
+                metric = LINK_SWEEP_MAX;
+            }
+            else
+            {
+                fprintf( stderr, "Unknown metric %s, expected p50, p90, p99 or max\n", name.c_str() );
+                return 1;
+            }
+        }
+        else if( strcmp( argv[i], "-k" ) == 0 )
+        {
+            per_kind = true;
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else if( is_axis( argv[i] ) )
+        {
+            link_sweep_axis_t axis;
+            std::string       error;
+
+            if( !link_sweep_parse_axis( argv[i], &axis, &error ) )
+            {
+                fprintf( stderr, "%s\n", error.c_str() );
+                return 1;
+            }
+
+            axes.push_back( axis );
+        }
+        else
+        {
+            bases.push_back( argv[i] );
+        }
+    }
+
+    if( bases.empty() || !triggers )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    std::vector<link_sweep_point_t> points;
+    std::string                     error;
+
+    if( !link_sweep_expand( bases, axes, &points, &error ) )
+    {
+        fprintf( stderr, "%s\n", error.c_str() );
+        return 1;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+
+    link_sweep_run( &points, triggers, seed, workers );
+
+    const double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - started ).count();
+
+    link_sweep_frontier( &points, metric, per_kind );
+
+    printf( "%zu points, %llu triggers each, %.2f s (%.2f M triggers/s)\n\n",
+            points.size(),
+            (unsigned long long)triggers,
+            elapsed_s,
+            (double)points.size() * (double)triggers / elapsed_s / 1e6 );
+
+    // Frontier by kind when split, then by payload and latency
+    std::vector<const link_sweep_point_t *> frontier;
+
+    for( const link_sweep_point_t &point : points )
+    {
+        if( point.frontier )
+        {
+            frontier.push_back( &point );
+        }
+    }
+
+    std::stable_sort( frontier.begin(),
+                      frontier.end(),
+                      [metric, per_kind]( const link_sweep_point_t *a, const link_sweep_point_t *b ) {
+                          if( per_kind && a->config.kind != b->config.kind )
+                          {
+                              return a->config.kind < b->config.kind;
+                          }
+
+                          if( a->config.payload_bytes != b->config.payload_bytes )
+                          {
+                              return a->config.payload_bytes < b->config.payload_bytes;
+                          }
+
+                          return link_sweep_latency( *a, metric ) < link_sweep_latency( *b, metric );
+                      } );
+
+    printf( "%-56s %8s %10s %10s %10s %10s\n", "frontier", "payload", "p50 ms", "p99 ms", "max ms", "delivered" );
+
+    for( const link_sweep_point_t *point : frontier )
+    {
+        printf( "%-56s %8u %10.4f %10.4f %10.4f %9.4f%%\n",
+                point->spec.c_str(),
+                point->config.payload_bytes,
+                point->p50,
+                point->p99,
+                point->max,
+                100.0 * (double)point->delivered / (double)point->triggers );
+    }
+
+    if( output )
+    {
+        FILE *f = fopen( output, "wb" );
+
+        if( !f || !write_points( f, points ) || fclose( f ) != 0 )
+        {
+            fprintf( stderr, "Failed to write %s\n", output );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-n triggers] [-s seed] [-j threads] [-m p50|p90|p99|max] [-k] [-o sweep.csv] spec ... axis ...\n", name );
+    printf( "Specs are link-sim specs (kind[:key=value,...]) to start from. Axes are\n" );
+    printf( "key=a,b,c, key=from:to:step or key=from:to:*factor, and every spec is run\n" );
+    printf( "for every combination of the axes its kind has. Prints the points no other\n" );
+    printf( "point beats on latency (-m, default p99), payload size and delivered\n" );
+    printf( "fraction at once, -k keeps a separate frontier per link kind. -o writes\n" );
+    printf( "every point, frontier or not, as a csv row.\n" );
+    printf( "Default %u triggers per point.\n", LINK_SWEEP_DEFAULT_TRIGGERS );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Axes are key=..., specs start with a kind and only have '=' after the ':'
+static bool is_axis( const std::string &arg )
+{
+    const size_t equals = arg.find( '=' );
+
+    return equals != std::string::npos && arg.substr( 0, equals ).find( ':' ) == std::string::npos;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_points( FILE *f, const std::vector<link_sweep_point_t> &points )
+{
+    fputs( "\"spec\",\"kind\",\"payload_bytes\",\"triggers\",\"delivered\",\"median\",\"p90\",\"p99\",\"max\",\"frontier\"\n", f );
+
+    for( const link_sweep_point_t &point : points )
+    {
+        fprintf( f,
+                 "\"%s\",\"%s\",%u,%llu,%llu",
+                 point.spec.c_str(),
+                 link_kind_name( point.config.kind ),
+                 point.config.payload_bytes,
+                 (unsigned long long)point.triggers,
+                 (unsigned long long)point.delivered );
+
+        for( double value : { point.p50, point.p90, point.p99, point.max } )
+        {
+            print_value( f, value );
+        }
+
+        fprintf( f, ",%d\n", point.frontier ? 1 : 0 );
+    }
+
+    return !ferror( f );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_value( FILE *f, double value )
+{
+    if( isnan( value ) )
+    {
+        fputs( ",NA", f );
+    }
+    else
+    {
+        fprintf( f, ",%.7g", value );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,234 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "rtt_dump.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define RTT_DUMP_MAGIC         (0x48545452u)
+#define RTT_DUMP_VERSION       (1u)
+#define RTT_DUMP_HEADER_LENGTH (40u)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool rtt_dump_read_binary( FILE *f, rtt_dump_t *dump );
+static bool rtt_dump_read_text( FILE *f, rtt_dump_t *dump );
+static uint32_t rtt_dump_u32( const uint8_t *p );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool rtt_dump_read( const std::string &path, rtt_dump_t *dump )
+{
+    dump->cycles_per_us = 0;
+    dump->samples       = 0;
+    dump->lost          = 0;
+    dump->min_cycles    = 0;
+    dump->max_cycles    = 0;
+    dump->bins.clear();
+    dump->error.clear();
+
+    FILE *f = fopen( path.c_str(), "rb" );
+
+    if( !f )
+    {
+        dump->error = "can't open";
+        return false;
+    }
+
+    uint8_t magic[4];
+    bool    binary = fread( magic, sizeof( magic ), 1, f ) == 1 && rtt_dump_u32( magic ) == RTT_DUMP_MAGIC;
+
+    rewind( f );
+
+    const bool ok = binary ? rtt_dump_read_binary( f, dump ) : rtt_dump_read_text( f, dump );
+
+    fclose( f );
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void rtt_dump_durations_ms( const rtt_dump_t &dump, std::vector<double> *durations_ms )
+{
+    const double ms_per_cycle = 1.0 / ( (double)dump.cycles_per_us * 1000.0 );
+
+    durations_ms->clear();
+    durations_ms->reserve( dump.samples );
+
+    for( const rtt_bin_t &bin : dump.bins )
+    {
+        for( uint32_t i = 0; i < bin.count; i++ )
+        {
+            // Single cycle bins are exact, wider ones are spread rather than
+            // stacked on one value so the densities stay smooth
+            const double offset = ( bin.width > 1 ) ? bin.width * ( i + 0.5 ) / bin.count : 0.0;
+            double       cycles = bin.lower + offset;
+
+            // The end bins are only partly covered
+            if( cycles < dump.min_cycles )
+            {
+                cycles = dump.min_cycles;
+            }
+            else if( cycles > dump.max_cycles )
+            {
+                cycles = dump.max_cycles;
+            }
+
+            durations_ms->push_back( cycles * ms_per_cycle );
+        }
+    }
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// The struct as the firmware lays it out, little endian
+static bool rtt_dump_read_binary( FILE *f, rtt_dump_t *dump )
+{
+    uint8_t header[RTT_DUMP_HEADER_LENGTH];
+
+    if( fread( header, sizeof( header ), 1, f ) != 1 )
+    {
+        dump->error = "truncated header";
+        return false;
+    }
+
+    const uint32_t version   = rtt_dump_u32( header + 4 ) & 0xFFFFu;
+    const uint32_t precision = header[6];
+    const uint32_t bin_count = rtt_dump_u32( header + 12 );
+
+    if( version != RTT_DUMP_VERSION || precision < 2 || precision > 16 )
+    {
+        dump->error = "unsupported histogram version";
+        return false;
+    }
+
+    const uint32_t half = 1u << ( precision - 1 );
+
+    if( bin_count != ( 34u - precision ) * half )
+    {
+        dump->error = "bin count doesn't match the precision";
+        return false;
+    }
+
+    std::vector<uint8_t> bins( (size_t)bin_count * 4 );
+
+    if( fread( bins.data(), bins.size(), 1, f ) != 1 )
+    {
+        dump->error = "truncated bins";
+        return false;
+    }
+
+    dump->cycles_per_us = rtt_dump_u32( header + 8 );
+    dump->samples       = rtt_dump_u32( header + 16 );
+    dump->lost          = rtt_dump_u32( header + 20 );
+    dump->min_cycles    = dump->samples ? rtt_dump_u32( header + 24 ) : 0;
+    dump->max_cycles    = rtt_dump_u32( header + 28 );
+
+    for( uint32_t i = 0; i < bin_count; i++ )
+    {
+        const uint32_t count = rtt_dump_u32( &bins[(size_t)i * 4] );
+
+        if( !count )
+        {
+            continue;
+        }
+
+        // Same log-linear layout as rtt_histogram_bin_lower()
+        rtt_bin_t bin;
+        bin.count = count;
+
+        if( i < 2 * half )
+        {
+            bin.lower = i;
+            bin.width = 1;
+        }
+        else
+        {
+            const uint32_t shift = i / half - 1;
+
+            bin.lower = ( half + i % half ) << shift;
+            bin.width = 1u << shift;
+        }
+
+        dump->bins.push_back( bin );
+    }
+
+    if( !dump->cycles_per_us )
+    {
+        dump->error = "no clock rate";
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool rtt_dump_read_text( FILE *f, rtt_dump_t *dump )
+{
+    char       line[512];
+    rtt_dump_t pending;
+    uint64_t   counted = 0;
+    bool       open    = false;
+    bool       found   = false;
+
+    while( fgets( line, sizeof( line ), f ) )
+    {
+        const char *at;
+        unsigned    a, b, c, d, e;
+
+        if( ( at = strstr( line, "rtt-histogram " ) )
+            && sscanf( at, "rtt-histogram %u %u %u %u %u", &a, &b, &c, &d, &e ) == 5 )
+        {
+            pending.cycles_per_us = a;
+            pending.samples       = b;
+            pending.lost          = c;
+            pending.min_cycles    = d;
+            pending.max_cycles    = e;
+            pending.bins.clear();
+            counted = 0;
+            open    = true;
+        }
+        else if( open && ( at = strstr( line, "rtt-bin " ) ) && sscanf( at, "rtt-bin %u %u %u", &a, &b, &c ) == 3 )
+        {
+            pending.bins.push_back( { a, b, c } );
+            counted += c;
+        }
+        else if( open && strstr( line, "rtt-end" ) )
+        {
+            // Only printouts that made it out whole, no lines dropped
+            if( pending.cycles_per_us && counted == pending.samples )
+            {
+                dump->cycles_per_us = pending.cycles_per_us;
+                dump->samples       = pending.samples;
+                dump->lost          = pending.lost;
+                dump->min_cycles    = pending.min_cycles;
+                dump->max_cycles    = pending.max_cycles;
+                dump->bins          = pending.bins;
+                found               = true;
+            }
+
+            open = false;
+        }
+    }
+
+    if( !found )
+    {
+        dump->error = "no complete rtt-histogram printout";
+    }
+
+    return found;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t rtt_dump_u32( const uint8_t *p )
+{
+    return (uint32_t)p[0] | ( (uint32_t)p[1] << 8 ) | ( (uint32_t)p[2] << 16 ) | ( (uint32_t)p[3] << 24 );
+}
+
+/* ----- End ---------------------------------------------------------------- */
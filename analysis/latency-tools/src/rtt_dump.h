@@ -0,0 +1,52 @@
+#ifndef RTT_DUMP_H
+#define RTT_DUMP_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    uint32_t lower;     // cycles
+    uint32_t width;
+    uint32_t count;
+} rtt_bin_t;
+
+// Round trip histogram pulled off a board in RTT mode, see
+// firmware/common/rtt_histogram.h
+typedef struct
+{
+    uint32_t               cycles_per_us;
+    uint64_t               samples;
+    uint64_t               lost;
+    uint32_t               min_cycles;
+    uint32_t               max_cycles;
+    std::vector<rtt_bin_t> bins;        // non-empty bins, ascending
+    std::string            error;       // why the read failed
+} rtt_dump_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Reads either a raw rtt_histogram_t dumped with a debugger, or a console log
+ *  holding rtt_histogram_print() output. A log can have several printouts
+ *  among other lines, with or without log prefixes, the last complete one
+ *  is used since each holds every sample so far.
+ */
+
+bool rtt_dump_read( const std::string &path, rtt_dump_t *dump );
+
+/* -------------------------------------------------------------------------- */
+
+/** Expands the histogram back into one duration (ms) per sample, spread
+ *  evenly over each bin's range, for the wide csv files and charts
+ */
+
+void rtt_dump_durations_ms( const rtt_dump_t &dump, std::vector<double> *durations_ms );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* RTT_DUMP_H */
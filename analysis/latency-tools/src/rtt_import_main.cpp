@@ -0,0 +1,129 @@
+/* -------------------------------------------------------------------------- */
+
+// Converts the round trip histograms the firmware keeps in RTT mode into the
+// wide csv layout, a column of durations (ms) per dump, so they go through
+// latency-stats, latency-plot and the R scripts like the logic analyser runs.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+#include "rtt_dump.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define DEFAULT_OUTPUT_NAME "rtt_df.csv"
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool process_file( const std::string &path, latency_column_t *column );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    std::string              output = DEFAULT_OUTPUT_NAME;
+    std::vector<std::string> inputs;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    if( inputs.empty() )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    std::vector<latency_column_t> columns;
+
+    for( const std::string &path : inputs )
+    {
+        printf( "Processing file: %s\n", path.c_str() );
+
+        latency_column_t column;
+        if( !process_file( path, &column ) )
+        {
+            return 1;
+        }
+
+        columns.push_back( std::move( column ) );
+    }
+
+    if( !latency_columns_write_csv( output.c_str(), columns ) )
+    {
+        fprintf( stderr, "Failed to write %s\n", output.c_str() );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-o %s] dump ...\n", name, DEFAULT_OUTPUT_NAME );
+    printf( "Each dump is either an rtt_histogram_t read off the board with a debugger\n" );
+    printf( "(e.g. gdb's dump binary value rtt.bin rtt_histogram) or a console log with\n" );
+    printf( "the histogram printouts, where the last complete one is used. Writes one\n" );
+    printf( "column of round trip times (ms) per dump, named after the file.\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool process_file( const std::string &path, latency_column_t *column )
+{
+    rtt_dump_t dump;
+
+    if( !rtt_dump_read( path, &dump ) )
+    {
+        fprintf( stderr, "%s: %s\n", path.c_str(), dump.error.c_str() );
+        return false;
+    }
+
+    rtt_dump_durations_ms( dump, &column->values );
+
+    const double ms_per_cycle = 1.0 / ( (double)dump.cycles_per_us * 1000.0 );
+
+    printf( "  %llu round trips, %llu lost",
+            (unsigned long long)dump.samples,
+            (unsigned long long)dump.lost );
+
+    // Durations come out in ascending order
+    if( !column->values.empty() )
+    {
+        printf( ", min %.5f ms, median %.5f ms, max %.5f ms",
+                dump.min_cycles * ms_per_cycle,
+                column->values[column->values.size() / 2],
+                dump.max_cycles * ms_per_cycle );
+    }
+
+    printf( "\n" );
+
+    column->name = std::filesystem::path( path ).stem().string();
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
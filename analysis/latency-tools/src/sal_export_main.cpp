@@ -0,0 +1,216 @@
+/* -------------------------------------------------------------------------- */
+
+// Reads Saleae Logic 2 .sal captures directly
+//
+// Without -o, prints a summary of each digital channel in every capture.
+// With -o, writes the same csv the Logic 2 'Export Data' dialog would produce for
+// the selected channels, which is handy for checking the decoder or feeding older
+// scripts.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "iso8601.h"
+#include "saleae_sal.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define DEFAULT_CHANNEL_MASK (0x3u)     // trigger and done, same as the latency exports
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool parse_channels( const char *list, uint32_t *mask );
+static void print_summary( const char *path, const saleae_sal_t *sal );
+static bool write_csv( const char *path, const saleae_sal_t *sal, uint32_t channel_mask );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    const char *             output       = 0;
+    uint32_t                 channel_mask = DEFAULT_CHANNEL_MASK;
+    std::vector<std::string> inputs;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-c" ) == 0 && i + 1 < argc )
+        {
+            if( !parse_channels( argv[++i], &channel_mask ) )
+            {
+                fprintf( stderr, "Invalid channel list '%s'\n", argv[i] );
+                return 1;
+            }
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    if( inputs.empty() || ( output && inputs.size() != 1 ) )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    for( const std::string &path : inputs )
+    {
+        saleae_sal_t sal;
+
+        if( !saleae_sal_open( &sal, path.c_str() ) )
+        {
+            fprintf( stderr, "%s: not a readable Logic 2 capture\n", path.c_str() );
+            return 1;
+        }
+
+        if( !output )
+        {
+            print_summary( path.c_str(), &sal );
+        }
+        else if( !write_csv( output, &sal, channel_mask ) )
+        {
+            fprintf( stderr, "Failed to write %s\n", output );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s capture.sal [capture.sal ...]\n", name );
+    printf( "       %s [-c 0,1] -o export.csv capture.sal\n", name );
+    printf( "Decodes the digital channels of Logic 2 captures. Prints a summary of each\n" );
+    printf( "channel, or with -o writes a Logic 2 style csv export of the channels listed\n" );
+    printf( "with -c (default 0,1).\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool parse_channels( const char *list, uint32_t *mask )
+{
+    uint32_t    result = 0;
+    const char *p      = list;
+
+    while( *p )
+    {
+        char *        stop    = 0;
+        unsigned long channel = strtoul( p, &stop, 10 );
+
+        if( stop == p || channel >= SALEAE_CSV_MAX_CHANNELS || ( *stop != ',' && *stop != '\0' ) )
+        {
+            return false;
+        }
+
+        result |= 1u << channel;
+        p = ( *stop == ',' ) ? stop + 1 : stop;
+    }
+
+    *mask = result;
+    return result != 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_summary( const char *path, const saleae_sal_t *sal )
+{
+    char start[ISO8601_SALEAE_LENGTH + 1];
+    iso8601_format_ns( sal->start_time_ns, start );
+
+    printf( "%s: start %s\n", path, start );
+
+    for( const saleae_sal_channel_t &channel : sal->channels )
+    {
+        const double last_s = channel.edges_ns.empty() ? 0.0 : (double)channel.edges_ns.back() / 1e9;
+
+        printf( "  channel %u: %.0f Hz, initial %u, %zu edges, last at %.9f s\n",
+                channel.channel,
+                channel.sample_rate,
+                channel.initial_level,
+                channel.edges_ns.size(),
+                last_s );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool write_csv( const char *path, const saleae_sal_t *sal, uint32_t channel_mask )
+{
+    // Only export channels that exist in the capture
+    uint32_t present = 0;
+
+    for( const saleae_sal_channel_t &channel : sal->channels )
+    {
+        if( channel.channel < SALEAE_CSV_MAX_CHANNELS )
+        {
+            present |= 1u << channel.channel;
+        }
+    }
+
+    channel_mask &= present;
+
+    std::vector<saleae_row_t> rows;
+    saleae_sal_rows( sal, channel_mask, &rows );
+
+    FILE *file = fopen( path, "wb" );
+
+    if( !file )
+    {
+        return false;
+    }
+
+    fputs( "Time [s]", file );
+
+    for( uint32_t ch = 0; ch < SALEAE_CSV_MAX_CHANNELS; ch++ )
+    {
+        if( channel_mask & ( 1u << ch ) )
+        {
+            fprintf( file, ",Channel %u", ch );
+        }
+    }
+
+    fputc( '\n', file );
+
+    char timestamp[ISO8601_SALEAE_LENGTH + 1];
+
+    for( const saleae_row_t &row : rows )
+    {
+        iso8601_format_ns( row.time_ns, timestamp );
+        fputs( timestamp, file );
+
+        for( uint32_t ch = 0; ch < SALEAE_CSV_MAX_CHANNELS; ch++ )
+        {
+            if( channel_mask & ( 1u << ch ) )
+            {
+                fputc( ',', file );
+                fputc( ( row.channels & ( 1u << ch ) ) ? '1' : '0', file );
+            }
+        }
+
+        fputc( '\n', file );
+    }
+
+    return fclose( file ) == 0;
+}
+
+/* -------------------------------------------------------------------------- */
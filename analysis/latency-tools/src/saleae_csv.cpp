@@ -0,0 +1,259 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "saleae_csv.h"
+#include "iso8601.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool saleae_csv_read_line( saleae_csv_t *csv, const char **line, size_t *len );
+static bool saleae_csv_parse_seconds( const char *str, size_t len, int64_t *ns );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool saleae_csv_open( saleae_csv_t *csv, const char *path )
+{
+    csv->file          = fopen( path, "rb" );
+    csv->pos           = 0;
+    csv->len           = 0;
+    csv->eof           = false;
+    csv->channel_count = 0;
+    csv->line          = 0;
+    csv->time_cache    = {};
+
+    if( !csv->file )
+    {
+        return false;
+    }
+
+    csv->buf.resize( SALEAE_CSV_BUFFER_SIZE );
+
+    // Header is "Time [s],Channel 0,Channel 1,..." - we only need the column count
+    const char *line = 0;
+    size_t      len  = 0;
+
+    if( !saleae_csv_read_line( csv, &line, &len ) || len < 4 || strncmp( line, "Time", 4 ) != 0 )
+    {
+        saleae_csv_close( csv );
+        return false;
+    }
+
+    for( size_t i = 0; i < len; i++ )
+    {
+        csv->channel_count += ( line[i] == ',' );
+    }
+
+    if( csv->channel_count == 0 || csv->channel_count > SALEAE_CSV_MAX_CHANNELS )
+    {
+        saleae_csv_close( csv );
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool saleae_csv_next( saleae_csv_t *csv, saleae_row_t *row )
+{
+    const char *line = 0;
+    size_t      len  = 0;
+
+    while( saleae_csv_read_line( csv, &line, &len ) )
+    {
+        // Tolerate blank lines at the end of hand-edited files
+        if( len == 0 )
+        {
+            continue;
+        }
+
+        return saleae_csv_parse_row( line, len, csv->channel_count, &csv->time_cache, row );
+    }
+
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void saleae_csv_close( saleae_csv_t *csv )
+{
+    if( csv->file )
+    {
+        fclose( csv->file );
+        csv->file = 0;
+    }
+
+    csv->buf.clear();
+    csv->buf.shrink_to_fit();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool saleae_csv_parse_row( const char *      line,
+                           size_t            len,
+                           uint32_t          channel_count,
+                           iso8601_cache_t * time_cache,
+                           saleae_row_t *    row )
+{
+    const char *comma = (const char *)memchr( line, ',', len );
+
+    if( !comma )
+    {
+        return false;
+    }
+
+    size_t time_len = (size_t)( comma - line );
+
+    bool iso_ok = time_cache ? iso8601_parse_ns_cached( time_cache, line, time_len, &row->time_ns )
+                             : iso8601_parse_ns( line, time_len, &row->time_ns );
+
+    if( !iso_ok && !saleae_csv_parse_seconds( line, time_len, &row->time_ns ) )
+    {
+        return false;
+    }
+
+    // Channel columns are single '0' or '1' characters
+    const char *p   = comma;
+    const char *end = line + len;
+    row->channels   = 0;
+
+    for( uint32_t ch = 0; ch < channel_count; ch++ )
+    {
+        if( p + 2 > end || p[0] != ',' || ( p[1] != '0' && p[1] != '1' ) )
+        {
+            return false;
+        }
+
+        row->channels |= (uint32_t)( p[1] - '0' ) << ch;
+        p += 2;
+    }
+
+    return true;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// Returns a pointer into the read buffer, valid until the next call
+static bool saleae_csv_read_line( saleae_csv_t *csv, const char **line, size_t *len )
+{
+    while( true )
+    {
+        char *start = &csv->buf[csv->pos];
+        char *nl    = (char *)memchr( start, '\n', csv->len - csv->pos );
+
+        if( nl )
+        {
+            size_t n = (size_t)( nl - start );
+            csv->pos += n + 1;
+
+            // Windows line endings from the Logic 2 export on some hosts
+            if( n > 0 && start[n - 1] == '\r' )
+            {
+                n--;
+            }
+
+            *line = start;
+            *len  = n;
+            csv->line++;
+            return true;
+        }
+
+        if( csv->eof )
+        {
+            // Last line without a trailing newline
+            if( csv->pos < csv->len )
+            {
+                *line    = start;
+                *len     = csv->len - csv->pos;
+                csv->pos = csv->len;
+                csv->line++;
+                return true;
+            }
+
+            return false;
+        }
+
+        // Move the partial line to the front and refill behind it
+        size_t remaining = csv->len - csv->pos;
+        memmove( &csv->buf[0], start, remaining );
+        csv->pos = 0;
+        csv->len = remaining;
+
+        if( csv->len == csv->buf.size() )
+        {
+            // A line longer than the whole buffer isn't a Saleae export
+            return false;
+        }
+
+        size_t got = fread( &csv->buf[csv->len], 1, csv->buf.size() - csv->len, csv->file );
+        csv->len += got;
+
+        if( got == 0 )
+        {
+            csv->eof = true;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Exports made with "relative time" give plain seconds from the trigger
+static bool saleae_csv_parse_seconds( const char *str, size_t len, int64_t *ns )
+{
+    size_t  i        = 0;
+    bool    negative = false;
+    int64_t whole    = 0;
+    int64_t fraction = 0;
+    int64_t scale    = 1000000000LL;
+
+    if( i < len && str[i] == '-' )
+    {
+        negative = true;
+        i++;
+    }
+
+    if( i == len )
+    {
+        return false;
+    }
+
+    for( ; i < len && str[i] != '.'; i++ )
+    {
+        uint32_t digit = (uint32_t)( str[i] - '0' );
+        if( digit > 9 )
+        {
+            return false;
+        }
+        whole = whole * 10 + digit;
+    }
+
+    if( i < len )
+    {
+        i++;    // skip the decimal point
+    }
+
+    for( ; i < len; i++ )
+    {
+        uint32_t digit = (uint32_t)( str[i] - '0' );
+        if( digit > 9 )
+        {
+            return false;
+        }
+
+        // Anything below 1ns is dropped
+        if( scale > 1 )
+        {
+            scale /= 10;
+            fraction += digit * scale;
+        }
+    }
+
+    *ns = whole * 1000000000LL + fraction;
+    *ns = negative ? -*ns : *ns;
+    return true;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,74 @@
+#ifndef SALEAE_CSV_H
+#define SALEAE_CSV_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "iso8601.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define SALEAE_CSV_BUFFER_SIZE  (1u << 20)
+#define SALEAE_CSV_MAX_CHANNELS (32u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+// One line of a Logic 2 edge export, the channel states are packed LSB first
+typedef struct
+{
+    int64_t  time_ns;
+    uint32_t channels;
+} saleae_row_t;
+
+typedef struct
+{
+    FILE *            file;
+    std::vector<char> buf;
+    size_t            pos;
+    size_t            len;
+    bool              eof;
+    uint32_t          channel_count;
+    uint64_t          line;
+    iso8601_cache_t   time_cache;
+} saleae_csv_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Opens an exported csv and consumes the header row. Returns false if the file
+ *  can't be read or doesn't look like a Logic 2 digital export.
+ */
+
+bool saleae_csv_open( saleae_csv_t *csv, const char *path );
+
+/* -------------------------------------------------------------------------- */
+
+/** Reads the next row. Returns false at the end of the file or on a malformed
+ *  row, check csv->eof to tell them apart.
+ */
+
+bool saleae_csv_next( saleae_csv_t *csv, saleae_row_t *row );
+
+/* -------------------------------------------------------------------------- */
+
+void saleae_csv_close( saleae_csv_t *csv );
+
+/* -------------------------------------------------------------------------- */
+
+/** Parses a single data line (without the newline).
+ *  time_cache is optional, pass one per stream of rows to skip repeated date maths.
+ */
+
+bool saleae_csv_parse_row( const char *      line,
+                           size_t            len,
+                           uint32_t          channel_count,
+                           iso8601_cache_t * time_cache,
+                           saleae_row_t *    row );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* SALEAE_CSV_H */
@@ -0,0 +1,480 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "saleae_sal.h"
+#include "zip_archive.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// digital-N.bin layout, reverse engineered from Logic 2.4 captures:
+//
+//  "<SALEAE>", u32 version (1), u32 type (100 = digital)
+//  u8 unknown, f64 sample rate, u64 capture start (unix ms), f64 fractional ms
+//  u8 flag [u64 first sample kept], u8 flag [u64 last sample kept]
+//  u64 chunk count, then per chunk:
+//      u64 begin sample, u64 end sample, u64 length, u64 rate, u64 unknown, u64 n
+//      n bytes of run lengths
+//      u64 index count, index count * { u64 sample, u64 byte offset, u32 level }
+//
+// Run lengths alternate level, starting from the chunk's first index entry.
+// Each is stored minus one, big-endian in 7 bit groups: the first byte carries 6
+// bits with 0x40 as the continuation flag, later bytes carry 7 with 0x80.
+#define SAL_MAGIC         "<SALEAE>"
+#define SAL_MAGIC_LENGTH  (8u)
+#define SAL_VERSION       (1u)
+#define SAL_TYPE_DIGITAL  (100u)
+#define SAL_INDEX_SIZE    (20u)
+#define SAL_MAX_RUN_BYTES (10u)
+
+#define SAL_DIGITAL_PREFIX "digital-"
+#define SAL_DIGITAL_SUFFIX ".bin"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t         len;
+    size_t         pos;
+    bool           ok;
+} sal_cursor_t;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint8_t sal_read_u8( sal_cursor_t *cursor );
+static uint32_t sal_read_u32( sal_cursor_t *cursor );
+static uint64_t sal_read_u64( sal_cursor_t *cursor );
+static double sal_read_f64( sal_cursor_t *cursor );
+static const uint8_t *sal_read_bytes( sal_cursor_t *cursor, uint64_t count );
+static bool sal_decode_runs( const uint8_t *runs, uint64_t len, uint64_t begin, uint64_t end, std::vector<uint64_t> *edges );
+static int64_t sal_samples_to_ns( uint64_t samples, double sample_rate );
+static bool sal_channel_number( const char *name, uint32_t *channel );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool saleae_sal_open( saleae_sal_t *sal, const char *path )
+{
+    zip_archive_t zip;
+
+    sal->start_time_ns = 0;
+    sal->channels.clear();
+
+    if( !zip_archive_open( &zip, path ) )
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> blob;
+
+    for( const zip_entry_t &entry : zip.entries )
+    {
+        saleae_sal_channel_t channel;
+
+        // Analog channels and meta.json are skipped
+        if( !sal_channel_number( entry.name.c_str(), &channel.channel ) )
+        {
+            continue;
+        }
+
+        if( !zip_archive_extract( &zip, &entry, &blob )
+            || !saleae_sal_decode_digital( blob.data(), blob.size(), &channel ) )
+        {
+            return false;
+        }
+
+        sal->channels.push_back( std::move( channel ) );
+    }
+
+    if( sal->channels.empty() )
+    {
+        return false;
+    }
+
+    std::sort( sal->channels.begin(),
+               sal->channels.end(),
+               []( const saleae_sal_channel_t &a, const saleae_sal_channel_t &b ) { return a.channel < b.channel; } );
+
+    // Channels should agree, but rebase onto the earliest just in case
+    sal->start_time_ns = sal->channels.front().start_time_ns;
+
+    for( const saleae_sal_channel_t &channel : sal->channels )
+    {
+        sal->start_time_ns = std::min( sal->start_time_ns, channel.start_time_ns );
+    }
+
+    for( saleae_sal_channel_t &channel : sal->channels )
+    {
+        const int64_t shift = channel.start_time_ns - sal->start_time_ns;
+
+        if( shift != 0 )
+        {
+            for( int64_t &edge : channel.edges_ns )
+            {
+                edge += shift;
+            }
+
+            channel.end_ns += shift;
+
+            channel.start_time_ns = sal->start_time_ns;
+        }
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool saleae_sal_decode_digital( const uint8_t *data, size_t len, saleae_sal_channel_t *channel )
+{
+    sal_cursor_t cursor = { data, len, 0, true };
+
+    const uint8_t *magic = sal_read_bytes( &cursor, SAL_MAGIC_LENGTH );
+
+    if( !magic || memcmp( magic, SAL_MAGIC, SAL_MAGIC_LENGTH ) != 0
+        || sal_read_u32( &cursor ) != SAL_VERSION
+        || sal_read_u32( &cursor ) != SAL_TYPE_DIGITAL )
+    {
+        return false;
+    }
+
+    sal_read_u8( &cursor );
+    const double   sample_rate   = sal_read_f64( &cursor );
+    const uint64_t start_unix_ms = sal_read_u64( &cursor );
+    const double   start_frac_ms = sal_read_f64( &cursor );
+
+    // Optional trim range set in the Logic 2 UI, the csv export starts at first_sample
+    const bool     has_first    = sal_read_u8( &cursor ) != 0;
+    const uint64_t first_sample = has_first ? sal_read_u64( &cursor ) : 0;
+    const bool     has_last     = sal_read_u8( &cursor ) != 0;
+    const uint64_t last_sample  = has_last ? sal_read_u64( &cursor ) : UINT64_MAX;
+    const uint64_t chunk_count  = sal_read_u64( &cursor );
+
+    if( !cursor.ok || !( sample_rate > 0.0 ) )
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> edges;
+    bool                  have_level = false;
+    uint8_t               level      = 0;
+    uint8_t               initial    = 0;
+    uint64_t              end_sample = 0;
+
+    for( uint64_t chunk = 0; chunk < chunk_count && cursor.ok; chunk++ )
+    {
+        const uint64_t begin = sal_read_u64( &cursor );
+        const uint64_t end   = sal_read_u64( &cursor );
+        sal_read_u64( &cursor );     // length
+        sal_read_u64( &cursor );     // rate
+        sal_read_u64( &cursor );
+        const uint64_t run_bytes = sal_read_u64( &cursor );
+        const uint8_t *runs      = sal_read_bytes( &cursor, run_bytes );
+        const uint64_t indexes   = sal_read_u64( &cursor );
+        const uint8_t *index     = ( indexes <= len / SAL_INDEX_SIZE )
+                                   ? sal_read_bytes( &cursor, indexes * SAL_INDEX_SIZE )
+                                   : 0;
+
+        if( !cursor.ok || !index || end < begin )
+        {
+            return false;
+        }
+
+        // The first index entry holds the level at the start of the chunk,
+        // a chunk boundary is only an edge if that differs from where we left off
+        if( indexes > 0 )
+        {
+            uint8_t chunk_level = ( index[16] != 0 );
+
+            if( !have_level )
+            {
+                initial    = chunk_level;
+                have_level = true;
+            }
+            else if( chunk_level != level )
+            {
+                edges.push_back( begin );
+            }
+
+            level = chunk_level;
+        }
+        else if( !have_level )
+        {
+            return false;
+        }
+
+        const size_t before = edges.size();
+
+        if( !sal_decode_runs( runs, run_bytes, begin, end, &edges ) )
+        {
+            return false;
+        }
+
+        level ^= (uint8_t)( ( edges.size() - before ) & 1u );
+        end_sample = end;
+    }
+
+    if( !cursor.ok || !have_level )
+    {
+        return false;
+    }
+
+    // Fold anything before the trim point into the initial level, drop anything after it
+    size_t keep_from = 0;
+    while( keep_from < edges.size() && edges[keep_from] <= first_sample )
+    {
+        keep_from++;
+    }
+
+    initial ^= (uint8_t)( keep_from & 1u );
+
+    // The last sample kept is inclusive, chunk ends aren't
+    const uint64_t stop_sample = has_last ? std::min( end_sample, last_sample + 1 ) : end_sample;
+
+    if( stop_sample < first_sample )
+    {
+        return false;
+    }
+
+    channel->initial_level = initial;
+    channel->sample_rate   = sample_rate;
+    channel->start_time_ns = (int64_t)start_unix_ms * 1000000LL
+                             + (int64_t)llround( start_frac_ms * 1e6 )
+                             + sal_samples_to_ns( first_sample, sample_rate );
+    channel->end_ns        = sal_samples_to_ns( stop_sample - first_sample, sample_rate );
+    channel->edges_ns.clear();
+    channel->edges_ns.reserve( edges.size() - keep_from );
+
+    for( size_t i = keep_from; i < edges.size() && edges[i] <= last_sample; i++ )
+    {
+        channel->edges_ns.push_back( sal_samples_to_ns( edges[i] - first_sample, sample_rate ) );
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void saleae_sal_rows( const saleae_sal_t *sal, uint32_t channel_mask, std::vector<saleae_row_t> *rows )
+{
+    std::vector<const saleae_sal_channel_t *> selected;
+    saleae_row_t                              row;
+
+    row.time_ns  = sal->start_time_ns;
+    row.channels = 0;
+
+    for( const saleae_sal_channel_t &channel : sal->channels )
+    {
+        if( channel.channel < SALEAE_CSV_MAX_CHANNELS && ( channel_mask & ( 1u << channel.channel ) ) )
+        {
+            selected.push_back( &channel );
+            row.channels |= (uint32_t)channel.initial_level << channel.channel;
+        }
+    }
+
+    std::vector<size_t> next( selected.size(), 0 );
+    int64_t             end_ns = 0;
+
+    for( const saleae_sal_channel_t *channel : selected )
+    {
+        end_ns = std::max( end_ns, channel->end_ns );
+    }
+
+    rows->push_back( row );
+
+    // Only a handful of channels, a linear scan for the earliest edge is plenty
+    for( ;; )
+    {
+        int64_t earliest = INT64_MAX;
+
+        for( size_t i = 0; i < selected.size(); i++ )
+        {
+            if( next[i] < selected[i]->edges_ns.size() )
+            {
+                earliest = std::min( earliest, selected[i]->edges_ns[next[i]] );
+            }
+        }
+
+        if( earliest == INT64_MAX )
+        {
+            break;
+        }
+
+        for( size_t i = 0; i < selected.size(); i++ )
+        {
+            const saleae_sal_channel_t *channel = selected[i];
+
+            if( next[i] < channel->edges_ns.size() && channel->edges_ns[next[i]] == earliest )
+            {
+                next[i]++;
+                row.channels ^= 1u << channel->channel;
+            }
+        }
+
+        row.time_ns = sal->start_time_ns + earliest;
+        rows->push_back( row );
+    }
+
+    // Exports close with the final state at the end of the capture
+    if( sal->start_time_ns + end_ns > row.time_ns )
+    {
+        row.time_ns = sal->start_time_ns + end_ns;
+        rows->push_back( row );
+    }
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static uint8_t sal_read_u8( sal_cursor_t *cursor )
+{
+    const uint8_t *p = sal_read_bytes( cursor, 1 );
+    return p ? p[0] : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t sal_read_u32( sal_cursor_t *cursor )
+{
+    uint32_t       value = 0;
+    const uint8_t *p     = sal_read_bytes( cursor, sizeof( value ) );
+
+    if( p )
+    {
+        memcpy( &value, p, sizeof( value ) );
+    }
+
+    return value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t sal_read_u64( sal_cursor_t *cursor )
+{
+    uint64_t       value = 0;
+    const uint8_t *p     = sal_read_bytes( cursor, sizeof( value ) );
+
+    if( p )
+    {
+        memcpy( &value, p, sizeof( value ) );
+    }
+
+    return value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double sal_read_f64( sal_cursor_t *cursor )
+{
+    double         value = 0.0;
+    const uint8_t *p     = sal_read_bytes( cursor, sizeof( value ) );
+
+    if( p )
+    {
+        memcpy( &value, p, sizeof( value ) );
+    }
+
+    return value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static const uint8_t *sal_read_bytes( sal_cursor_t *cursor, uint64_t count )
+{
+    if( !cursor->ok || count > cursor->len - cursor->pos )
+    {
+        cursor->ok = false;
+        return 0;
+    }
+
+    const uint8_t *p = cursor->data + cursor->pos;
+    cursor->pos += count;
+    return p;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Appends the sample number of every transition inside the chunk. The last run
+// always finishes on the chunk end, which isn't a transition.
+static bool sal_decode_runs( const uint8_t *runs, uint64_t len, uint64_t begin, uint64_t end, std::vector<uint64_t> *edges )
+{
+    uint64_t sample = begin;
+    uint64_t i      = 0;
+
+    while( i < len )
+    {
+        uint8_t  byte     = runs[i++];
+        uint64_t run      = byte & 0x3Fu;
+        bool     more     = ( byte & 0x40u ) != 0;
+        uint32_t consumed = 1;
+
+        while( more )
+        {
+            if( i >= len || ++consumed > SAL_MAX_RUN_BYTES )
+            {
+                return false;
+            }
+
+            byte = runs[i++];
+            run  = ( run << 7 ) | ( byte & 0x7Fu );
+            more = ( byte & 0x80u ) != 0;
+        }
+
+        sample += run + 1;
+
+        if( sample < end )
+        {
+            edges->push_back( sample );
+        }
+    }
+
+    return sample == end;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int64_t sal_samples_to_ns( uint64_t samples, double sample_rate )
+{
+    // Logic 2 rates divide 1GHz evenly, keep those exact
+    const double period_ns = 1e9 / sample_rate;
+
+    if( period_ns == floor( period_ns ) )
+    {
+        return (int64_t)samples * (int64_t)period_ns;
+    }
+
+    return (int64_t)llround( (double)samples * period_ns );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool sal_channel_number( const char *name, uint32_t *channel )
+{
+    const size_t prefix = strlen( SAL_DIGITAL_PREFIX );
+    const size_t suffix = strlen( SAL_DIGITAL_SUFFIX );
+    const size_t length = strlen( name );
+
+    if( length <= prefix + suffix
+        || strncmp( name, SAL_DIGITAL_PREFIX, prefix ) != 0
+        || strcmp( name + length - suffix, SAL_DIGITAL_SUFFIX ) != 0 )
+    {
+        return false;
+    }
+
+    char *stop = 0;
+    unsigned long value = strtoul( name + prefix, &stop, 10 );
+
+    if( stop != name + length - suffix )
+    {
+        return false;
+    }
+
+    *channel = (uint32_t)value;
+    return true;
+}
+
+/* ----- End ---------------------------------------------------------------- */
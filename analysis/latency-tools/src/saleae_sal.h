@@ -0,0 +1,59 @@
+#ifndef SALEAE_SAL_H
+#define SALEAE_SAL_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "saleae_csv.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Transitions for one digital channel, decoded from digital-N.bin in a .sal archive
+typedef struct
+{
+    uint32_t             channel;
+    uint8_t              initial_level;     // level at the start of the (trimmed) capture
+    double               sample_rate;       // Hz
+    int64_t              start_time_ns;     // unix epoch time of the first sample we kept
+    std::vector<int64_t> edges_ns;          // relative to start_time_ns, each one toggles the level
+    int64_t              end_ns;            // end of the recorded (trimmed) data, relative to start_time_ns
+} saleae_sal_channel_t;
+
+typedef struct
+{
+    int64_t                           start_time_ns;    // matches the first row of a csv export
+    std::vector<saleae_sal_channel_t> channels;         // sorted by channel number
+} saleae_sal_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Opens a Logic 2 .sal capture and decodes every digital channel into memory.
+ *  Edge times are rebased so every channel shares sal->start_time_ns.
+ */
+
+bool saleae_sal_open( saleae_sal_t *sal, const char *path );
+
+/* -------------------------------------------------------------------------- */
+
+/** Decodes a single digital-N.bin blob */
+
+bool saleae_sal_decode_digital( const uint8_t *data, size_t len, saleae_sal_channel_t *channel );
+
+/* -------------------------------------------------------------------------- */
+
+/** Merges the channels selected by channel_mask (bit N = channel N) into the rows
+ *  a Logic 2 csv export of those channels would contain: the initial state, one
+ *  row per distinct edge time, then the state at the end of the capture. Channels are packed by channel number and
+ *  time_ns is unix epoch time.
+ */
+
+void saleae_sal_rows( const saleae_sal_t *sal, uint32_t channel_mask, std::vector<saleae_row_t> *rows );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* SALEAE_SAL_H */
@@ -0,0 +1,668 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <algorithm>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_kde.h"
+#include "svg_chart.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define SVG_FONT                "Roboto Mono, DejaVu Sans Mono, monospace"
+#define SVG_TITLE_SIZE          (26)
+#define SVG_SUBTITLE_SIZE       (18)
+#define SVG_TEXT_SIZE           (16)
+#define SVG_CHAR_WIDTH          (0.62)      // of the font size, monospaced advance
+#define SVG_MARGIN              (20.0)
+#define SVG_RIGHT_GUTTER        (90.0)      // room for the n = labels
+#define SVG_HEADER_HEIGHT       (100.0)
+#define SVG_FOOTER_HEIGHT       (110.0)
+#define SVG_BOX_ROW_HEIGHT      (120.0)
+#define SVG_RIDGE_ROW_HEIGHT    (60.0)
+#define SVG_CDF_HEIGHT          (520.0)
+#define SVG_CDF_MAX_POINTS      (2000u)
+#define SVG_CDF_LEGEND_ROW      (26.0)
+#define SVG_AUTO_QUANTILE       (0.995)
+#define SVG_TICK_TARGET         (10.0)
+#define SVG_GRID_COLOUR         "#EBEBEB"
+#define SVG_INK_COLOUR          "#333333"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    std::string         name;
+    std::vector<double> sorted;
+} svg_series_t;
+
+// Plot area in pixels and the data range mapped onto it
+typedef struct
+{
+    double left;
+    double top;
+    double width;
+    double height;
+    double x_min;
+    double x_max;
+    double step;    // tick spacing
+} svg_frame_t;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static void svg_printf( std::string *svg, const char *format, ... );
+static void svg_text( std::string *svg, double x, double y, int size, const char *anchor, bool bold, const std::string &text );
+static std::string svg_escape( const std::string &text );
+static double svg_x( const svg_frame_t *frame, double value );
+static double svg_type7( const std::vector<double> &sorted, double q );
+static double svg_nice_step( double range );
+static void svg_bounds( const std::vector<svg_series_t> &series, const svg_chart_options_t &options, svg_frame_t *frame );
+static void svg_density_path( std::string *svg, const svg_frame_t *frame, const svg_series_t &series, double adjust, double baseline, double height, const char *colour );
+static void svg_x_axis( std::string *svg, const svg_frame_t *frame, const svg_chart_options_t &options );
+static void svg_clipped_count( std::string *svg, const svg_frame_t *frame, const svg_series_t &series, double y );
+
+static void svg_render_box( std::string *svg, const svg_frame_t *frame, const std::vector<svg_series_t> &series, const svg_chart_options_t &options );
+static void svg_render_ridgeline( std::string *svg, const svg_frame_t *frame, const std::vector<svg_series_t> &series, const svg_chart_options_t &options );
+static void svg_render_cdf( std::string *svg, const svg_frame_t *frame, const std::vector<svg_series_t> &series );
+
+/* ----- Private Variables -------------------------------------------------- */
+
+// Paul Tol's bright scheme, the same family cdf.R picks its protocol colours from
+static const char *svg_palette[] = { "#0077BB", "#EE7733", "#009988", "#CC3311", "#33BBEE", "#EE3377", "#BBBBBB" };
+
+#define SVG_PALETTE_SIZE ( sizeof( svg_palette ) / sizeof( svg_palette[0] ) )
+
+// Once the colours repeat, lines are told apart by dashes
+static const char *svg_dashes[] = { "none", "9 5", "2 4" };
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void svg_chart_defaults( svg_chart_options_t *options )
+{
+    options->kind     = SVG_CHART_BOX;
+    options->title    = "";
+    options->subtitle = "";
+    options->x_label  = "Duration (milliseconds)";
+    options->caption  = "Lower is better";
+    options->x_min    = NAN;
+    options->x_max    = NAN;
+    options->adjust   = 0.3;
+    options->width    = 1200;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool svg_chart_render( const std::vector<svg_chart_series_t> &series, const svg_chart_options_t &options, std::string *svg )
+{
+    std::vector<svg_series_t> prepared;
+    size_t                    longest_name = 0;
+
+    for( const svg_chart_series_t &input : series )
+    {
+        svg_series_t entry;
+        entry.name = input.name;
+
+        for( double value : input.values )
+        {
+            if( !isnan( value ) )
+            {
+                entry.sorted.push_back( value );
+            }
+        }
+
+        if( entry.sorted.empty() )
+        {
+            continue;
+        }
+
+        std::sort( entry.sorted.begin(), entry.sorted.end() );
+        longest_name = std::max( longest_name, entry.name.size() );
+        prepared.push_back( std::move( entry ) );
+    }
+
+    if( prepared.empty() )
+    {
+        return false;
+    }
+
+    svg_frame_t frame;
+    svg_bounds( prepared, options, &frame );
+
+    if( !( frame.x_max > frame.x_min ) )
+    {
+        return false;
+    }
+
+    const double label_width = ( options.kind == SVG_CHART_CDF ) ? 110.0
+                                                                 : (double)longest_name * SVG_TEXT_SIZE * SVG_CHAR_WIDTH + 24.0;
+    const double rows        = (double)prepared.size();
+
+    frame.left  = SVG_MARGIN + label_width;
+    frame.top   = SVG_HEADER_HEIGHT;
+    frame.width = (double)options.width - frame.left - SVG_MARGIN - SVG_RIGHT_GUTTER;
+
+    switch( options.kind )
+    {
+        case SVG_CHART_RIDGELINE:
+            // The first ridge overlaps into the space above it
+            frame.top += SVG_RIDGE_ROW_HEIGHT;
+            frame.height = rows * SVG_RIDGE_ROW_HEIGHT;
+            break;
+        case SVG_CHART_CDF:
+            // Tall enough for the legend to fit inside the plot
+            frame.height = std::max( SVG_CDF_HEIGHT, rows * SVG_CDF_LEGEND_ROW + 60.0 );
+            break;
+        default:
+            frame.height = rows * SVG_BOX_ROW_HEIGHT;
+            break;
+    }
+
+    if( frame.width < 100.0 )
+    {
+        return false;
+    }
+
+    const double height = frame.top + frame.height + SVG_FOOTER_HEIGHT;
+
+    svg->clear();
+    svg_printf( svg,
+                "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%u\" height=\"%.0f\" viewBox=\"0 0 %u %.0f\" font-family=\"%s\">\n",
+                options.width,
+                height,
+                options.width,
+                height,
+                SVG_FONT );
+    svg_printf( svg,
+                "<defs><clipPath id=\"plot\"><rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\"/></clipPath></defs>\n",
+                frame.left,
+                frame.top - ( ( options.kind == SVG_CHART_RIDGELINE ) ? SVG_RIDGE_ROW_HEIGHT : 0.0 ),
+                frame.width,
+                frame.height + ( ( options.kind == SVG_CHART_RIDGELINE ) ? SVG_RIDGE_ROW_HEIGHT : 0.0 ) );
+    svg_printf( svg, "<rect width=\"100%%\" height=\"100%%\" fill=\"white\"/>\n" );
+
+    const double centre = (double)options.width / 2.0;
+
+    svg_text( svg, centre, 40.0, SVG_TITLE_SIZE, "middle", false, options.title );
+    svg_text( svg, centre, 72.0, SVG_SUBTITLE_SIZE, "middle", false, options.subtitle );
+
+    svg_x_axis( svg, &frame, options );
+
+    switch( options.kind )
+    {
+        case SVG_CHART_RIDGELINE:
+            svg_render_ridgeline( svg, &frame, prepared, options );
+            break;
+        case SVG_CHART_CDF:
+            svg_render_cdf( svg, &frame, prepared );
+            break;
+        default:
+            svg_render_box( svg, &frame, prepared, options );
+            break;
+    }
+
+    svg_printf( svg, "</svg>\n" );
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool svg_chart_write( const char *path, const std::vector<svg_chart_series_t> &series, const svg_chart_options_t &options )
+{
+    std::string svg;
+
+    if( !svg_chart_render( series, options, &svg ) )
+    {
+        return false;
+    }
+
+    FILE *f = fopen( path, "wb" );
+
+    if( !f )
+    {
+        return false;
+    }
+
+    const bool written = fwrite( svg.data(), 1, svg.size(), f ) == svg.size();
+    return ( fclose( f ) == 0 ) && written;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static void svg_printf( std::string *svg, const char *format, ... )
+{
+    char    buffer[1024];
+    va_list args;
+
+    va_start( args, format );
+    const int length = vsnprintf( buffer, sizeof( buffer ), format, args );
+    va_end( args );
+
+    if( length < 0 )
+    {
+        return;
+    }
+
+    if( (size_t)length < sizeof( buffer ) )
+    {
+        svg->append( buffer, (size_t)length );
+        return;
+    }
+
+    std::string large( (size_t)length + 1, '\0' );
+
+    va_start( args, format );
+    vsnprintf( &large[0], large.size(), format, args );
+    va_end( args );
+
+    svg->append( large.c_str(), (size_t)length );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void svg_text( std::string *svg, double x, double y, int size, const char *anchor, bool bold, const std::string &text )
+{
+    if( text.empty() )
+    {
+        return;
+    }
+
+    svg_printf( svg,
+                "<text x=\"%.2f\" y=\"%.2f\" font-size=\"%d\" text-anchor=\"%s\"%s fill=\"%s\">%s</text>\n",
+                x,
+                y,
+                size,
+                anchor,
+                bold ? " font-weight=\"bold\"" : "",
+                SVG_INK_COLOUR,
+                svg_escape( text ).c_str() );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static std::string svg_escape( const std::string &text )
+{
+    std::string escaped;
+
+    for( char c : text )
+    {
+        switch( c )
+        {
+            case '&': escaped += "&amp;"; break;
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '"': escaped += "&quot;"; break;
+            default: escaped += c; break;
+        }
+    }
+
+    return escaped;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double svg_x( const svg_frame_t *frame, double value )
+{
+    return frame->left + ( value - frame->x_min ) / ( frame->x_max - frame->x_min ) * frame->width;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double svg_type7( const std::vector<double> &sorted, double q )
+{
+    const double h     = (double)( sorted.size() - 1 ) * q;
+    const size_t below = (size_t)floor( h );
+
+    if( below + 1 >= sorted.size() )
+    {
+        return sorted[below];
+    }
+
+    return sorted[below] + ( h - (double)below ) * ( sorted[below + 1] - sorted[below] );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// 1, 2 or 5 times a power of ten, like R's pretty()
+static double svg_nice_step( double range )
+{
+    const double raw       = range / SVG_TICK_TARGET;
+    const double magnitude = pow( 10.0, floor( log10( raw ) ) );
+    const double fraction  = raw / magnitude;
+
+    return magnitude * ( ( fraction < 1.5 ) ? 1.0 : ( fraction < 3.0 ) ? 2.0 : ( fraction < 7.0 ) ? 5.0 : 10.0 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void svg_bounds( const std::vector<svg_series_t> &series, const svg_chart_options_t &options, svg_frame_t *frame )
+{
+    double lowest  = INFINITY;
+    double highest = -INFINITY;
+    double tail    = -INFINITY;
+
+    for( const svg_series_t &entry : series )
+    {
+        lowest  = std::min( lowest, entry.sorted.front() );
+        highest = std::max( highest, entry.sorted.back() );
+        tail    = std::max( tail, svg_type7( entry.sorted, SVG_AUTO_QUANTILE ) );
+    }
+
+    // Latencies start the axis at zero. The far end stops a little past the
+    // worst 99.5th percentile unless the true max is close anyway.
+    double low  = isnan( options.x_min ) ? ( ( lowest >= 0.0 ) ? 0.0 : lowest ) : options.x_min;
+    double high = isnan( options.x_max ) ? ( ( highest <= tail * 1.15 ) ? highest : tail * 1.15 ) : options.x_max;
+
+    if( !( high > low ) )
+    {
+        high = low + ( ( low != 0.0 ) ? fabs( low ) : 1.0 );
+    }
+
+    frame->step = svg_nice_step( high - low );
+
+    if( isnan( options.x_min ) )
+    {
+        low = floor( low / frame->step ) * frame->step;
+    }
+
+    if( isnan( options.x_max ) )
+    {
+        high = ceil( high / frame->step ) * frame->step;
+    }
+
+    frame->x_min = low;
+    frame->x_max = high;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Filled density over the sample range, peak scaled to height (ggdist's
+// normalize = "groups")
+static void svg_density_path( std::string *svg, const svg_frame_t *frame, const svg_series_t &series, double adjust, double baseline, double height, const char *colour )
+{
+    const double from = std::max( frame->x_min, series.sorted.front() );
+    const double to   = std::min( frame->x_max, series.sorted.back() );
+
+    latency_kde_t kde;
+
+    if( !( to > from ) || !latency_kde_estimate( series.sorted, adjust, from, to, LATENCY_KDE_DEFAULT_GRID, &kde ) )
+    {
+        return;
+    }
+
+    const double peak = *std::max_element( kde.density.begin(), kde.density.end() );
+
+    if( !( peak > 0.0 ) )
+    {
+        return;
+    }
+
+    const double spacing = ( to - from ) / (double)( kde.density.size() - 1 );
+
+    svg_printf( svg, "<path d=\"M%.2f %.2f", svg_x( frame, from ), baseline );
+
+    for( size_t i = 0; i < kde.density.size(); i++ )
+    {
+        svg_printf( svg, " L%.2f %.2f", svg_x( frame, from + spacing * (double)i ), baseline - kde.density[i] / peak * height );
+    }
+
+    svg_printf( svg,
+                " L%.2f %.2f Z\" fill=\"%s\" fill-opacity=\"0.7\" stroke=\"%s\" stroke-width=\"0.8\" clip-path=\"url(#plot)\"/>\n",
+                svg_x( frame, to ),
+                baseline,
+                colour,
+                SVG_INK_COLOUR );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void svg_x_axis( std::string *svg, const svg_frame_t *frame, const svg_chart_options_t &options )
+{
+    const double bottom = frame->top + frame->height;
+    const double top    = frame->top - ( ( options.kind == SVG_CHART_RIDGELINE ) ? SVG_RIDGE_ROW_HEIGHT : 0.0 );
+
+    for( double tick = ceil( frame->x_min / frame->step - 1e-9 ) * frame->step; tick <= frame->x_max + frame->step * 1e-9; tick += frame->step )
+    {
+        const double x = svg_x( frame, tick );
+        char         label[32];
+
+        // Rounding noise would print 0.30000000000000004, and ceil() of a tiny
+        // negative gives -0
+        snprintf( label, sizeof( label ), "%g", round( tick / frame->step ) * frame->step + 0.0 );
+
+        svg_printf( svg, "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke=\"%s\"/>\n", x, top, x, bottom, SVG_GRID_COLOUR );
+        svg_text( svg, x, bottom + 24.0, SVG_TEXT_SIZE, "middle", false, label );
+    }
+
+    const double centre = frame->left + frame->width / 2.0;
+
+    svg_text( svg, centre, bottom + 60.0, SVG_TEXT_SIZE + 2, "middle", false, options.x_label );
+    svg_text( svg, centre, bottom + 92.0, SVG_TEXT_SIZE, "middle", false, options.caption );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Samples past the right edge are counted rather than silently dropped
+static void svg_clipped_count( std::string *svg, const svg_frame_t *frame, const svg_series_t &series, double y )
+{
+    const size_t beyond = (size_t)( series.sorted.end() - std::upper_bound( series.sorted.begin(), series.sorted.end(), frame->x_max ) );
+
+    if( beyond )
+    {
+        char label[48];
+        snprintf( label, sizeof( label ), "+%zu >", beyond );
+        svg_text( svg, frame->left + frame->width + 8.0, y, SVG_TEXT_SIZE - 2, "start", false, label );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void svg_render_box( std::string *svg, const svg_frame_t *frame, const std::vector<svg_series_t> &series, const svg_chart_options_t &options )
+{
+    for( size_t i = 0; i < series.size(); i++ )
+    {
+        const svg_series_t &entry  = series[i];
+        const double        row    = frame->top + (double)i * SVG_BOX_ROW_HEIGHT;
+        const double        centre = row + 0.6 * SVG_BOX_ROW_HEIGHT;
+        const double        half   = 0.1 * SVG_BOX_ROW_HEIGHT;
+
+        svg_text( svg, frame->left - 12.0, centre + 5.0, SVG_TEXT_SIZE, "end", true, entry.name );
+
+        svg_density_path( svg, frame, entry, options.adjust, centre - half - 4.0, 0.45 * SVG_BOX_ROW_HEIGHT, svg_palette[i % SVG_PALETTE_SIZE] );
+
+        // geom_boxplot: hinges at the quartiles, whiskers to the furthest sample within 1.5 IQR
+        const double q1     = svg_type7( entry.sorted, 0.25 );
+        const double median = svg_type7( entry.sorted, 0.5 );
+        const double q3     = svg_type7( entry.sorted, 0.75 );
+        const double reach  = 1.5 * ( q3 - q1 );
+        const double low    = *std::lower_bound( entry.sorted.begin(), entry.sorted.end(), q1 - reach );
+        const double high   = *( std::upper_bound( entry.sorted.begin(), entry.sorted.end(), q3 + reach ) - 1 );
+
+        svg_printf( svg, "<g clip-path=\"url(#plot)\" stroke=\"%s\">\n", SVG_INK_COLOUR );
+        svg_printf( svg,
+                    "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\"/><line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\"/>\n",
+                    svg_x( frame, low ),
+                    centre,
+                    svg_x( frame, q1 ),
+                    centre,
+                    svg_x( frame, q3 ),
+                    centre,
+                    svg_x( frame, high ),
+                    centre );
+        svg_printf( svg,
+                    "<rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\" fill=\"white\"/>\n",
+                    svg_x( frame, q1 ),
+                    centre - half,
+                    svg_x( frame, q3 ) - svg_x( frame, q1 ),
+                    2.0 * half );
+        svg_printf( svg,
+                    "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke-width=\"2.5\"/>\n",
+                    svg_x( frame, median ),
+                    centre - half,
+                    svg_x( frame, median ),
+                    centre + half );
+        svg_printf( svg, "</g>\n<g clip-path=\"url(#plot)\" fill=\"black\" fill-opacity=\"0.6\">\n" );
+
+        for( double value : entry.sorted )
+        {
+            if( value < low || value > high )
+            {
+                svg_printf( svg, "<circle cx=\"%.2f\" cy=\"%.2f\" r=\"1.5\"/>", svg_x( frame, value ), centre );
+            }
+        }
+
+        svg_printf( svg, "\n</g>\n" );
+
+        char label[48];
+
+        snprintf( label, sizeof( label ), "%.2f", median );
+        svg_text( svg, svg_x( frame, median ), centre + half + 22.0, SVG_TEXT_SIZE, "middle", true, label );
+
+        snprintf( label, sizeof( label ), "n = %zu", entry.sorted.size() );
+        const double n_x = svg_x( frame, std::min( entry.sorted.back(), frame->x_max ) ) + 10.0;
+        svg_text( svg, std::min( n_x, frame->left + frame->width - 60.0 ), centre - half - 10.0, SVG_TEXT_SIZE - 2, "start", false, label );
+
+        svg_clipped_count( svg, frame, entry, centre + 5.0 );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void svg_render_ridgeline( std::string *svg, const svg_frame_t *frame, const std::vector<svg_series_t> &series, const svg_chart_options_t &options )
+{
+    // Top row first so each ridge overlaps the one above it
+    for( size_t i = 0; i < series.size(); i++ )
+    {
+        const svg_series_t &entry    = series[i];
+        const double        baseline = frame->top + (double)( i + 1 ) * SVG_RIDGE_ROW_HEIGHT;
+        const double        median   = svg_type7( entry.sorted, 0.5 );
+
+        svg_printf( svg,
+                    "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke=\"%s\"/>\n",
+                    frame->left,
+                    baseline,
+                    frame->left + frame->width,
+                    baseline,
+                    SVG_GRID_COLOUR );
+
+        svg_density_path( svg, frame, entry, options.adjust, baseline, 1.8 * SVG_RIDGE_ROW_HEIGHT, svg_palette[i % SVG_PALETTE_SIZE] );
+
+        if( median >= frame->x_min && median <= frame->x_max )
+        {
+            svg_printf( svg,
+                        "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke=\"%s\" stroke-dasharray=\"4 3\"/>\n",
+                        svg_x( frame, median ),
+                        baseline,
+                        svg_x( frame, median ),
+                        baseline - 0.5 * SVG_RIDGE_ROW_HEIGHT,
+                        SVG_INK_COLOUR );
+        }
+
+        svg_text( svg, frame->left - 12.0, baseline - 4.0, SVG_TEXT_SIZE, "end", true, entry.name );
+        svg_clipped_count( svg, frame, entry, baseline - 4.0 );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void svg_render_cdf( std::string *svg, const svg_frame_t *frame, const std::vector<svg_series_t> &series )
+{
+    const double bottom = frame->top + frame->height;
+
+    for( int percent = 0; percent <= 100; percent += 25 )
+    {
+        const double y = bottom - frame->height * percent / 100.0;
+        char         label[16];
+
+        snprintf( label, sizeof( label ), "%d%%", percent );
+        svg_printf( svg,
+                    "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke=\"%s\"/>\n",
+                    frame->left,
+                    y,
+                    frame->left + frame->width,
+                    y,
+                    SVG_GRID_COLOUR );
+        svg_text( svg, frame->left - 10.0, y + 5.0, SVG_TEXT_SIZE, "end", false, label );
+    }
+
+    svg_printf( svg,
+                "<text transform=\"translate(%.2f %.2f) rotate(-90)\" font-size=\"%d\" text-anchor=\"middle\" fill=\"%s\">"
+                "Cumulative Distribution of Results</text>\n",
+                frame->left - 78.0,
+                frame->top + frame->height / 2.0,
+                SVG_TEXT_SIZE + 2,
+                SVG_INK_COLOUR );
+
+    for( size_t i = 0; i < series.size(); i++ )
+    {
+        const svg_series_t &entry = series[i];
+        const size_t        n     = entry.sorted.size();
+
+        // Exact steps for small samples, evenly spaced ranks beyond that
+        svg_printf( svg, "<path d=\"M%.2f %.2f", svg_x( frame, entry.sorted.front() ), bottom );
+
+        if( n <= SVG_CDF_MAX_POINTS )
+        {
+            for( size_t r = 0; r < n; r++ )
+            {
+                svg_printf( svg, " H%.2f V%.2f", svg_x( frame, entry.sorted[r] ), bottom - frame->height * (double)( r + 1 ) / (double)n );
+            }
+        }
+        else
+        {
+            for( size_t p = 1; p <= SVG_CDF_MAX_POINTS; p++ )
+            {
+                const size_t r = p * n / SVG_CDF_MAX_POINTS - 1;
+                svg_printf( svg, " L%.2f %.2f", svg_x( frame, entry.sorted[r] ), bottom - frame->height * (double)( r + 1 ) / (double)n );
+            }
+        }
+
+        svg_printf( svg,
+                    " H%.2f\" fill=\"none\" stroke=\"%s\" stroke-width=\"2.5\" stroke-dasharray=\"%s\" clip-path=\"url(#plot)\"/>\n",
+                    frame->left + frame->width,
+                    svg_palette[i % SVG_PALETTE_SIZE],
+                    svg_dashes[( i / SVG_PALETTE_SIZE ) % 3] );
+    }
+
+    // Legend in the bottom right, where the curves have already reached 100%
+    size_t longest = 0;
+
+    for( const svg_series_t &entry : series )
+    {
+        longest = std::max( longest, entry.name.size() );
+    }
+
+    const double entry_height = SVG_CDF_LEGEND_ROW;
+    const double box_width    = (double)longest * SVG_TEXT_SIZE * SVG_CHAR_WIDTH + 60.0;
+    const double box_height   = entry_height * (double)series.size() + 12.0;
+    const double box_x        = frame->left + frame->width - box_width - 10.0;
+    const double box_y        = std::max( frame->top + 10.0, bottom - box_height - 40.0 );
+
+    svg_printf( svg,
+                "<rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\" fill=\"white\" stroke=\"%s\"/>\n",
+                box_x,
+                box_y,
+                box_width,
+                box_height,
+                SVG_GRID_COLOUR );
+
+    for( size_t i = 0; i < series.size(); i++ )
+    {
+        const double y = box_y + 6.0 + entry_height * ( (double)i + 0.5 );
+
+        svg_printf( svg,
+                    "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke=\"%s\" stroke-width=\"3\" stroke-dasharray=\"%s\"/>\n",
+                    box_x + 10.0,
+                    y,
+                    box_x + 38.0,
+                    y,
+                    svg_palette[i % SVG_PALETTE_SIZE],
+                    svg_dashes[( i / SVG_PALETTE_SIZE ) % 3] );
+        svg_text( svg, box_x + 46.0, y + 5.0, SVG_TEXT_SIZE - 1, "start", false, series[i].name );
+    }
+}
+
+/* ----- End ---------------------------------------------------------------- */
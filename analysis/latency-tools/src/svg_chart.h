@@ -0,0 +1,62 @@
+#ifndef SVG_CHART_H
+#define SVG_CHART_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef enum
+{
+    SVG_CHART_BOX,          // half-eye density over a boxplot per column, like ridgeline.R
+    SVG_CHART_RIDGELINE,    // overlapping densities, like uart-overhead-facet-ridgelines.R
+    SVG_CHART_CDF,          // empirical CDF lines with a legend, like cdf.R
+} svg_chart_kind_t;
+
+typedef struct
+{
+    std::string         name;
+    std::vector<double> values;     // any order, NaN (NA) is skipped
+} svg_chart_series_t;
+
+typedef struct
+{
+    svg_chart_kind_t kind;
+    std::string      title;
+    std::string      subtitle;
+    std::string      x_label;
+    std::string      caption;
+    double           x_min;         // NaN picks bounds from the data
+    double           x_max;
+    double           adjust;        // bandwidth multiplier, the R scripts use 0.3
+    uint32_t         width;         // pixels, height follows from the series count
+} svg_chart_options_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Fills options with the look of the R charts: 0.3 bandwidth adjust, automatic
+ *  x bounds, "Lower is better" caption.
+ */
+
+void svg_chart_defaults( svg_chart_options_t *options );
+
+/* -------------------------------------------------------------------------- */
+
+/** Renders the chart to an SVG document. Automatic bounds start at 0 for
+ *  latencies and end just past the largest 99.5th percentile so a few
+ *  outliers can't squash the distributions, clipped samples are counted
+ *  at the right edge.
+ */
+
+bool svg_chart_render( const std::vector<svg_chart_series_t> &series, const svg_chart_options_t &options, std::string *svg );
+
+/* -------------------------------------------------------------------------- */
+
+bool svg_chart_write( const char *path, const std::vector<svg_chart_series_t> &series, const svg_chart_options_t &options );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* SVG_CHART_H */
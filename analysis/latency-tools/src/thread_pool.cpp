@@ -0,0 +1,171 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "thread_pool.h"
+
+/* ----- Private Variables -------------------------------------------------- */
+
+// Lets submit() tell a worker's own tasks apart from outside callers
+static thread_local const thread_pool_t *pool_current      = 0;
+static thread_local uint32_t             pool_worker_index = 0;
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static void thread_pool_worker( thread_pool_t *pool, uint32_t index );
+static bool thread_pool_take( thread_pool_t *pool, uint32_t index, thread_pool_task_t *task );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void thread_pool_start( thread_pool_t *pool, uint32_t worker_count )
+{
+    if( worker_count == 0 )
+    {
+        worker_count = std::thread::hardware_concurrency();
+        worker_count = worker_count ? worker_count : 1;
+    }
+
+    pool->queued     = 0;
+    pool->pending    = 0;
+    pool->steals     = 0;
+    pool->next_queue = 0;
+    pool->stopping   = false;
+
+    for( uint32_t i = 0; i < worker_count; i++ )
+    {
+        pool->queues.push_back( std::make_unique<thread_pool_queue_t>() );
+    }
+
+    for( uint32_t i = 0; i < worker_count; i++ )
+    {
+        pool->workers.emplace_back( thread_pool_worker, pool, i );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void thread_pool_submit( thread_pool_t *pool, thread_pool_task_t task )
+{
+    const uint32_t index = ( pool_current == pool )
+                           ? pool_worker_index
+                           : pool->next_queue++ % (uint32_t)pool->queues.size();
+
+    // Count before publishing so pending never hits zero while work is in flight
+    pool->pending++;
+    pool->queued++;
+
+    {
+        std::lock_guard<std::mutex> guard( pool->queues[index]->lock );
+        pool->queues[index]->tasks.push_back( std::move( task ) );
+    }
+
+    {
+        std::lock_guard<std::mutex> guard( pool->idle_lock );
+    }
+
+    pool->idle.notify_one();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void thread_pool_wait( thread_pool_t *pool )
+{
+    std::unique_lock<std::mutex> lock( pool->idle_lock );
+    pool->done.wait( lock, [pool] { return pool->pending == 0; } );
+}
+
+/* -------------------------------------------------------------------------- */
+
+void thread_pool_stop( thread_pool_t *pool )
+{
+    thread_pool_wait( pool );
+
+    {
+        std::lock_guard<std::mutex> guard( pool->idle_lock );
+        pool->stopping = true;
+    }
+
+    pool->idle.notify_all();
+
+    for( std::thread &worker : pool->workers )
+    {
+        worker.join();
+    }
+
+    pool->workers.clear();
+    pool->queues.clear();
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static void thread_pool_worker( thread_pool_t *pool, uint32_t index )
+{
+    pool_current      = pool;
+    pool_worker_index = index;
+
+    for( ;; )
+    {
+        thread_pool_task_t task;
+
+        if( thread_pool_take( pool, index, &task ) )
+        {
+            pool->queued--;
+            task();
+
+            if( --pool->pending == 0 )
+            {
+                std::lock_guard<std::mutex> guard( pool->idle_lock );
+                pool->done.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( pool->idle_lock );
+        pool->idle.wait( lock, [pool] { return pool->stopping || pool->queued > 0; } );
+
+        if( pool->stopping && pool->queued == 0 )
+        {
+            return;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool thread_pool_take( thread_pool_t *pool, uint32_t index, thread_pool_task_t *task )
+{
+    const uint32_t count = (uint32_t)pool->queues.size();
+
+    {
+        thread_pool_queue_t *own = pool->queues[index].get();
+        std::lock_guard<std::mutex> guard( own->lock );
+
+        if( !own->tasks.empty() )
+        {
+            *task = std::move( own->tasks.back() );
+            own->tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest task from the next busy worker, oldest tasks tend to be the
+    // biggest (a whole directory rather than a single file)
+    for( uint32_t offset = 1; offset < count; offset++ )
+    {
+        thread_pool_queue_t *victim = pool->queues[( index + offset ) % count].get();
+        std::lock_guard<std::mutex> guard( victim->lock );
+
+        if( !victim->tasks.empty() )
+        {
+            *task = std::move( victim->tasks.front() );
+            victim->tasks.pop_front();
+            pool->steals++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,68 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef std::function<void( void )> thread_pool_task_t;
+
+typedef struct
+{
+    std::mutex                     lock;
+    std::deque<thread_pool_task_t> tasks;
+} thread_pool_queue_t;
+
+// Work-stealing pool: each worker pops its own queue from the back (most recently
+// pushed, cache warm) and steals from the front of the others when it runs dry.
+// Tasks submitted from inside a task go onto the submitting worker's queue, so
+// recursive jobs like a directory walk spread out naturally.
+typedef struct
+{
+    std::vector<std::thread>                          workers;
+    std::vector<std::unique_ptr<thread_pool_queue_t>> queues;
+    std::atomic<uint64_t>                             queued;       // sitting in a queue
+    std::atomic<uint64_t>                             pending;      // submitted, not yet finished
+    std::atomic<uint64_t>                             steals;
+    std::atomic<uint32_t>                             next_queue;   // round robin for outside submits
+    std::atomic<bool>                                 stopping;
+    std::mutex                                        idle_lock;
+    std::condition_variable                           idle;         // work arrived or stopping
+    std::condition_variable                           done;         // pending reached zero
+} thread_pool_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Starts worker_count threads, 0 picks one per hardware thread */
+
+void thread_pool_start( thread_pool_t *pool, uint32_t worker_count );
+
+/* -------------------------------------------------------------------------- */
+
+void thread_pool_submit( thread_pool_t *pool, thread_pool_task_t task );
+
+/* -------------------------------------------------------------------------- */
+
+/** Blocks until every submitted task (including ones they submitted) has finished */
+
+void thread_pool_wait( thread_pool_t *pool );
+
+/* -------------------------------------------------------------------------- */
+
+/** Finishes queued work and joins the workers */
+
+void thread_pool_stop( thread_pool_t *pool );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* THREAD_POOL_H */
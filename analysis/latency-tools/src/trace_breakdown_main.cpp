@@ -0,0 +1,155 @@
+/* -------------------------------------------------------------------------- */
+
+// Breaks each frame the firmware traced into its stages (trigger interrupt
+// to send call, send to the stack's completion, receive to validation...)
+// and summarises every stage, to see where the time between the trigger and
+// done edges goes. Optionally writes the stages in the wide csv layout.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+#include "latency_stats.h"
+#include "trace_dump.h"
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name );
+static bool process_file( const std::string &path, const std::string &prefix, std::vector<latency_column_t> *columns );
+
+/* -------------------------------------------------------------------------- */
+
+int main( int argc, char *argv[] )
+{
+    std::string              output;
+    std::vector<std::string> inputs;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            output = argv[++i];
+        }
+        else if( strcmp( argv[i], "-h" ) == 0 || strcmp( argv[i], "--help" ) == 0 )
+        {
+            print_usage( argv[0] );
+            return 0;
+        }
+        else
+        {
+            inputs.push_back( argv[i] );
+        }
+    }
+
+    if( inputs.empty() )
+    {
+        print_usage( argv[0] );
+        return 1;
+    }
+
+    std::vector<latency_column_t> columns;
+
+    for( const std::string &path : inputs )
+    {
+        printf( "Processing file: %s\n", path.c_str() );
+
+        // Boards are traced separately, keep their stages apart
+        const std::string prefix = ( inputs.size() > 1 ) ? std::filesystem::path( path ).stem().string() + "/" : "";
+
+        if( !process_file( path, prefix, &columns ) )
+        {
+            return 1;
+        }
+    }
+
+    if( !output.empty() && !latency_columns_write_csv( output.c_str(), columns ) )
+    {
+        fprintf( stderr, "Failed to write %s\n", output.c_str() );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_usage( const char *name )
+{
+    printf( "Usage: %s [-o trace_df.csv] dump ...\n", name );
+    printf( "Each dump is either a trace_ring_t read off the board with a debugger\n" );
+    printf( "(e.g. gdb's dump binary value trace.bin trace_ring) or a console log with\n" );
+    printf( "the trace printouts. Prints the time spent in each stage per dump, and\n" );
+    printf( "with -o writes a column of durations (ms) per stage.\n" );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool process_file( const std::string &path, const std::string &prefix, std::vector<latency_column_t> *columns )
+{
+    trace_dump_t dump;
+
+    if( !trace_dump_read( path, &dump ) )
+    {
+        fprintf( stderr, "%s: %s\n", path.c_str(), dump.error.c_str() );
+        return false;
+    }
+
+    std::vector<latency_column_t> stages;
+    trace_breakdown_info_t        info;
+
+    trace_dump_breakdown( dump, &stages, &info );
+
+    printf( "  %zu records at %u cycles/us, %llu frames, %llu partial frames dropped\n",
+            dump.records.size(),
+            dump.cycles_per_us,
+            (unsigned long long)info.frames,
+            (unsigned long long)info.dropped );
+
+    if( stages.empty() )
+    {
+        return true;
+    }
+
+    printf( "  %-24s %8s %10s %10s %10s %10s %7s\n", "stage", "n", "median us", "p90 us", "p99 us", "max us", "share" );
+
+    for( latency_column_t &stage : stages )
+    {
+        latency_stats_t   stats;
+        latency_summary_t summary;
+        double            total_ms = 0.0;
+
+        latency_stats_init( &stats, 0 );
+
+        for( double ms : stage.values )
+        {
+            latency_stats_add( &stats, ms );
+            total_ms += ms;
+        }
+
+        latency_stats_summarise( &stats, &summary );
+
+        // Share of all the traced frame time, chunked stages add up over a frame
+        printf( "  %-24s %8llu %10.1f %10.1f %10.1f %10.1f %6.1f%%\n",
+                stage.name.c_str(),
+                (unsigned long long)summary.count,
+                summary.p50 * 1000.0,
+                summary.p90 * 1000.0,
+                summary.p99 * 1000.0,
+                summary.max * 1000.0,
+                info.frame_ms > 0.0 ? 100.0 * total_ms / info.frame_ms : 0.0 );
+
+        stage.name = prefix + stage.name;
+        columns->push_back( std::move( stage ) );
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,327 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "trace_dump.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define TRACE_DUMP_MAGIC         (0x45435254u)
+#define TRACE_DUMP_VERSION       (1u)
+#define TRACE_DUMP_HEADER_LENGTH (16u)
+#define TRACE_DUMP_RECORD_LENGTH (8u)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool trace_dump_read_binary( FILE *f, trace_dump_t *dump );
+static bool trace_dump_read_text( FILE *f, trace_dump_t *dump );
+static void trace_dump_close_frame( std::vector<trace_dump_record_t> *frame,
+                                    bool                              whole,
+                                    bool                              counted,
+                                    double                            ms_per_cycle,
+                                    std::vector<latency_column_t>    *stages,
+                                    trace_breakdown_info_t           *info );
+static void trace_dump_add( std::vector<latency_column_t> *stages, const std::string &name, double ms );
+static uint32_t trace_dump_u32( const uint8_t *p );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool trace_dump_read( const std::string &path, trace_dump_t *dump )
+{
+    dump->cycles_per_us = 0;
+    dump->records.clear();
+    dump->error.clear();
+
+    FILE *f = fopen( path.c_str(), "rb" );
+
+    if( !f )
+    {
+        dump->error = "can't open";
+        return false;
+    }
+
+    uint8_t magic[4];
+    bool    binary = fread( magic, sizeof( magic ), 1, f ) == 1 && trace_dump_u32( magic ) == TRACE_DUMP_MAGIC;
+
+    rewind( f );
+
+    const bool ok = binary ? trace_dump_read_binary( f, dump ) : trace_dump_read_text( f, dump );
+
+    fclose( f );
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void trace_dump_breakdown( const trace_dump_t &dump, std::vector<latency_column_t> *stages, trace_breakdown_info_t *info )
+{
+    const double ms_per_cycle = 1.0 / ( (double)dump.cycles_per_us * 1000.0 );
+
+    std::vector<trace_dump_record_t> frame;
+    bool                             whole   = false;
+    bool                             counted = false;     // the cut frame is already dropped
+
+    stages->clear();
+    info->frames   = 0;
+    info->dropped  = 0;
+    info->frame_ms = 0.0;
+
+    // Runs of consecutive sequence numbers, a gap means records are missing
+    for( size_t start = 0, end; start < dump.records.size(); start = end )
+    {
+        for( end = start + 1; end < dump.records.size() && dump.records[end].sequence == dump.records[end - 1].sequence + 1; end++ )
+        {
+        }
+
+        // An interrupt can land between a task reading the counter and
+        // claiming its slot, so restore time order before splitting frames.
+        // Signed differences survive the counter wrapping.
+        std::vector<trace_dump_record_t> run( dump.records.begin() + start, dump.records.begin() + end );
+
+        for( size_t i = 1; i < run.size(); i++ )
+        {
+            for( size_t j = i; j > 0 && (int32_t)( run[j].cycles - run[j - 1].cycles ) < 0; j-- )
+            {
+                std::swap( run[j], run[j - 1] );
+            }
+        }
+
+        // Whatever frame is open lost some of its stages, and the rest of it
+        // starts the run
+        counted = !frame.empty();
+
+        if( counted )
+        {
+            info->dropped++;
+            frame.clear();
+        }
+
+        // Unless the board started over, the first frame may be cut too
+        whole = ( dump.records[start].sequence == 0 );
+
+        for( const trace_dump_record_t &record : run )
+        {
+            if( record.event == TRACE_DUMP_EVENT_TRIGGER )
+            {
+                trace_dump_close_frame( &frame, whole, counted, ms_per_cycle, stages, info );
+                whole   = true;
+                counted = false;
+            }
+
+            frame.push_back( record );
+
+            if( record.event == TRACE_DUMP_EVENT_VALID )
+            {
+                trace_dump_close_frame( &frame, whole, counted, ms_per_cycle, stages, info );
+                whole   = true;
+                counted = false;
+            }
+        }
+    }
+
+    // Could have still been in flight when the trace was read
+    if( !frame.empty() )
+    {
+        info->dropped++;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string trace_dump_event_name( uint16_t event )
+{
+    switch( event )
+    {
+        case TRACE_DUMP_EVENT_TRIGGER:
+            return "trigger";
+        case TRACE_DUMP_EVENT_SEND:
+            return "send";
+        case TRACE_DUMP_EVENT_SEND_DONE:
+            return "send_done";
+        case TRACE_DUMP_EVENT_RECV:
+            return "recv";
+        case TRACE_DUMP_EVENT_VALID:
+            return "valid";
+        default:
+            return "event-" + std::to_string( event );
+    }
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// The struct as the firmware lays it out, little endian
+static bool trace_dump_read_binary( FILE *f, trace_dump_t *dump )
+{
+    uint8_t header[TRACE_DUMP_HEADER_LENGTH];
+
+    if( fread( header, sizeof( header ), 1, f ) != 1 )
+    {
+        dump->error = "truncated header";
+        return false;
+    }
+
+    const uint32_t version = trace_dump_u32( header + 4 ) & 0xFFFFu;
+    const uint32_t length  = trace_dump_u32( header + 4 ) >> 16;
+    const uint32_t head    = trace_dump_u32( header + 12 );
+
+    if( version != TRACE_DUMP_VERSION )
+    {
+        dump->error = "unsupported trace version";
+        return false;
+    }
+
+    if( !length || ( length & ( length - 1 ) ) )
+    {
+        dump->error = "ring length isn't a power of two";
+        return false;
+    }
+
+    std::vector<uint8_t> records( (size_t)length * TRACE_DUMP_RECORD_LENGTH );
+
+    if( fread( records.data(), records.size(), 1, f ) != 1 )
+    {
+        dump->error = "truncated records";
+        return false;
+    }
+
+    dump->cycles_per_us = trace_dump_u32( header + 8 );
+
+    if( !dump->cycles_per_us )
+    {
+        dump->error = "no clock rate";
+        return false;
+    }
+
+    // Oldest surviving record first
+    const uint32_t count = ( head < length ) ? head : length;
+
+    for( uint32_t sequence = head - count; sequence != head; sequence++ )
+    {
+        const uint8_t      *p = &records[(size_t)( sequence & ( length - 1 ) ) * TRACE_DUMP_RECORD_LENGTH];
+        trace_dump_record_t record;
+
+        record.sequence = sequence;
+        record.cycles   = trace_dump_u32( p );
+        record.event    = (uint16_t)( trace_dump_u32( p + 4 ) & 0xFFFFu );
+        record.arg      = (uint16_t)( trace_dump_u32( p + 4 ) >> 16 );
+
+        dump->records.push_back( record );
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool trace_dump_read_text( FILE *f, trace_dump_t *dump )
+{
+    char line[512];
+
+    while( fgets( line, sizeof( line ), f ) )
+    {
+        const char *at;
+        unsigned    a, b, c, d;
+
+        if( ( at = strstr( line, "trace-ring " ) ) && sscanf( at, "trace-ring %u %u", &a, &b ) == 2 )
+        {
+            dump->cycles_per_us = a;
+        }
+        else if( ( at = strstr( line, "trace " ) ) && sscanf( at, "trace %u %u %u %u", &a, &b, &c, &d ) == 4 )
+        {
+            trace_dump_record_t record;
+
+            record.sequence = a;
+            record.event    = (uint16_t)b;
+            record.arg      = (uint16_t)c;
+            record.cycles   = d;
+
+            dump->records.push_back( record );
+        }
+    }
+
+    if( dump->records.empty() || !dump->cycles_per_us )
+    {
+        dump->error = "no trace-ring printout";
+        return false;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void trace_dump_close_frame( std::vector<trace_dump_record_t> *frame,
+                                    bool                              whole,
+                                    bool                              counted,
+                                    double                            ms_per_cycle,
+                                    std::vector<latency_column_t>    *stages,
+                                    trace_breakdown_info_t           *info )
+{
+    if( frame->empty() )
+    {
+        return;
+    }
+
+    if( !whole )
+    {
+        if( !counted )
+        {
+            info->dropped++;
+        }
+
+        frame->clear();
+        return;
+    }
+
+    // A trigger that never sent anything has nothing to break down
+    if( frame->size() > 1 )
+    {
+        for( size_t i = 1; i < frame->size(); i++ )
+        {
+            const trace_dump_record_t &from = ( *frame )[i - 1];
+            const trace_dump_record_t &to   = ( *frame )[i];
+
+            trace_dump_add( stages,
+                            trace_dump_event_name( from.event ) + "-" + trace_dump_event_name( to.event ),
+                            ( to.cycles - from.cycles ) * ms_per_cycle );
+        }
+
+        const double frame_ms = ( frame->back().cycles - frame->front().cycles ) * ms_per_cycle;
+
+        trace_dump_add( stages, "frame", frame_ms );
+        info->frames++;
+        info->frame_ms += frame_ms;
+    }
+
+    frame->clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void trace_dump_add( std::vector<latency_column_t> *stages, const std::string &name, double ms )
+{
+    // Only a handful of stages, in the order they first show up
+    for( latency_column_t &column : *stages )
+    {
+        if( column.name == name )
+        {
+            column.values.push_back( ms );
+            return;
+        }
+    }
+
+    stages->push_back( { name, { ms } } );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t trace_dump_u32( const uint8_t *p )
+{
+    return (uint32_t)p[0] | ( (uint32_t)p[1] << 8 ) | ( (uint32_t)p[2] << 16 ) | ( (uint32_t)p[3] << 24 );
+}
+
+/* ----- End ---------------------------------------------------------------- */
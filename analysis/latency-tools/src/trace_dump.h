@@ -0,0 +1,78 @@
+#ifndef TRACE_DUMP_H
+#define TRACE_DUMP_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "latency_columns.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Stage ids as firmware/common/trace_ring.h numbers them
+enum
+{
+    TRACE_DUMP_EVENT_TRIGGER   = 1,
+    TRACE_DUMP_EVENT_SEND      = 2,
+    TRACE_DUMP_EVENT_SEND_DONE = 3,
+    TRACE_DUMP_EVENT_RECV      = 4,
+    TRACE_DUMP_EVENT_VALID     = 5,
+};
+
+typedef struct
+{
+    uint32_t sequence;      // position in the board's trace since boot
+    uint32_t cycles;
+    uint16_t event;
+    uint16_t arg;
+} trace_dump_record_t;
+
+// Trace pulled off one board, see firmware/common/trace_ring.h
+typedef struct
+{
+    uint32_t                         cycles_per_us;
+    std::vector<trace_dump_record_t> records;       // in the order written
+    std::string                      error;         // why the read failed
+} trace_dump_t;
+
+typedef struct
+{
+    uint64_t frames;        // broken down
+    uint64_t dropped;       // cut off by the ring wrapping or a gap in the log
+    double   frame_ms;      // total time of those frames
+} trace_breakdown_info_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Reads either a raw trace_ring_t dumped with a debugger, or a console log
+ *  holding trace_ring_print() output. Printouts of a log are joined, they
+ *  only hold the records written since the previous one.
+ */
+
+bool trace_dump_read( const std::string &path, trace_dump_t *dump );
+
+/* -------------------------------------------------------------------------- */
+
+/** Splits the records into frames and times every step between consecutive
+ *  records of a frame, one column (ms) per pair of stages such as
+ *  "trigger-send" or "recv-valid", plus the whole frame as "frame". A frame
+ *  starts at a trigger or after the previous frame's valid event, and ends at
+ *  valid or the next trigger. Frames that were only partly captured are
+ *  dropped, as is the last one when it may still have been in progress.
+ */
+
+void trace_dump_breakdown( const trace_dump_t &dump, std::vector<latency_column_t> *stages, trace_breakdown_info_t *info );
+
+/* -------------------------------------------------------------------------- */
+
+/** "trigger", "send_done" etc, or "event-<id>" for ids this tool doesn't know */
+
+std::string trace_dump_event_name( uint16_t event );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* TRACE_DUMP_H */
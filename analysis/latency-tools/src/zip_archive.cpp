@@ -0,0 +1,361 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "zip_archive.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define ZIP_SIG_LOCAL_HEADER   (0x04034b50u)
+#define ZIP_SIG_CENTRAL_HEADER (0x02014b50u)
+#define ZIP_SIG_END            (0x06054b50u)
+#define ZIP_SIG_END64          (0x06064b50u)
+#define ZIP_SIG_END64_LOCATOR  (0x07064b50u)
+
+#define ZIP_LOCAL_HEADER_SIZE   (30u)
+#define ZIP_CENTRAL_HEADER_SIZE (46u)
+#define ZIP_END_SIZE            (22u)
+#define ZIP_END64_SIZE          (56u)
+#define ZIP_END64_LOCATOR_SIZE  (20u)
+#define ZIP_MAX_COMMENT         (0xFFFFu)
+
+#define ZIP_EXTRA_ZIP64 (0x0001u)
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint16_t zip_u16( const uint8_t *p );
+static uint32_t zip_u32( const uint8_t *p );
+static uint64_t zip_u64( const uint8_t *p );
+static bool zip_read_file( const char *path, std::vector<uint8_t> *data );
+static bool zip_find_central_directory( const zip_archive_t *zip, uint64_t *offset, uint64_t *count );
+static bool zip_apply_zip64_extra( const uint8_t *extra, uint16_t length, zip_entry_t *entry );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+bool zip_archive_open( zip_archive_t *zip, const char *path )
+{
+    zip->data.clear();
+    zip->entries.clear();
+
+    if( !zip_read_file( path, &zip->data ) )
+    {
+        return false;
+    }
+
+    uint64_t offset = 0;
+    uint64_t count  = 0;
+
+    if( !zip_find_central_directory( zip, &offset, &count ) )
+    {
+        return false;
+    }
+
+    const uint8_t *data = zip->data.data();
+    const uint64_t size = zip->data.size();
+
+    for( uint64_t i = 0; i < count; i++ )
+    {
+        if( offset + ZIP_CENTRAL_HEADER_SIZE > size || zip_u32( data + offset ) != ZIP_SIG_CENTRAL_HEADER )
+        {
+            return false;
+        }
+
+        const uint8_t *header         = data + offset;
+        const uint16_t name_length    = zip_u16( header + 28 );
+        const uint16_t extra_length   = zip_u16( header + 30 );
+        const uint16_t comment_length = zip_u16( header + 32 );
+
+        if( offset + ZIP_CENTRAL_HEADER_SIZE + name_length + extra_length + comment_length > size )
+        {
+            return false;
+        }
+
+        zip_entry_t entry;
+        entry.method              = zip_u16( header + 10 );
+        entry.crc32               = zip_u32( header + 16 );
+        entry.compressed_size     = zip_u32( header + 20 );
+        entry.uncompressed_size   = zip_u32( header + 24 );
+        entry.local_header_offset = zip_u32( header + 42 );
+        entry.name.assign( (const char *)header + ZIP_CENTRAL_HEADER_SIZE, name_length );
+
+        if( !zip_apply_zip64_extra( header + ZIP_CENTRAL_HEADER_SIZE + name_length, extra_length, &entry ) )
+        {
+            return false;
+        }
+
+        zip->entries.push_back( std::move( entry ) );
+        offset += ZIP_CENTRAL_HEADER_SIZE + name_length + extra_length + comment_length;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const zip_entry_t *zip_archive_find( const zip_archive_t *zip, const char *name )
+{
+    for( const zip_entry_t &entry : zip->entries )
+    {
+        if( entry.name == name )
+        {
+            return &entry;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool zip_archive_extract( const zip_archive_t *zip, const zip_entry_t *entry, std::vector<uint8_t> *out )
+{
+    const uint8_t *data   = zip->data.data();
+    const uint64_t size   = zip->data.size();
+    const uint64_t offset = entry->local_header_offset;
+
+    if( offset + ZIP_LOCAL_HEADER_SIZE > size || zip_u32( data + offset ) != ZIP_SIG_LOCAL_HEADER )
+    {
+        return false;
+    }
+
+    // The local header's name/extra lengths can differ from the central directory copy
+    const uint64_t start = offset + ZIP_LOCAL_HEADER_SIZE
+                           + zip_u16( data + offset + 26 )
+                           + zip_u16( data + offset + 28 );
+
+    if( start > size || entry->compressed_size > size - start )
+    {
+        return false;
+    }
+
+    out->resize( entry->uncompressed_size );
+
+    if( entry->method == 0 )
+    {
+        if( entry->compressed_size != entry->uncompressed_size )
+        {
+            return false;
+        }
+
+        memcpy( out->data(), data + start, entry->uncompressed_size );
+    }
+    else if( entry->method == 8 )
+    {
+        z_stream stream;
+        memset( &stream, 0, sizeof( stream ) );
+
+        // Negative window bits: raw deflate without a zlib header
+        if( inflateInit2( &stream, -MAX_WBITS ) != Z_OK )
+        {
+            return false;
+        }
+
+        // zlib counts in uInt, feed large entries through in slices
+        const uint64_t slice     = 1u << 30;
+        uint64_t       remaining = entry->compressed_size;
+        int            status    = Z_OK;
+
+        stream.next_in  = (Bytef *)( data + start );
+        stream.next_out = out->data();
+
+        uint64_t out_remaining = entry->uncompressed_size;
+
+        while( status == Z_OK )
+        {
+            if( stream.avail_in == 0 )
+            {
+                stream.avail_in = (uInt)( remaining < slice ? remaining : slice );
+                remaining -= stream.avail_in;
+            }
+
+            if( stream.avail_out == 0 )
+            {
+                stream.avail_out = (uInt)( out_remaining < slice ? out_remaining : slice );
+                out_remaining -= stream.avail_out;
+            }
+
+            // Truncated or oversized streams stop making progress and return Z_BUF_ERROR
+            status = inflate( &stream, Z_NO_FLUSH );
+        }
+
+        const bool complete = ( status == Z_STREAM_END )
+                              && ( stream.avail_out == 0 )
+                              && ( out_remaining == 0 );
+        inflateEnd( &stream );
+
+        if( !complete )
+        {
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    // crc32() also takes a uInt length
+    uLong          crc = crc32( 0L, Z_NULL, 0 );
+    const uint8_t *p   = out->data();
+    uint64_t       n   = out->size();
+
+    while( n > 0 )
+    {
+        const uInt chunk = (uInt)( n < ( 1u << 30 ) ? n : ( 1u << 30 ) );
+        crc = crc32( crc, p, chunk );
+        p += chunk;
+        n -= chunk;
+    }
+
+    return crc == entry->crc32;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static uint16_t zip_u16( const uint8_t *p )
+{
+    return (uint16_t)( p[0] | ( p[1] << 8 ) );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t zip_u32( const uint8_t *p )
+{
+    return (uint32_t)p[0] | ( (uint32_t)p[1] << 8 ) | ( (uint32_t)p[2] << 16 ) | ( (uint32_t)p[3] << 24 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t zip_u64( const uint8_t *p )
+{
+    return (uint64_t)zip_u32( p ) | ( (uint64_t)zip_u32( p + 4 ) << 32 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool zip_read_file( const char *path, std::vector<uint8_t> *data )
+{
+    FILE *file = fopen( path, "rb" );
+
+    if( !file )
+    {
+        return false;
+    }
+
+    bool ok = ( fseek( file, 0, SEEK_END ) == 0 );
+    long length = ok ? ftell( file ) : -1;
+    ok = ok && ( length >= 0 ) && ( fseek( file, 0, SEEK_SET ) == 0 );
+
+    if( ok )
+    {
+        data->resize( (size_t)length );
+        ok = ( fread( data->data(), 1, data->size(), file ) == data->size() );
+    }
+
+    fclose( file );
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool zip_find_central_directory( const zip_archive_t *zip, uint64_t *offset, uint64_t *count )
+{
+    const uint8_t *data = zip->data.data();
+    const uint64_t size = zip->data.size();
+
+    if( size < ZIP_END_SIZE )
+    {
+        return false;
+    }
+
+    // The end record sits behind a variable length comment, scan backwards for it
+    uint64_t end    = size - ZIP_END_SIZE;
+    uint64_t lowest = ( end > ZIP_MAX_COMMENT ) ? end - ZIP_MAX_COMMENT : 0;
+
+    while( zip_u32( data + end ) != ZIP_SIG_END )
+    {
+        if( end == lowest )
+        {
+            return false;
+        }
+
+        end--;
+    }
+
+    *count  = zip_u16( data + end + 10 );
+    *offset = zip_u32( data + end + 16 );
+
+    // Archives over 4GB or 65535 entries keep the real values in the zip64 record
+    if( *offset == 0xFFFFFFFFu || *count == 0xFFFFu )
+    {
+        if( end < ZIP_END64_LOCATOR_SIZE
+            || zip_u32( data + end - ZIP_END64_LOCATOR_SIZE ) != ZIP_SIG_END64_LOCATOR )
+        {
+            return false;
+        }
+
+        const uint64_t end64 = zip_u64( data + end - ZIP_END64_LOCATOR_SIZE + 8 );
+
+        if( end64 + ZIP_END64_SIZE > size || zip_u32( data + end64 ) != ZIP_SIG_END64 )
+        {
+            return false;
+        }
+
+        *count  = zip_u64( data + end64 + 32 );
+        *offset = zip_u64( data + end64 + 48 );
+    }
+
+    return *offset < size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool zip_apply_zip64_extra( const uint8_t *extra, uint16_t length, zip_entry_t *entry )
+{
+    uint16_t pos = 0;
+
+    while( pos + 4 <= length )
+    {
+        const uint16_t id   = zip_u16( extra + pos );
+        const uint16_t size = zip_u16( extra + pos + 2 );
+        const uint8_t *body = extra + pos + 4;
+
+        if( pos + 4 + size > length )
+        {
+            return false;
+        }
+
+        if( id == ZIP_EXTRA_ZIP64 )
+        {
+            // Only the fields saturated in the fixed header are present, in this order
+            uint16_t field = 0;
+
+            if( entry->uncompressed_size == 0xFFFFFFFFu && field + 8 <= size )
+            {
+                entry->uncompressed_size = zip_u64( body + field );
+                field += 8;
+            }
+
+            if( entry->compressed_size == 0xFFFFFFFFu && field + 8 <= size )
+            {
+                entry->compressed_size = zip_u64( body + field );
+                field += 8;
+            }
+
+            if( entry->local_header_offset == 0xFFFFFFFFu && field + 8 <= size )
+            {
+                entry->local_header_offset = zip_u64( body + field );
+                field += 8;
+            }
+        }
+
+        pos += 4 + size;
+    }
+
+    return true;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,51 @@
+#ifndef ZIP_ARCHIVE_H
+#define ZIP_ARCHIVE_H
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    std::string name;
+    uint16_t    method;             // 0 = stored, 8 = deflate
+    uint32_t    crc32;
+    uint64_t    compressed_size;
+    uint64_t    uncompressed_size;
+    uint64_t    local_header_offset;
+} zip_entry_t;
+
+// Minimal read-only zip reader, just enough for Saleae .sal archives
+typedef struct
+{
+    std::vector<uint8_t>     data;
+    std::vector<zip_entry_t> entries;
+} zip_archive_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Reads the archive and its central directory. Returns false if the file can't
+ *  be read or isn't a single-disk zip (zip64 sizes are supported).
+ */
+
+bool zip_archive_open( zip_archive_t *zip, const char *path );
+
+/* -------------------------------------------------------------------------- */
+
+/** Returns the entry with a matching name, or null */
+
+const zip_entry_t *zip_archive_find( const zip_archive_t *zip, const char *name );
+
+/* -------------------------------------------------------------------------- */
+
+/** Decompresses an entry into out and checks its CRC */
+
+bool zip_archive_extract( const zip_archive_t *zip, const zip_entry_t *entry, std::vector<uint8_t> *out );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#endif /* ZIP_ARCHIVE_H */
@@ -0,0 +1,74 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// CRC-16/CCITT-FALSE (poly 0x1021, MSB first), as used by every benchmark
+#define CRC16_SEED (0xFFFFu)
+
+// Number of 256 entry tables kept in flash, 512 B each. 1 is the plain table
+// lookup, 4 and 8 consume that many bytes per step.
+// The STM32F4 CRC peripheral is fixed to the 32-bit polynomial so can't help.
+#ifndef CRC16_SLICES
+    #define CRC16_SLICES 8
+#endif
+
+#if CRC16_SLICES != 1 && CRC16_SLICES != 4 && CRC16_SLICES != 8
+    #error "CRC16_SLICES must be 1, 4 or 8"
+#endif
+
+/* ----- Public Variables --------------------------------------------------- */
+
+extern const uint16_t crc16_table[CRC16_SLICES][256];
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Adds one byte to a running CRC, for parsers that see a byte at a time */
+
+static inline uint16_t crc16_byte( uint16_t crc, uint8_t data )
+{
+    return (uint16_t)( crc << 8 ) ^ crc16_table[0][( crc >> 8 ) ^ data];
+}
+
+/* -------------------------------------------------------------------------- */
+
+/** Adds a block of bytes to a running CRC with the widest kernel built in.
+ *  crc16_block( CRC16_SEED, payload, length ) gives the CRC of a payload.
+ */
+
+uint16_t crc16_block( uint16_t crc, const uint8_t *data, uint32_t length );
+
+/* -------------------------------------------------------------------------- */
+
+/** The shift and xor routine the benchmarks started with, no tables.
+ *  Kept as the reference the table kernels are checked against.
+ */
+
+uint16_t crc16_bitwise( uint16_t crc, const uint8_t *data, uint32_t length );
+
+/* -------------------------------------------------------------------------- */
+
+uint16_t crc16_slice1( uint16_t crc, const uint8_t *data, uint32_t length );
+
+#if CRC16_SLICES >= 4
+uint16_t crc16_slice4( uint16_t crc, const uint8_t *data, uint32_t length );
+#endif
+
+#if CRC16_SLICES >= 8
+uint16_t crc16_slice8( uint16_t crc, const uint8_t *data, uint32_t length );
+#endif
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CRC16_H */
@@ -0,0 +1,171 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "frame_reassembler.h"
+#include "frame_validator.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static uint32_t reassembler_run( frame_reassembler_t *r, const uint8_t *data, uint32_t length );
+static bool reassembler_fragment_done( frame_reassembler_t *r );
+static frame_reassembly_t *reassembler_find( frame_reassembler_t *r, uint8_t sequence, uint8_t count );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void frame_reassembler_init( frame_reassembler_t *r, const uint8_t *payload, uint32_t payload_length )
+{
+    memset( r, 0, sizeof( *r ) );
+
+    r->payload        = payload;
+    r->payload_length = payload_length;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t frame_reassembler_feed( frame_reassembler_t *r, const uint8_t *data, uint32_t length )
+{
+    uint32_t completed = 0;
+
+    // Split at start bytes like frame_validator_feed(), each run is the rest
+    // of one fragment
+    while( length )
+    {
+        if( data[0] == FRAME_START_BYTE )
+        {
+            r->length = 0;
+            r->intact = true;
+        }
+
+        const uint8_t *next = memchr( data + 1, FRAME_START_BYTE, length - 1 );
+        const uint32_t run  = next ? (uint32_t)( next - data ) : length;
+
+        completed += reassembler_run( r, data, run );
+
+        data += run;
+        length -= run;
+    }
+
+    return completed;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// Bytes with no start byte among them (other than possibly the first)
+static uint32_t reassembler_run( frame_reassembler_t *r, const uint8_t *data, uint32_t length )
+{
+    // Header bytes, decoded once they're all in
+    while( r->intact && r->length < FRAME_FRAGMENT_HEADER_LENGTH && length )
+    {
+        r->header_bytes[r->length++] = *data++;
+        length--;
+
+        if( r->length == FRAME_FRAGMENT_HEADER_LENGTH )
+        {
+            const frame_fragment_header_t *h = &r->header;
+
+            r->intact = frame_fragment_header_read( r->header_bytes, &r->header )
+                        && h->length && h->offset >= 1 && h->offset + h->length <= r->payload_length;
+        }
+    }
+
+    if( !r->intact || !length )
+    {
+        return 0;
+    }
+
+    const uint32_t at   = r->length - FRAME_FRAGMENT_HEADER_LENGTH;
+    uint32_t       take = r->header.length - at;
+
+    // Anything past the fragment's stated length is noise
+    if( take > length )
+    {
+        take = length;
+    }
+
+    r->intact = memcmp( data, r->payload + r->header.offset + at, take ) == 0;
+    r->length += take;
+
+    if( r->intact && at + take == r->header.length )
+    {
+        // Counted as soon as its last byte is in, anything after is ignored
+        r->intact = false;
+        return reassembler_fragment_done( r ) ? 1 : 0;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// An intact fragment has arrived, true if it was the last of its frame
+static bool reassembler_fragment_done( frame_reassembler_t *r )
+{
+    frame_reassembly_t *frame = reassembler_find( r, r->header.sequence, r->header.count );
+    const uint32_t      word  = r->header.index / 32;
+    const uint32_t      bit   = 1u << ( r->header.index % 32 );
+
+    if( frame->done || ( frame->seen[word] & bit ) )
+    {
+        r->duplicates++;
+        return false;
+    }
+
+    frame->seen[word] |= bit;
+    frame->received++;
+
+    if( frame->received < frame->count )
+    {
+        return false;
+    }
+
+    frame->active = false;
+    frame->done   = true;
+    r->completed++;
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// The frame a fragment belongs to, opening one if it's new. Windows are a
+// handful of frames so a linear search is plenty.
+static frame_reassembly_t *reassembler_find( frame_reassembler_t *r, uint8_t sequence, uint8_t count )
+{
+    frame_reassembly_t *slot = NULL;
+
+    for( uint32_t i = 0; i < FRAME_SEQUENCE_WINDOW; i++ )
+    {
+        frame_reassembly_t *frame = &r->frames[i];
+
+        if( ( frame->active || frame->done ) && frame->sequence == sequence && frame->count == count )
+        {
+            return frame;
+        }
+
+        // An unused slot, otherwise the frame opened longest ago. Anything
+        // that's been waiting while a window's worth of newer frames opened
+        // isn't coming, and a finished frame lingers to catch late duplicates.
+        if( !slot || ( ( slot->active || slot->done ) && ( !( frame->active || frame->done ) || frame->age < slot->age ) ) )
+        {
+            slot = frame;
+        }
+    }
+
+    if( slot->active )
+    {
+        r->lost++;
+    }
+
+    memset( slot, 0, sizeof( *slot ) );
+    slot->active   = true;
+    slot->sequence = sequence;
+    slot->count    = count;
+    slot->age      = r->age++;
+
+    return slot;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,75 @@
+#ifndef FRAME_REASSEMBLER_H
+#define FRAME_REASSEMBLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "frame_sequencer.h"
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    bool     active;            // still waiting on fragments
+    bool     done;              // complete, kept to spot late duplicates
+    uint8_t  sequence;
+    uint8_t  count;
+    uint8_t  received;
+    uint32_t age;               // opening order, the oldest slot is reused first
+    uint32_t seen[( FRAME_FRAGMENT_COUNT_MAX + 31 ) / 32];
+} frame_reassembly_t;
+
+// Receive side of the sequenced benchmark. Fragments of up to
+// FRAME_SEQUENCE_WINDOW frames can arrive interleaved, out of order or
+// duplicated. Both ends are built with the same generated payload, so each
+// fragment's data is compared byte for byte with the receiver's own copy,
+// which doesn't depend on the order fragments arrive in the way a running
+// CRC would.
+typedef struct
+{
+    const uint8_t          *payload;
+    uint32_t                payload_length;
+    frame_reassembly_t      frames[FRAME_SEQUENCE_WINDOW];
+    uint32_t                age;
+
+    // Fragment being parsed
+    uint8_t                 header_bytes[FRAME_FRAGMENT_HEADER_LENGTH];
+    frame_fragment_header_t header;
+    uint32_t                length;     // bytes since the start byte, header included
+    bool                    intact;     // header valid and the data matched so far
+
+    uint32_t                completed;  // whole frames
+    uint32_t                lost;       // evicted before all their fragments arrived
+    uint32_t                duplicates; // fragments seen before
+} frame_reassembler_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** payload is the receiver's copy of the test payload (payload_length bytes),
+ *  it has to outlive the reassembler
+ */
+
+void frame_reassembler_init( frame_reassembler_t *r, const uint8_t *payload, uint32_t payload_length );
+
+/* -------------------------------------------------------------------------- */
+
+/** Feeds received bytes in place however they're split up. Returns how many
+ *  frames this completed, usually 0 or 1.
+ */
+
+uint32_t frame_reassembler_feed( frame_reassembler_t *r, const uint8_t *data, uint32_t length );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* FRAME_REASSEMBLER_H */
@@ -0,0 +1,160 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "frame_sequencer.h"
+#include "frame_validator.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static void fragment_digits_write( uint8_t *digits, uint32_t value );
+static bool fragment_digits_read( const uint8_t *digits, uint32_t *value );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void frame_sequencer_init( frame_sequencer_t *s, const uint8_t *payload, uint32_t fragment_size )
+{
+    s->payload       = payload;
+    s->fragment_data = fragment_size - FRAME_FRAGMENT_HEADER_LENGTH;
+    s->head          = 0;
+    s->queued        = 0;
+    s->next_sequence = 0;
+    s->dropped       = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool frame_sequencer_queue( frame_sequencer_t *s, uint32_t length )
+{
+    if( s->queued == FRAME_SEQUENCE_WINDOW || length < 2 )
+    {
+        s->dropped++;
+        return false;
+    }
+
+    // Oversized frames would need offsets or fragment numbers the header
+    // can't hold, send as much as fits rather than nothing
+    if( length > FRAME_LENGTH_MAX )
+    {
+        length = FRAME_LENGTH_MAX;
+    }
+
+    frame_sequencer_frame_t *frame = &s->frames[( s->head + s->queued ) % FRAME_SEQUENCE_WINDOW];
+    uint32_t                 count = ( length - 1 + s->fragment_data - 1 ) / s->fragment_data;
+
+    if( count > FRAME_FRAGMENT_COUNT_MAX )
+    {
+        count  = FRAME_FRAGMENT_COUNT_MAX;
+        length = 1 + count * s->fragment_data;
+    }
+
+    frame->sequence = s->next_sequence;
+    frame->index    = 0;
+    frame->count    = (uint8_t)count;
+    frame->offset   = 1;
+    frame->end      = (uint16_t)length;
+
+    s->next_sequence = (uint8_t)( ( s->next_sequence + 1 ) % FRAME_SEQUENCE_MODULO );
+    s->queued++;
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t frame_sequencer_next( frame_sequencer_t *s, uint8_t *fragment )
+{
+    if( !s->queued )
+    {
+        return 0;
+    }
+
+    frame_sequencer_frame_t *frame = &s->frames[s->head];
+    frame_fragment_header_t  header;
+    uint32_t                 length = frame->end - frame->offset;
+
+    if( length > s->fragment_data )
+    {
+        length = s->fragment_data;
+    }
+
+    header.sequence = frame->sequence;
+    header.index    = frame->index;
+    header.count    = frame->count;
+    header.offset   = frame->offset;
+    header.length   = (uint16_t)length;
+
+    frame_fragment_header_write( fragment, &header );
+    memcpy( fragment + FRAME_FRAGMENT_HEADER_LENGTH, s->payload + frame->offset, length );
+
+    frame->index++;
+    frame->offset += length;
+
+    // Last fragment out, move on to the next queued frame
+    if( frame->offset == frame->end )
+    {
+        s->head = ( s->head + 1 ) % FRAME_SEQUENCE_WINDOW;
+        s->queued--;
+    }
+
+    return FRAME_FRAGMENT_HEADER_LENGTH + length;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void frame_fragment_header_write( uint8_t *fragment, const frame_fragment_header_t *header )
+{
+    fragment[0] = FRAME_START_BYTE;
+    fragment[1] = (uint8_t)( 1 + header->sequence );
+    fragment[2] = (uint8_t)( 1 + header->index );
+    fragment[3] = (uint8_t)( 1 + header->count );
+    fragment_digits_write( &fragment[4], header->offset );
+    fragment_digits_write( &fragment[6], header->length );
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool frame_fragment_header_read( const uint8_t *fragment, frame_fragment_header_t *header )
+{
+    uint32_t offset = 0;
+    uint32_t length = 0;
+
+    if( fragment[0] != FRAME_START_BYTE || !fragment[1] || !fragment[2] || !fragment[3]
+        || !fragment_digits_read( &fragment[4], &offset ) || !fragment_digits_read( &fragment[6], &length ) )
+    {
+        return false;
+    }
+
+    header->sequence = (uint8_t)( fragment[1] - 1 );
+    header->index    = (uint8_t)( fragment[2] - 1 );
+    header->count    = (uint8_t)( fragment[3] - 1 );
+    header->offset   = (uint16_t)offset;
+    header->length   = (uint16_t)length;
+
+    return header->index < header->count;
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static void fragment_digits_write( uint8_t *digits, uint32_t value )
+{
+    digits[0] = (uint8_t)( 1 + value / 255 );
+    digits[1] = (uint8_t)( 1 + value % 255 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool fragment_digits_read( const uint8_t *digits, uint32_t *value )
+{
+    if( !digits[0] || !digits[1] )
+    {
+        return false;
+    }
+
+    *value = ( digits[0] - 1u ) * 255u + ( digits[1] - 1u );
+    return true;
+}
+
+/* ----- End ---------------------------------------------------------------- */
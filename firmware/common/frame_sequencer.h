@@ -0,0 +1,103 @@
+#ifndef FRAME_SEQUENCER_H
+#define FRAME_SEQUENCER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Frames a sender can have queued and a receiver can be reassembling at once
+#ifndef FRAME_SEQUENCE_WINDOW
+    #define FRAME_SEQUENCE_WINDOW (4u)
+#endif
+
+// Every fragment starts with a header of base-255 digits stored plus one, so
+// the start byte stays the only zero and a byte stream can still be split:
+//  start, sequence, fragment index, fragment count, offset (2), length (2)
+#define FRAME_FRAGMENT_HEADER_LENGTH (8u)
+#define FRAME_FRAGMENT_COUNT_MAX     (254u)
+#define FRAME_SEQUENCE_MODULO        (255u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    uint8_t  sequence;
+    uint8_t  index;
+    uint8_t  count;
+    uint16_t offset;    // of the data in the test payload
+    uint16_t length;    // data bytes after the header
+} frame_fragment_header_t;
+
+typedef struct
+{
+    uint8_t  sequence;
+    uint8_t  index;     // next fragment to send
+    uint8_t  count;
+    uint16_t offset;    // next payload byte to send
+    uint16_t end;
+} frame_sequencer_frame_t;
+
+// Sender side of the sequenced benchmark. Triggers queue frames rather than
+// restarting the one in flight, and each frame goes out as numbered fragments
+// carrying the payload from byte 1 on (the fragment headers bring their own
+// start bytes).
+typedef struct
+{
+    const uint8_t          *payload;
+    uint32_t                fragment_data;      // payload bytes per fragment
+    frame_sequencer_frame_t frames[FRAME_SEQUENCE_WINDOW];
+    uint32_t                head;
+    uint32_t                queued;
+    uint8_t                 next_sequence;
+    uint32_t                dropped;            // triggers with the queue full
+} frame_sequencer_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** fragment_size is the largest the transport takes in one send, header
+ *  included. payload has to outlive the sequencer and not change.
+ */
+
+void frame_sequencer_init( frame_sequencer_t *s, const uint8_t *payload, uint32_t fragment_size );
+
+/* -------------------------------------------------------------------------- */
+
+/** Queues a frame of the first length bytes of the payload. False (and
+ *  counted as dropped) if FRAME_SEQUENCE_WINDOW frames are already queued.
+ */
+
+bool frame_sequencer_queue( frame_sequencer_t *s, uint32_t length );
+
+/* -------------------------------------------------------------------------- */
+
+/** Writes the next fragment, header and data, into fragment (fragment_size
+ *  bytes) and returns its length, or 0 with nothing left to send
+ */
+
+uint32_t frame_sequencer_next( frame_sequencer_t *s, uint8_t *fragment );
+
+/* -------------------------------------------------------------------------- */
+
+void frame_fragment_header_write( uint8_t *fragment, const frame_fragment_header_t *header );
+
+/* -------------------------------------------------------------------------- */
+
+/** Decodes the FRAME_FRAGMENT_HEADER_LENGTH bytes of a header, false if
+ *  they can't be one
+ */
+
+bool frame_fragment_header_read( const uint8_t *fragment, frame_fragment_header_t *header );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* FRAME_SEQUENCER_H */
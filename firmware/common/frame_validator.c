@@ -0,0 +1,180 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "frame_validator.h"
+#include "crc16.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static bool frame_validator_run( frame_validator_t *v, const uint8_t *data, uint32_t length );
+static void frame_validator_lookup( frame_validator_t *v );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void frame_validator_init( frame_validator_t *v, uint32_t length, uint16_t crc )
+{
+    v->expected_length = length;
+    v->expected_crc    = crc;
+    v->frames          = 0;
+    v->bytes           = 0;
+    v->sizes           = NULL;
+    v->size_count      = 0;
+
+    frame_validator_reset( v );
+}
+
+/* -------------------------------------------------------------------------- */
+
+void frame_validator_init_schedule( frame_validator_t *v, const frame_size_t *sizes, uint32_t count )
+{
+    v->frames     = 0;
+    v->bytes      = 0;
+    v->sizes      = sizes;
+    v->size_count = count;
+
+    frame_validator_reset( v );
+}
+
+/* -------------------------------------------------------------------------- */
+
+void frame_validator_reset( frame_validator_t *v )
+{
+    v->crc    = CRC16_SEED;
+    v->length = 0;
+
+    // Nothing is expected past the header until it has been read
+    if( v->sizes )
+    {
+        v->expected_length = FRAME_HEADER_LENGTH;
+        v->header          = 0;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool frame_validator_feed( frame_validator_t *v, const uint8_t *data, uint32_t length )
+{
+    bool complete = false;
+
+    // Split at start bytes, the runs between them go through the block CRC
+    while( length )
+    {
+        if( data[0] == FRAME_START_BYTE )
+        {
+            frame_validator_reset( v );
+        }
+
+        const uint8_t *next = memchr( data + 1, FRAME_START_BYTE, length - 1 );
+        const uint32_t run  = next ? (uint32_t)( next - data ) : length;
+
+        complete |= frame_validator_run( v, data, run );
+
+        data += run;
+        length -= run;
+    }
+
+    return complete;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool frame_validator_feed_fragments( frame_validator_t *v, const frame_fragment_t *fragments, uint32_t count )
+{
+    bool complete = false;
+
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        complete |= frame_validator_feed( v, fragments[i].data, fragments[i].length );
+    }
+
+    return complete;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void frame_header_write( uint8_t *frame, uint32_t length )
+{
+    frame[1] = (uint8_t)( 1 + length / 255 );
+    frame[2] = (uint8_t)( 1 + length % 255 );
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+// Bytes with no start byte among them (other than possibly the first)
+static bool frame_validator_run( frame_validator_t *v, const uint8_t *data, uint32_t length )
+{
+    bool complete = false;
+
+    // A scheduled frame's header is a couple of bytes, take them one at a time
+    while( v->sizes && v->length < FRAME_HEADER_LENGTH && length )
+    {
+        if( v->length )
+        {
+            v->header = v->header * 255 + ( data[0] - 1u );
+        }
+
+        v->crc = crc16_byte( v->crc, data[0] );
+        v->length++;
+        data++;
+        length--;
+
+        if( v->length == FRAME_HEADER_LENGTH )
+        {
+            frame_validator_lookup( v );
+        }
+    }
+
+    if( v->length < v->expected_length )
+    {
+        uint32_t take = v->expected_length - v->length;
+
+        if( take > length )
+        {
+            take = length;
+        }
+
+        v->crc = crc16_block( v->crc, data, take );
+        v->length += take;
+        length -= take;
+
+        if( v->length == v->expected_length && v->crc == v->expected_crc )
+        {
+            v->frames++;
+            v->bytes += v->expected_length;
+            complete = true;
+        }
+    }
+
+    // Past the expected length nothing can match until the next start byte,
+    // so the CRC isn't worth keeping up. Saturate rather than wrap.
+    if( length )
+    {
+        v->length = v->expected_length + 1;
+    }
+
+    return complete;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Schedules are a handful of sizes, a linear search is plenty
+static void frame_validator_lookup( frame_validator_t *v )
+{
+    for( uint32_t i = 0; i < v->size_count; i++ )
+    {
+        if( v->sizes[i].length == v->header )
+        {
+            v->expected_length = v->sizes[i].length;
+            v->expected_crc    = v->sizes[i].crc;
+            return;
+        }
+    }
+
+    // Unknown length, the rest of the frame is skipped like an overlong one
+    v->expected_length = FRAME_HEADER_LENGTH;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,106 @@
+#ifndef FRAME_VALIDATOR_H
+#define FRAME_VALIDATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Every test payload starts with this byte and contains no other
+#define FRAME_START_BYTE (0x00u)
+
+// Scheduled frames carry their length after the start byte as two base-255
+// digits, each stored plus one so neither can be a start byte
+#define FRAME_HEADER_LENGTH (3u)
+#define FRAME_LENGTH_MIN    (FRAME_HEADER_LENGTH + 1u)
+#define FRAME_LENGTH_MAX    (254u * 255u + 254u)
+
+/* ----- Types -------------------------------------------------------------- */
+
+// One entry of a payload size schedule
+typedef struct
+{
+    uint16_t length;
+    uint16_t crc;           // CRC16 of the whole frame, header included
+} frame_size_t;
+
+// Recognises test payloads in a received byte stream however it's split up.
+// A start byte restarts the frame, and the frame is valid once the expected
+// number of bytes has arrived with the expected CRC. With a schedule the
+// expected length and CRC come from each frame's header instead.
+typedef struct
+{
+    uint32_t            expected_length;
+    uint16_t            expected_crc;
+    uint16_t            crc;            // running CRC of the current frame
+    uint32_t            length;         // bytes since the last start byte
+    uint32_t            frames;         // valid frames seen
+    uint32_t            bytes;          // bytes of those frames, wraps
+    const frame_size_t *sizes;          // schedule, NULL for a single length
+    uint32_t            size_count;
+    uint32_t            header;         // length digits read so far
+} frame_validator_t;
+
+// One piece of a scatter/gather receive, e.g. both spans of a ring buffer
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t       length;
+} frame_fragment_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Sets up to look for frames of length bytes with the given CRC16 */
+
+void frame_validator_init( frame_validator_t *v, uint32_t length, uint16_t crc );
+
+/* -------------------------------------------------------------------------- */
+
+/** Sets up to accept frames of any length in sizes, as announced by their
+ *  header. Frames announcing a length that isn't listed are ignored.
+ *  sizes isn't copied and has to outlive the validator.
+ */
+
+void frame_validator_init_schedule( frame_validator_t *v, const frame_size_t *sizes, uint32_t count );
+
+/* -------------------------------------------------------------------------- */
+
+/** Forgets any partial frame */
+
+void frame_validator_reset( frame_validator_t *v );
+
+/* -------------------------------------------------------------------------- */
+
+/** Feeds the next received bytes in place, without copying them.
+ *  Returns true if a valid frame finished inside this fragment, so the
+ *  caller can signal it as soon as the fragment holding the last byte is fed.
+ */
+
+bool frame_validator_feed( frame_validator_t *v, const uint8_t *data, uint32_t length );
+
+/* -------------------------------------------------------------------------- */
+
+/** Feeds several fragments in order, true if any frame finished */
+
+bool frame_validator_feed_fragments( frame_validator_t *v, const frame_fragment_t *fragments, uint32_t count );
+
+/* -------------------------------------------------------------------------- */
+
+/** Writes the length header into a frame that already has its start byte,
+ *  length has to be within FRAME_LENGTH_MIN to FRAME_LENGTH_MAX
+ */
+
+void frame_header_write( uint8_t *frame, uint32_t length );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* FRAME_VALIDATOR_H */
@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- */
+
+// Checks every CRC16 kernel against the original shift and xor routine, then
+// times them on the benchmark payload sizes.
+//
+// The bitwise reference is the per-byte crc16() each firmware main.c used to
+// carry, so a match here means payload CRCs are unchanged. Also checks the
+// CRC test_payload.cmake generates along with the payload, and with a
+// PAYLOAD_SCHEDULE the CRC of every frame the sender cycles through.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "crc16.h"
+#include "payload_schedule.h"
+#include "test_payload.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define BENCH_CHECK_BUFFER (4096u)
+#define BENCH_TARGET_BYTES (256u * 1024u * 1024u)
+
+typedef uint16_t (*crc16_kernel_t)( uint16_t crc, const uint8_t *data, uint32_t length );
+
+typedef struct
+{
+    const char *   name;
+    crc16_kernel_t kernel;
+} bench_kernel_t;
+
+static const bench_kernel_t bench_kernels[] = {
+    { "bitwise", crc16_bitwise },
+    { "table", crc16_slice1 },
+    { "slice-by-4", crc16_slice4 },
+    { "slice-by-8", crc16_slice8 },
+};
+
+#define BENCH_KERNEL_COUNT ( sizeof( bench_kernels ) / sizeof( bench_kernels[0] ) )
+
+static const uint32_t bench_sizes[] = { 12, 128, 1024 };
+
+#define BENCH_SIZE_COUNT ( sizeof( bench_sizes ) / sizeof( bench_sizes[0] ) )
+
+static double bench_now_ns( void );
+
+/* -------------------------------------------------------------------------- */
+
+int main( void )
+{
+    static uint8_t buffer[BENCH_CHECK_BUFFER];
+    uint32_t       mismatches = 0;
+
+    srand( 1 );
+    for( uint32_t i = 0; i < sizeof( buffer ); i++ )
+    {
+        buffer[i] = (uint8_t)rand();
+    }
+
+    // Standard check value for "123456789"
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    printf( "check value 0x%04X (expect 0x29B1)\n", crc16_block( CRC16_SEED, check, sizeof( check ) ) );
+
+    // The CRC test_payload.cmake worked out at configure time
+    const uint16_t payload_crc = crc16_block( CRC16_SEED, test_payload, TEST_PAYLOAD_SIZE );
+    printf( "%u B test payload CRC 0x%04X (generated 0x%04X)\n", TEST_PAYLOAD_SIZE, payload_crc, TEST_PAYLOAD_CRC );
+
+    if( payload_crc != TEST_PAYLOAD_CRC )
+    {
+        mismatches++;
+    }
+
+#if defined(TEST_PAYLOAD_SCHEDULE_COUNT)
+    // Each frame as payload_schedule_next() prepares it for sending
+    for( uint32_t i = 0; i < TEST_PAYLOAD_SCHEDULE_COUNT; i++ )
+    {
+        const uint32_t length    = payload_schedule_next();
+        const uint16_t frame_crc = crc16_block( CRC16_SEED, test_payload, length );
+
+        printf( "%u B scheduled frame CRC 0x%04X (generated 0x%04X)\n", length, frame_crc, test_payload_schedule[i].crc );
+
+        if( length != test_payload_schedule[i].length || frame_crc != test_payload_schedule[i].crc )
+        {
+            mismatches++;
+        }
+    }
+#endif
+
+    // Every length and misalignment up to a few slices, plus the running CRC
+    // carried across split blocks
+    for( uint32_t offset = 0; offset < 8; offset++ )
+    {
+        for( uint32_t length = 0; length + offset <= 300; length++ )
+        {
+            const uint16_t expected = crc16_bitwise( CRC16_SEED, buffer + offset, length );
+
+            for( uint32_t k = 1; k < BENCH_KERNEL_COUNT; k++ )
+            {
+                const uint32_t split = length / 3;
+                uint16_t       crc   = bench_kernels[k].kernel( CRC16_SEED, buffer + offset, split );
+                crc                  = bench_kernels[k].kernel( crc, buffer + offset + split, length - split );
+
+                if( bench_kernels[k].kernel( CRC16_SEED, buffer + offset, length ) != expected || crc != expected )
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    if( crc16_block( CRC16_SEED, buffer, sizeof( buffer ) ) != crc16_bitwise( CRC16_SEED, buffer, sizeof( buffer ) ) )
+    {
+        mismatches++;
+    }
+
+    printf( "%u mismatches against the bitwise routine\n\n", mismatches );
+
+    printf( "%-12s", "ns/byte" );
+    for( uint32_t s = 0; s < BENCH_SIZE_COUNT; s++ )
+    {
+        printf( "%8uB %8s", bench_sizes[s], "speedup" );
+    }
+    printf( "\n" );
+
+    double bitwise_ns[BENCH_SIZE_COUNT];
+
+    for( uint32_t k = 0; k < BENCH_KERNEL_COUNT; k++ )
+    {
+        printf( "%-12s", bench_kernels[k].name );
+
+        for( uint32_t s = 0; s < BENCH_SIZE_COUNT; s++ )
+        {
+            const uint32_t size       = bench_sizes[s];
+            const uint32_t iterations = BENCH_TARGET_BYTES / size;
+            uint16_t       crc        = CRC16_SEED;
+
+            const double start = bench_now_ns();
+
+            // Feed the result back in so the calls can't be hoisted
+            for( uint32_t i = 0; i < iterations; i++ )
+            {
+                crc = bench_kernels[k].kernel( crc, buffer + ( crc & 7 ), size );
+            }
+
+            const double per_byte = ( bench_now_ns() - start ) / ( (double)iterations * size );
+
+            if( k == 0 )
+            {
+                bitwise_ns[s] = per_byte;
+            }
+
+            printf( "%9.3f %7.1fx", per_byte, bitwise_ns[s] / per_byte );
+
+            if( crc == 0x1234 )
+            {
+                printf( "!" );
+            }
+        }
+
+        printf( "\n" );
+    }
+
+    return ( mismatches == 0 ) ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double bench_now_ns( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ----- End ---------------------------------------------------------------- */
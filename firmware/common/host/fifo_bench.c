@@ -0,0 +1,410 @@
+/* -------------------------------------------------------------------------- */
+
+// Differential fuzz and timing of the STM32 LL UART fifo's block copies.
+//
+// Random writes and reads go through fifo_write()/fifo_read() on one fifo,
+// through the per-byte fifo_put()/fifo_get() loop they replaced on another,
+// and in place through fifo_reserve_write()/fifo_commit_write() and
+// fifo_peek_spans()/fifo_consume() on a third, and all must return the same
+// counts and bytes, also after fifo_rebase() rotates what they hold. A producer and a consumer
+// thread then stream a counting pattern through one fifo with no locks, like
+// main and the UART interrupts do. Last, both paths are timed moving the
+// benchmark payload sizes through the 2 KiB fifo the firmware uses, with the
+// ring offset so transfers split at the wrap point.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+    #include <x86intrin.h>
+#endif
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "fifo.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define BENCH_FIFO_SIZE    (2048u)
+#define BENCH_FUZZ_OPS     (2000000u)
+#define BENCH_TARGET_BYTES (256u * 1024u * 1024u)
+#define BENCH_STREAM_BYTES (16u * 1024u * 1024u)
+
+static const uint32_t bench_sizes[] = { 12, 128, 1024 };
+
+#define BENCH_SIZE_COUNT ( sizeof( bench_sizes ) / sizeof( bench_sizes[0] ) )
+
+typedef struct
+{
+    fifo_t  fifo;
+    uint8_t storage[BENCH_FIFO_SIZE];
+} bench_stream_t;
+
+static uint32_t bench_random( void );
+static uint32_t reference_write( fifo_t *f, const uint8_t *buf, uint32_t nbytes );
+static uint32_t reference_read( fifo_t *f, uint8_t *buf, uint32_t nbytes );
+static uint32_t span_write( fifo_t *f, const uint8_t *buf, uint32_t nbytes );
+static uint32_t span_read( fifo_t *f, uint8_t *buf, uint32_t nbytes );
+static double bench_time( fifo_t *f, uint32_t length, bool block, uint32_t passes );
+static uint32_t bench_stream( uint32_t capacity );
+static void *bench_producer( void *arg );
+static uint64_t bench_ticks( void );
+
+/* -------------------------------------------------------------------------- */
+
+int main( void )
+{
+    static uint8_t storage[3][BENCH_FIFO_SIZE];
+    static uint8_t in[BENCH_FIFO_SIZE + 64];
+    static uint8_t out[3][BENCH_FIFO_SIZE + 64];
+    fifo_t         fifos[3];
+    uint32_t       mismatches = 0;
+    uint64_t       moved      = 0;
+
+    // Smaller power of two capacities too, so the indices lap the buffer more often
+    for( uint32_t round = 0; round < 4; round++ )
+    {
+        const uint32_t capacity = ( round == 0 ) ? BENCH_FIFO_SIZE : 2u << ( bench_random() % 10 );
+
+        fifo_init( &fifos[0], storage[0], capacity );
+        fifo_init( &fifos[1], storage[1], capacity );
+        fifo_init( &fifos[2], storage[2], capacity );
+
+        for( uint32_t op = 0; op < BENCH_FUZZ_OPS / 4; op++ )
+        {
+            // Mostly short transfers, sometimes more than fits
+            const uint32_t length = ( bench_random() & 7 ) ? bench_random() % 64 : bench_random() % sizeof( in );
+
+            if( bench_random() & 1 )
+            {
+                for( uint32_t i = 0; i < length; i++ )
+                {
+                    in[i] = (uint8_t)bench_random();
+                }
+
+                const uint32_t expected = reference_write( &fifos[0], in, length );
+                const uint32_t got      = fifo_write( &fifos[1], in, length );
+                const uint32_t spanned  = span_write( &fifos[2], in, length );
+
+                mismatches += ( got != expected || spanned != expected ) ? 1 : 0;
+                moved += got;
+            }
+            else
+            {
+                const uint32_t expected = reference_read( &fifos[0], out[0], length );
+                const uint32_t got      = fifo_read( &fifos[1], out[1], length );
+                const uint32_t spanned  = span_read( &fifos[2], out[2], length );
+
+                mismatches += ( got != expected || memcmp( out[0], out[1], expected ) != 0 ) ? 1 : 0;
+                mismatches += ( spanned != expected || memcmp( out[0], out[2], expected ) != 0 ) ? 1 : 0;
+            }
+
+            if( fifos[0].head != fifos[1].head || fifos[0].tail != fifos[1].tail ||
+                fifos[0].head != fifos[2].head || fifos[0].tail != fifos[2].tail )
+            {
+                mismatches++;
+            }
+
+            // Now and then move the held bytes to where a circular DMA stream
+            // starts, the reads that follow check they survived
+            if( ( bench_random() & 1023 ) == 0 )
+            {
+                fifo_rebase( &fifos[0] );
+                fifo_rebase( &fifos[1] );
+                fifo_rebase( &fifos[2] );
+            }
+        }
+    }
+
+    printf( "%u random operations, %llu bytes written, %u mismatches against the per-byte loops\n",
+            BENCH_FUZZ_OPS,
+            (unsigned long long)moved,
+            mismatches );
+
+    // Small fifos keep both threads on the full and empty edges
+    uint32_t stream_errors = 0;
+
+    for( uint32_t capacity = 16; capacity <= BENCH_FIFO_SIZE; capacity *= 8 )
+    {
+        stream_errors += bench_stream( capacity );
+    }
+
+    printf( "%u MiB streamed between two threads per capacity, %u out of order bytes\n\n",
+            BENCH_STREAM_BYTES / ( 1024u * 1024u ),
+            stream_errors );
+
+    mismatches += stream_errors;
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+    const char *unit = "TSC ticks/B";
+#else
+    const char *unit = "ns/B";
+#endif
+
+    printf( "%-10s %14s %14s %8s   (%s, write plus read)\n", "transfer", "per-byte", "block", "speedup", unit );
+
+    for( uint32_t s = 0; s < BENCH_SIZE_COUNT; s++ )
+    {
+        const uint32_t length = bench_sizes[s];
+        const uint32_t passes = BENCH_TARGET_BYTES / length;
+        double         per_byte[2];
+
+        for( uint32_t which = 0; which < 2; which++ )
+        {
+            fifo_init( &fifos[which], storage[which], BENCH_FIFO_SIZE );
+
+            // One byte in and out, so the transfers don't line up with the buffer end
+            in[0] = 0;
+            fifo_write( &fifos[which], in, 1 );
+            fifo_read( &fifos[which], out[which], 1 );
+
+            per_byte[which] = bench_time( &fifos[which], length, which == 1, passes );
+        }
+
+        printf( "%8uB %14.3f %14.3f %7.1fx\n", length, per_byte[0], per_byte[1], per_byte[0] / per_byte[1] );
+    }
+
+    return ( mismatches == 0 ) ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t bench_random( void )
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (uint32_t)( state >> 32 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// The loops fifo_write() and fifo_read() used to run
+static uint32_t reference_write( fifo_t *f, const uint8_t *buf, uint32_t nbytes )
+{
+    uint32_t count = 0;
+
+    for( uint32_t i = 0; i < nbytes; i++ )
+    {
+        if( !fifo_put( f, buf[i] ) )
+        {
+            break;
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t reference_read( fifo_t *f, uint8_t *buf, uint32_t nbytes )
+{
+    uint32_t count = 0;
+
+    for( uint32_t i = 0; i < nbytes; i++ )
+    {
+        uint8_t *p = fifo_get( f );
+
+        if( !p )
+        {
+            break;
+        }
+
+        buf[i] = *p;
+        count++;
+    }
+
+    return count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// A DMA stream filling the reserved space, and a parser working in place
+static uint32_t span_write( fifo_t *f, const uint8_t *buf, uint32_t nbytes )
+{
+    fifo_span_t spans[2];
+    uint32_t    count = fifo_reserve_write( f, spans );
+
+    if( nbytes < count )
+    {
+        count = nbytes;
+    }
+
+    const uint32_t first = ( count < spans[0].length ) ? count : spans[0].length;
+
+    memcpy( spans[0].data, buf, first );
+    memcpy( spans[1].data, &buf[first], count - first );
+
+    return fifo_commit_write( f, count ) ? count : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t span_read( fifo_t *f, uint8_t *buf, uint32_t nbytes )
+{
+    fifo_span_t spans[2];
+    uint32_t    count = fifo_peek_spans( f, spans );
+
+    if( nbytes < count )
+    {
+        count = nbytes;
+    }
+
+    const uint32_t first = ( count < spans[0].length ) ? count : spans[0].length;
+
+    memcpy( buf, spans[0].data, first );
+    memcpy( &buf[first], spans[1].data, count - first );
+
+    return fifo_consume( f, count ) ? count : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Like the DMA RX handler pushing a block and the application pulling it out
+static double bench_time( fifo_t *f, uint32_t length, bool block, uint32_t passes )
+{
+    static uint8_t data[1024];
+    static uint8_t sink[1024];
+    uint32_t       check = 0;
+
+    for( uint32_t i = 0; i < length; i++ )
+    {
+        data[i] = (uint8_t)bench_random();
+    }
+
+    const uint64_t start = bench_ticks();
+
+    for( uint32_t pass = 0; pass < passes; pass++ )
+    {
+        if( block )
+        {
+            fifo_write( f, data, length );
+            check += fifo_read( f, sink, length );
+        }
+        else
+        {
+            reference_write( f, data, length );
+            check += reference_read( f, sink, length );
+        }
+    }
+
+    const uint64_t ticks = bench_ticks() - start;
+
+    // Keeps the copies from being optimised away
+    if( check != passes * length || sink[length - 1] != data[length - 1] )
+    {
+        printf( "lost data at %u B\n", length );
+    }
+
+    return (double)ticks / ( (double)passes * length );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// The consumer side on this thread, the producer on another, no locks
+static uint32_t bench_stream( uint32_t capacity )
+{
+    static bench_stream_t stream;
+    uint8_t               chunk[97];
+    uint32_t              received = 0;
+    uint32_t              errors   = 0;
+    pthread_t             producer;
+
+    fifo_init( &stream.fifo, stream.storage, capacity );
+
+    if( pthread_create( &producer, 0, bench_producer, &stream ) != 0 )
+    {
+        printf( "couldn't start the producer thread\n" );
+        return 1;
+    }
+
+    while( received < BENCH_STREAM_BYTES )
+    {
+        // Odd read sizes, so reads and writes split at different places, and
+        // both the copying and the in place reads
+        const uint32_t length = 1 + received % sizeof( chunk );
+        const uint32_t count  = ( received & 1 ) ? span_read( &stream.fifo, chunk, length ) : fifo_read( &stream.fifo, chunk, length );
+
+        for( uint32_t i = 0; i < count; i++ )
+        {
+            errors += ( chunk[i] != (uint8_t)( ( received + i ) % 251 ) ) ? 1 : 0;
+        }
+
+        received += count;
+
+        // Hand the core over when the other side is behind, for single core hosts
+        if( !count )
+        {
+            sched_yield();
+        }
+    }
+
+    pthread_join( producer, 0 );
+
+    return errors;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void *bench_producer( void *arg )
+{
+    bench_stream_t *stream = arg;
+    uint8_t         chunk[61];
+    uint32_t        sent = 0;
+
+    while( sent < BENCH_STREAM_BYTES )
+    {
+        uint32_t length = 1 + sent % sizeof( chunk );
+
+        if( length > BENCH_STREAM_BYTES - sent )
+        {
+            length = BENCH_STREAM_BYTES - sent;
+        }
+
+        // A pattern that doesn't repeat on a power of two
+        for( uint32_t i = 0; i < length; i++ )
+        {
+            chunk[i] = (uint8_t)( ( sent + i ) % 251 );
+        }
+
+        // Whatever didn't fit gets regenerated next time round
+        const uint32_t written = ( sent & 1 ) ? span_write( &stream->fifo, chunk, length ) : fifo_write( &stream->fifo, chunk, length );
+
+        sent += written;
+
+        if( !written )
+        {
+            sched_yield();
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint64_t bench_ticks( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* ----- End ---------------------------------------------------------------- */
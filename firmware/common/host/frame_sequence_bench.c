@@ -0,0 +1,344 @@
+/* -------------------------------------------------------------------------- */
+
+// Fuzz and timing of the sequenced sender and the reorder tolerant receiver.
+//
+// Frames of random length are queued on a frame_sequencer_t and their
+// fragments go through a simulated link that shuffles them among a few
+// consecutive frames, duplicates, drops and corrupts some. The bytes that come
+// out are cut into random pieces and fed to a frame_reassembler_t, which has
+// to complete exactly the frames whose fragments all got through intact.
+// Then the reassembler is timed against the stop-and-wait validator.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "crc16.h"
+#include "frame_reassembler.h"
+#include "frame_sequencer.h"
+#include "frame_validator.h"
+#include "test_payload.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define BENCH_FUZZ_ROUNDS   (400u)
+#define BENCH_ROUND_FRAMES  (60u)
+#define BENCH_FRAGMENT_MAX  (300u)
+#define BENCH_LINK_MAX      (16384u)
+#define BENCH_STREAM_BYTES  (1u << 22)
+#define BENCH_TARGET_BYTES  (128u * 1024u * 1024u)
+
+// Frames shuffled together on the link, fewer than the window so a frame
+// that's still arriving is never the oldest open one
+#define BENCH_SHUFFLE_FRAMES (FRAME_SEQUENCE_WINDOW - 1u)
+
+typedef struct
+{
+    uint32_t frame;
+    uint32_t index;
+    uint32_t length;
+    bool     intact;
+    uint8_t  data[BENCH_FRAGMENT_MAX];
+} bench_fragment_t;
+
+static bench_fragment_t link_fragments[BENCH_LINK_MAX];
+static uint8_t          link_stream[BENCH_STREAM_BYTES];
+
+static uint32_t bench_random( void );
+static uint32_t fuzz_round( uint32_t *expected );
+static double bench_now_ns( void );
+
+/* -------------------------------------------------------------------------- */
+
+int main( void )
+{
+    uint32_t mismatches = 0;
+    uint32_t completed  = 0;
+    uint32_t expected   = 0;
+
+    for( uint32_t round = 0; round < BENCH_FUZZ_ROUNDS; round++ )
+    {
+        uint32_t round_expected = 0;
+        uint32_t round_completed = fuzz_round( &round_expected );
+
+        if( round_completed != round_expected )
+        {
+            mismatches++;
+        }
+
+        completed += round_completed;
+        expected += round_expected;
+    }
+
+    printf( "%u rounds, %u frames reassembled (%u expected), %u rounds mismatched\n\n",
+            BENCH_FUZZ_ROUNDS,
+            completed,
+            expected,
+            mismatches );
+
+    // Back to back frames over a clean link, against the validator seeing the
+    // same payloads unfragmented
+    static const uint32_t sizes[]     = { 128, 1024 };
+    static const uint32_t fragments[] = { 250, 2048 };
+
+    printf( "%-10s %-10s %10s %12s\n", "payload", "fragment", "validator", "reassembler" );
+
+    for( uint32_t s = 0; s < 2; s++ )
+    {
+        const uint32_t length = sizes[s];
+
+        if( length > TEST_PAYLOAD_SIZE )
+        {
+            continue;
+        }
+
+        // Plain payloads for the validator
+        uint32_t plain = 0;
+        while( plain + length <= BENCH_STREAM_BYTES / 2 )
+        {
+            memcpy( link_stream + plain, test_payload, length );
+            plain += length;
+        }
+
+        frame_validator_t validator;
+        frame_validator_init( &validator, length, crc16_block( CRC16_SEED, test_payload, length ) );
+
+        uint32_t passes = BENCH_TARGET_BYTES / plain;
+        double   start  = bench_now_ns();
+
+        for( uint32_t pass = 0; pass < passes; pass++ )
+        {
+            frame_validator_feed( &validator, link_stream, plain );
+        }
+
+        const double validator_ns = ( bench_now_ns() - start ) / ( (double)passes * plain );
+
+        for( uint32_t f = 0; f < 2; f++ )
+        {
+            frame_sequencer_t sequencer;
+            frame_sequencer_init( &sequencer, test_payload, fragments[f] );
+
+            // Whole cycles of sequence numbers, so the stream can be fed
+            // over and over as if it carried on
+            uint8_t       *fragmented = link_stream + BENCH_STREAM_BYTES / 2;
+            const uint32_t per_frame  = length + FRAME_FRAGMENT_HEADER_LENGTH * ( 1 + length / ( fragments[f] - FRAME_FRAGMENT_HEADER_LENGTH ) );
+            const uint32_t frames     = ( BENCH_STREAM_BYTES / 2 / per_frame ) / FRAME_SEQUENCE_MODULO * FRAME_SEQUENCE_MODULO;
+            uint32_t       used       = 0;
+
+            for( uint32_t frame = 0; frame < frames; frame++ )
+            {
+                uint32_t size;
+
+                frame_sequencer_queue( &sequencer, length );
+
+                while( ( size = frame_sequencer_next( &sequencer, fragmented + used ) ) )
+                {
+                    used += size;
+                }
+            }
+
+            frame_reassembler_t reassembler;
+            frame_reassembler_init( &reassembler, test_payload, TEST_PAYLOAD_SIZE );
+
+            passes = BENCH_TARGET_BYTES / used;
+            start  = bench_now_ns();
+
+            for( uint32_t pass = 0; pass < passes; pass++ )
+            {
+                frame_reassembler_feed( &reassembler, fragmented, used );
+            }
+
+            const double reassembler_ns = ( bench_now_ns() - start ) / ( (double)passes * used );
+
+            if( reassembler.completed != frames * passes || reassembler.lost || reassembler.duplicates )
+            {
+                mismatches++;
+            }
+
+            printf( "%8uB %9uB %8.3fns %10.3fns\n", length, fragments[f], validator_ns, reassembler_ns );
+        }
+    }
+
+    return ( mismatches == 0 ) ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t bench_random( void )
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (uint32_t)( state >> 32 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// One run of frames through the lossy link, returns the frames reassembled
+// and how many should have been
+static uint32_t fuzz_round( uint32_t *expected )
+{
+    frame_sequencer_t   sequencer;
+    frame_reassembler_t reassembler;
+    bool                delivered[BENCH_ROUND_FRAMES][FRAME_FRAGMENT_COUNT_MAX];
+    uint32_t            counts[BENCH_ROUND_FRAMES];
+    uint32_t            fragments = 0;
+
+    // From a few bytes of data a fragment (over a hundred fragments a frame)
+    // up to whole frames
+    const uint32_t fragment_size = FRAME_FRAGMENT_HEADER_LENGTH + 8 + bench_random() % ( BENCH_FRAGMENT_MAX - FRAME_FRAGMENT_HEADER_LENGTH - 8 );
+
+    frame_sequencer_init( &sequencer, test_payload, fragment_size );
+    frame_reassembler_init( &reassembler, test_payload, TEST_PAYLOAD_SIZE );
+    memset( delivered, 0, sizeof( delivered ) );
+
+    for( uint32_t frame = 0; frame < BENCH_ROUND_FRAMES; frame++ )
+    {
+        // Room for every fragment of the largest frame sent twice
+        if( fragments + 2 * FRAME_FRAGMENT_COUNT_MAX > BENCH_LINK_MAX )
+        {
+            counts[frame] = 0;
+            continue;
+        }
+
+        const uint32_t length = 2 + bench_random() % ( TEST_PAYLOAD_SIZE - 1 );
+        uint32_t       index  = 0;
+
+        frame_sequencer_queue( &sequencer, length );
+
+        for( ;; index++ )
+        {
+            bench_fragment_t *fragment = &link_fragments[fragments];
+
+            fragment->length = frame_sequencer_next( &sequencer, fragment->data );
+
+            if( !fragment->length )
+            {
+                break;
+            }
+
+            fragment->frame  = frame;
+            fragment->index  = index;
+            fragment->intact = true;
+
+            const uint32_t fate = bench_random() % 40;
+
+            if( fate == 0 )
+            {
+                // Dropped
+                continue;
+            }
+
+            if( fate == 1 )
+            {
+                // Corrupted data, the links all check their own headers
+                const uint32_t at = FRAME_FRAGMENT_HEADER_LENGTH + bench_random() % ( fragment->length - FRAME_FRAGMENT_HEADER_LENGTH );
+
+                fragment->data[at] ^= (uint8_t)( 1 + bench_random() % 255 );
+                fragment->intact = false;
+            }
+
+            fragments++;
+
+            if( fate == 2 || fate == 3 )
+            {
+                // Duplicated
+                link_fragments[fragments] = *fragment;
+                fragments++;
+            }
+        }
+
+        counts[frame] = index;
+    }
+
+    // Shuffle among a few consecutive frames
+    for( uint32_t at = 0; at < fragments; )
+    {
+        uint32_t end = at;
+
+        while( end < fragments && link_fragments[end].frame / BENCH_SHUFFLE_FRAMES == link_fragments[at].frame / BENCH_SHUFFLE_FRAMES )
+        {
+            end++;
+        }
+
+        bench_fragment_t *batch = &link_fragments[at];
+
+        for( uint32_t i = end - at - 1; i > 0; i-- )
+        {
+            const uint32_t   j    = bench_random() % ( i + 1 );
+            bench_fragment_t swap = batch[i];
+
+            batch[i] = batch[j];
+            batch[j] = swap;
+        }
+
+        at = end;
+    }
+
+    // Onto the wire, then received in random pieces
+    uint32_t used = 0;
+
+    for( uint32_t i = 0; i < fragments; i++ )
+    {
+        memcpy( link_stream + used, link_fragments[i].data, link_fragments[i].length );
+        used += link_fragments[i].length;
+
+        if( link_fragments[i].intact )
+        {
+            delivered[link_fragments[i].frame][link_fragments[i].index] = true;
+        }
+    }
+
+    uint32_t completed = 0;
+
+    for( uint32_t at = 0; at < used; )
+    {
+        uint32_t size = 1 + bench_random() % ( ( bench_random() & 1 ) ? 16 : 2 * fragment_size );
+
+        if( size > used - at )
+        {
+            size = used - at;
+        }
+
+        completed += frame_reassembler_feed( &reassembler, link_stream + at, size );
+        at += size;
+    }
+
+    *expected = 0;
+
+    for( uint32_t frame = 0; frame < BENCH_ROUND_FRAMES; frame++ )
+    {
+        bool whole = counts[frame] > 0;
+
+        for( uint32_t index = 0; index < counts[frame]; index++ )
+        {
+            whole = whole && delivered[frame][index];
+        }
+
+        *expected += whole ? 1 : 0;
+    }
+
+    return ( completed == reassembler.completed ) ? completed : ~0u;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double bench_now_ns( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ----- End ---------------------------------------------------------------- */
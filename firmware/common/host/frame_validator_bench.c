@@ -0,0 +1,418 @@
+/* -------------------------------------------------------------------------- */
+
+// Differential fuzz and timing of the streaming frame validator.
+//
+// Random streams of valid, truncated and corrupted payloads plus noise are cut
+// into random fragments and fed both to the validator and to a copy of the
+// per-byte parser loop the firmware used to run. Every fragment must report
+// the same completions. The same goes for a stream mixing the sizes of a
+// payload schedule, where each frame's length comes from its header. Then
+// both are timed on the benchmark payload sizes.
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "crc16.h"
+#include "frame_validator.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define BENCH_STREAM_BYTES (1u << 20)
+#define BENCH_FUZZ_ROUNDS  (200u)
+#define BENCH_TARGET_BYTES (128u * 1024u * 1024u)
+
+// The per-byte loop from the firmware receive paths
+typedef struct
+{
+    uint32_t            expected_length;
+    uint16_t            expected_crc;
+    uint16_t            crc;
+    uint32_t            length;
+    uint32_t            frames;
+    uint32_t            bytes;
+    const frame_size_t *sizes;      // schedule, length taken from the header
+    uint32_t            size_count;
+    uint32_t            header;
+} reference_parser_t;
+
+static const uint32_t bench_sizes[] = { 12, 128, 1024 };
+
+#define BENCH_SIZE_COUNT ( sizeof( bench_sizes ) / sizeof( bench_sizes[0] ) )
+
+static uint32_t bench_random( void );
+static void build_payload( uint8_t *payload, uint32_t length );
+static uint32_t build_stream( uint8_t *stream, uint32_t capacity, const uint8_t *payload, uint32_t length );
+static uint32_t append_frame( uint8_t *stream, uint32_t used, const uint8_t *payload, uint32_t length );
+static uint32_t fuzz_feed( frame_validator_t *validator, reference_parser_t *reference, const uint8_t *stream, uint32_t used, uint32_t largest );
+static uint32_t fuzz_schedule( uint8_t *stream, uint32_t capacity, uint32_t *frames );
+static bool reference_feed( reference_parser_t *p, const uint8_t *data, uint32_t length );
+static double bench_now_ns( void );
+
+/* -------------------------------------------------------------------------- */
+
+int main( void )
+{
+    static uint8_t stream[BENCH_STREAM_BYTES];
+    static uint8_t payload[1024];
+    uint32_t       mismatches = 0;
+    uint32_t       frames     = 0;
+
+    for( uint32_t round = 0; round < BENCH_FUZZ_ROUNDS; round++ )
+    {
+        const uint32_t length = 1 + bench_random() % sizeof( payload );
+        build_payload( payload, length );
+
+        const uint16_t crc  = crc16_block( CRC16_SEED, payload, length );
+        const uint32_t used = build_stream( stream, sizeof( stream ) / 16, payload, length );
+
+        reference_parser_t reference = { length, crc, CRC16_SEED, 0, 0, 0, NULL, 0, 0 };
+        frame_validator_t  validator;
+        frame_validator_init( &validator, length, crc );
+
+        mismatches += fuzz_feed( &validator, &reference, stream, used, length );
+
+        if( validator.frames != reference.frames || validator.bytes != reference.bytes )
+        {
+            mismatches++;
+        }
+
+        frames += reference.frames;
+    }
+
+    printf( "%u rounds, %u valid frames, %u mismatches against the per-byte parser\n", BENCH_FUZZ_ROUNDS, frames, mismatches );
+
+    uint32_t schedule_frames     = 0;
+    uint32_t schedule_mismatches = 0;
+
+    for( uint32_t round = 0; round < BENCH_FUZZ_ROUNDS; round++ )
+    {
+        schedule_mismatches += fuzz_schedule( stream, sizeof( stream ) / 16, &schedule_frames );
+    }
+
+    mismatches += schedule_mismatches;
+
+    printf( "%u schedule rounds, %u valid frames, %u mismatches against the per-byte parser\n\n",
+            BENCH_FUZZ_ROUNDS,
+            schedule_frames,
+            schedule_mismatches );
+
+    printf( "%-10s %-10s %10s %10s %8s\n", "payload", "fragment", "per-byte", "validator", "speedup" );
+
+    for( uint32_t s = 0; s < BENCH_SIZE_COUNT; s++ )
+    {
+        const uint32_t length = bench_sizes[s];
+        build_payload( payload, length );
+
+        const uint16_t crc = crc16_block( CRC16_SEED, payload, length );
+
+        // Back to back valid frames
+        uint32_t used = 0;
+        while( used + length <= sizeof( stream ) )
+        {
+            memcpy( stream + used, payload, length );
+            used += length;
+        }
+
+        // 32 B is the STM32 UART read size, and whole frames as an IP stack
+        // or radio would deliver them
+        const uint32_t fragments[] = { 32, length };
+
+        for( uint32_t f = 0; f < 2; f++ )
+        {
+            const uint32_t fragment = fragments[f];
+            const uint32_t passes   = BENCH_TARGET_BYTES / used;
+            double         ns[2];
+            uint32_t       counted[2];
+
+            for( uint32_t which = 0; which < 2; which++ )
+            {
+                reference_parser_t reference = { length, crc, CRC16_SEED, 0, 0, 0, NULL, 0, 0 };
+                frame_validator_t  validator;
+                frame_validator_init( &validator, length, crc );
+
+                const double start = bench_now_ns();
+
+                for( uint32_t pass = 0; pass < passes; pass++ )
+                {
+                    for( uint32_t at = 0; at < used; at += fragment )
+                    {
+                        const uint32_t size = ( used - at < fragment ) ? used - at : fragment;
+
+                        if( which == 0 )
+                        {
+                            reference_feed( &reference, stream + at, size );
+                        }
+                        else
+                        {
+                            frame_validator_feed( &validator, stream + at, size );
+                        }
+                    }
+                }
+
+                ns[which]      = ( bench_now_ns() - start ) / ( (double)passes * used );
+                counted[which] = ( which == 0 ) ? reference.frames : validator.frames;
+            }
+
+            if( counted[0] != counted[1] )
+            {
+                mismatches++;
+            }
+
+            printf( "%8uB %9uB %8.3fns %8.3fns %7.1fx\n", length, fragment, ns[0], ns[1], ns[0] / ns[1] );
+        }
+    }
+
+    return ( mismatches == 0 ) ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t bench_random( void )
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (uint32_t)( state >> 32 );
+}
+
+/* -------------------------------------------------------------------------- */
+
+// A start byte then no other zeros, like the firmware test payloads
+static void build_payload( uint8_t *payload, uint32_t length )
+{
+    payload[0] = FRAME_START_BYTE;
+
+    for( uint32_t i = 1; i < length; i++ )
+    {
+        payload[i] = (uint8_t)( 1 + bench_random() % 255 );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t build_stream( uint8_t *stream, uint32_t capacity, const uint8_t *payload, uint32_t length )
+{
+    uint32_t used = 0;
+
+    while( used + 2 * length + 64 < capacity )
+    {
+        used = append_frame( stream, used, payload, length );
+    }
+
+    return used;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// The payload whole or damaged in one of several ways, or some noise
+static uint32_t append_frame( uint8_t *stream, uint32_t used, const uint8_t *payload, uint32_t length )
+{
+    const uint32_t kind = bench_random() % 6;
+
+    if( kind == 0 )
+    {
+        // Noise, zeros included
+        const uint32_t noise = bench_random() % 64;
+
+        for( uint32_t i = 0; i < noise; i++ )
+        {
+            stream[used++] = (uint8_t)( ( bench_random() & 3 ) ? bench_random() : 0 );
+        }
+    }
+    else if( kind == 1 )
+    {
+        // Truncated frame
+        const uint32_t part = bench_random() % length;
+
+        memcpy( stream + used, payload, part );
+        used += part;
+    }
+    else if( kind == 2 )
+    {
+        // Corrupted byte, sometimes a stray start byte
+        memcpy( stream + used, payload, length );
+        stream[used + bench_random() % length] ^= (uint8_t)( 1 + bench_random() % 255 );
+        used += length;
+    }
+    else if( kind == 3 )
+    {
+        // Overlong, valid prefix then extra bytes
+        memcpy( stream + used, payload, length );
+        used += length;
+        stream[used++] = (uint8_t)( 1 + bench_random() % 255 );
+    }
+    else
+    {
+        memcpy( stream + used, payload, length );
+        used += length;
+    }
+
+    return used;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Feeds a stream to both parsers in fragments from single bytes to several
+// frames, sometimes as two spans like a wrapped ring buffer. Returns the
+// number of fragments they disagreed on.
+static uint32_t fuzz_feed( frame_validator_t *validator, reference_parser_t *reference, const uint8_t *stream, uint32_t used, uint32_t largest )
+{
+    uint32_t mismatches = 0;
+
+    for( uint32_t at = 0; at < used; )
+    {
+        uint32_t size = 1 + bench_random() % ( ( bench_random() & 1 ) ? 16 : 3 * largest );
+
+        if( size > used - at )
+        {
+            size = used - at;
+        }
+
+        const bool expected = reference_feed( reference, stream + at, size );
+        bool       got;
+
+        if( size > 1 && ( bench_random() & 3 ) == 0 )
+        {
+            const uint32_t         split        = bench_random() % size;
+            const frame_fragment_t fragments[2] = { { stream + at, split }, { stream + at + split, size - split } };
+
+            got = frame_validator_feed_fragments( validator, fragments, 2 );
+        }
+        else
+        {
+            got = frame_validator_feed( validator, stream + at, size );
+        }
+
+        if( got != expected )
+        {
+            mismatches++;
+        }
+
+        at += size;
+    }
+
+    return mismatches;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Frames from a three size schedule mixed with ones announcing a length that
+// isn't in it
+static uint32_t fuzz_schedule( uint8_t *stream, uint32_t capacity, uint32_t *frames )
+{
+    static const uint32_t lengths[] = { 12, 128, 1024, 300 };
+    static uint8_t        payloads[4][1024];
+    frame_size_t          sizes[3];
+
+    for( uint32_t i = 0; i < 4; i++ )
+    {
+        build_payload( payloads[i], lengths[i] );
+        frame_header_write( payloads[i], lengths[i] );
+
+        if( i < 3 )
+        {
+            sizes[i].length = (uint16_t)lengths[i];
+            sizes[i].crc    = crc16_block( CRC16_SEED, payloads[i], lengths[i] );
+        }
+    }
+
+    uint32_t used = 0;
+
+    while( used + 2 * 1024 + 64 < capacity )
+    {
+        const uint32_t which = bench_random() % 4;
+
+        used = append_frame( stream, used, payloads[which], lengths[which] );
+    }
+
+    reference_parser_t reference = { FRAME_HEADER_LENGTH, 0, CRC16_SEED, 0, 0, 0, sizes, 3, 0 };
+    frame_validator_t  validator;
+    frame_validator_init_schedule( &validator, sizes, 3 );
+
+    uint32_t mismatches = fuzz_feed( &validator, &reference, stream, used, 1024 );
+
+    if( validator.frames != reference.frames || validator.bytes != reference.bytes )
+    {
+        mismatches++;
+    }
+
+    *frames += reference.frames;
+    return mismatches;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static bool reference_feed( reference_parser_t *p, const uint8_t *data, uint32_t length )
+{
+    bool complete = false;
+
+    for( uint32_t i = 0; i < length; i++ )
+    {
+        if( data[i] == 0x00 )
+        {
+            p->length = 0;
+            p->crc    = CRC16_SEED;
+            p->header = 0;
+        }
+
+        p->crc = crc16_bitwise( p->crc, &data[i], 1 );
+        p->length++;
+
+        // Scheduled frames: read the length header, then expect that frame
+        if( p->sizes && p->length <= FRAME_HEADER_LENGTH )
+        {
+            if( p->length > 1 )
+            {
+                p->header = p->header * 255 + ( data[i] - 1u );
+            }
+
+            p->expected_length = FRAME_HEADER_LENGTH;
+
+            if( p->length == FRAME_HEADER_LENGTH )
+            {
+                for( uint32_t s = 0; s < p->size_count; s++ )
+                {
+                    if( p->sizes[s].length == p->header )
+                    {
+                        p->expected_length = p->sizes[s].length;
+                        p->expected_crc    = p->sizes[s].crc;
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        if( p->length == p->expected_length && p->crc == p->expected_crc )
+        {
+            p->frames++;
+            p->bytes += p->length;
+            complete = true;
+        }
+    }
+
+    return complete;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double bench_now_ns( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ----- End ---------------------------------------------------------------- */
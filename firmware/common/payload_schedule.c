@@ -0,0 +1,62 @@
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "payload_schedule.h"
+#include "test_payload.h"
+
+/* ----- Private Variables -------------------------------------------------- */
+
+#if defined(TEST_PAYLOAD_SCHEDULE_COUNT)
+static uint32_t schedule_index = 0;
+#endif
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void payload_schedule_validator_init( frame_validator_t *v )
+{
+#if defined(TEST_PAYLOAD_SCHEDULE_COUNT)
+    frame_validator_init_schedule( v, test_payload_schedule, TEST_PAYLOAD_SCHEDULE_COUNT );
+#else
+    frame_validator_init( v, TEST_PAYLOAD_SIZE, TEST_PAYLOAD_CRC );
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t payload_schedule_next( void )
+{
+    const uint32_t length = payload_schedule_next_length();
+
+#if defined(TEST_PAYLOAD_SCHEDULE_COUNT)
+    // Every frame is a prefix of the payload with its own length up front
+    frame_header_write( test_payload, length );
+#endif
+
+    return length;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t payload_schedule_next_length( void )
+{
+#if defined(TEST_PAYLOAD_SCHEDULE_COUNT)
+    const uint32_t length = test_payload_schedule[schedule_index].length;
+
+    schedule_index = ( schedule_index + 1 ) % TEST_PAYLOAD_SCHEDULE_COUNT;
+    return length;
+#else
+    return TEST_PAYLOAD_SIZE;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t payload_schedule_echo( uint32_t length )
+{
+#if defined(TEST_PAYLOAD_SCHEDULE_COUNT)
+    frame_header_write( test_payload, length );
+#endif
+
+    return length;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,55 @@
+#ifndef PAYLOAD_SCHEDULE_H
+#define PAYLOAD_SCHEDULE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "frame_validator.h"
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Sets up the receiver for the generated test payload: the single payload,
+ *  or any frame of the schedule if the build has one (PAYLOAD_SCHEDULE)
+ */
+
+void payload_schedule_validator_init( frame_validator_t *v );
+
+/* -------------------------------------------------------------------------- */
+
+/** Gets test_payload ready for the next trigger and returns how many of its
+ *  bytes to send. Without a schedule that's always the whole payload, with
+ *  one it steps to the next size and writes that into the frame header.
+ *  Only call it once the previous frame has been handed off completely.
+ */
+
+uint32_t payload_schedule_next( void );
+
+/* -------------------------------------------------------------------------- */
+
+/** Steps the schedule like payload_schedule_next() but leaves test_payload
+ *  alone, for senders that put their own headers on (frame_sequencer)
+ */
+
+uint32_t payload_schedule_next_length( void );
+
+/* -------------------------------------------------------------------------- */
+
+/** Gets test_payload ready to send back a frame of length bytes that was just
+ *  received, for the RTT echo. Returns length.
+ */
+
+uint32_t payload_schedule_echo( uint32_t length );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PAYLOAD_SCHEDULE_H */
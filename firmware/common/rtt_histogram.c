@@ -0,0 +1,125 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "rtt_histogram.h"
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void rtt_histogram_init( rtt_histogram_t *h, uint32_t cycles_per_us )
+{
+    memset( h, 0, sizeof( *h ) );
+
+    h->magic          = RTT_HISTOGRAM_MAGIC;
+    h->version        = RTT_HISTOGRAM_VERSION;
+    h->precision_bits = RTT_HISTOGRAM_PRECISION_BITS;
+    h->cycles_per_us  = cycles_per_us;
+    h->bin_count      = RTT_HISTOGRAM_BINS;
+    h->min_cycles     = UINT32_MAX;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void rtt_histogram_record( rtt_histogram_t *h, uint32_t cycles )
+{
+    h->bins[rtt_histogram_index( cycles )]++;
+    h->samples++;
+    h->total_cycles += cycles;
+
+    if( cycles < h->min_cycles )
+    {
+        h->min_cycles = cycles;
+    }
+
+    if( cycles > h->max_cycles )
+    {
+        h->max_cycles = cycles;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void rtt_histogram_record_lost( rtt_histogram_t *h )
+{
+    h->lost++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t rtt_histogram_index( uint32_t cycles )
+{
+    if( cycles < 2u * RTT_HISTOGRAM_HALF )
+    {
+        return cycles;
+    }
+
+    // Keep the top precision_bits - 1 bits below the leading one
+    const uint32_t shift = 31u - (uint32_t)__builtin_clz( cycles ) - ( RTT_HISTOGRAM_PRECISION_BITS - 1u );
+
+    return shift * RTT_HISTOGRAM_HALF + ( cycles >> shift );
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t rtt_histogram_bin_lower( uint32_t index )
+{
+    if( index < 2u * RTT_HISTOGRAM_HALF )
+    {
+        return index;
+    }
+
+    const uint32_t shift = index / RTT_HISTOGRAM_HALF - 1u;
+
+    return ( RTT_HISTOGRAM_HALF + index % RTT_HISTOGRAM_HALF ) << shift;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t rtt_histogram_bin_width( uint32_t index )
+{
+    if( index < 2u * RTT_HISTOGRAM_HALF )
+    {
+        return 1;
+    }
+
+    return 1u << ( index / RTT_HISTOGRAM_HALF - 1u );
+}
+
+/* -------------------------------------------------------------------------- */
+
+void rtt_histogram_print( const rtt_histogram_t *h, void ( *print )( const char *line ) )
+{
+    char line[64];
+
+    snprintf( line,
+              sizeof( line ),
+              "rtt-histogram %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32,
+              h->cycles_per_us,
+              h->samples,
+              h->lost,
+              h->samples ? h->min_cycles : 0,
+              h->max_cycles );
+    print( line );
+
+    for( uint32_t i = 0; i < RTT_HISTOGRAM_BINS; i++ )
+    {
+        if( h->bins[i] )
+        {
+            snprintf( line,
+                      sizeof( line ),
+                      "rtt-bin %" PRIu32 " %" PRIu32 " %" PRIu32,
+                      rtt_histogram_bin_lower( i ),
+                      rtt_histogram_bin_width( i ),
+                      h->bins[i] );
+            print( line );
+        }
+    }
+
+    print( "rtt-end" );
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,97 @@
+#ifndef RTT_HISTOGRAM_H
+#define RTT_HISTOGRAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define RTT_HISTOGRAM_MAGIC   (0x48545452u)    // "RTTH" in memory
+#define RTT_HISTOGRAM_VERSION (1u)
+
+// Bins are log-linear in CPU cycles. Values below 2^bits get a bin each, and
+// every power of two above that is split into 2^(bits-1) equal bins, so a bin
+// is never wider than 1/2^(bits-1) of its value. 7 bits is under 1.6% wide
+// for 1728 bins (6.9 KB).
+#ifndef RTT_HISTOGRAM_PRECISION_BITS
+    #define RTT_HISTOGRAM_PRECISION_BITS (7u)
+#endif
+
+#define RTT_HISTOGRAM_HALF (1u << ( RTT_HISTOGRAM_PRECISION_BITS - 1u ))
+#define RTT_HISTOGRAM_BINS ( ( 34u - RTT_HISTOGRAM_PRECISION_BITS ) * RTT_HISTOGRAM_HALF )
+
+/* ----- Types -------------------------------------------------------------- */
+
+// Round trip times kept on the board. The layout is fixed (little endian,
+// no padding on Cortex-M or Xtensa) so the struct can be dumped as is with a
+// debugger and decoded by rtt-import in analysis/latency-tools.
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t  precision_bits;
+    uint8_t  reserved;
+    uint32_t cycles_per_us;
+    uint32_t bin_count;
+    uint32_t samples;
+    uint32_t lost;              // pings that weren't echoed in time
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t bins[RTT_HISTOGRAM_BINS];
+} rtt_histogram_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Clears the histogram. cycles_per_us is the clock the samples are counted
+ *  in, kept with them so the dump can be converted to time.
+ */
+
+void rtt_histogram_init( rtt_histogram_t *h, uint32_t cycles_per_us );
+
+/* -------------------------------------------------------------------------- */
+
+void rtt_histogram_record( rtt_histogram_t *h, uint32_t cycles );
+
+/* -------------------------------------------------------------------------- */
+
+void rtt_histogram_record_lost( rtt_histogram_t *h );
+
+/* -------------------------------------------------------------------------- */
+
+/** The bin a value falls in */
+
+uint32_t rtt_histogram_index( uint32_t cycles );
+
+/* -------------------------------------------------------------------------- */
+
+/** Smallest value in bin index, and how many values the bin covers */
+
+uint32_t rtt_histogram_bin_lower( uint32_t index );
+
+uint32_t rtt_histogram_bin_width( uint32_t index );
+
+/* -------------------------------------------------------------------------- */
+
+/** Writes the histogram as text for boards with a console, a summary line,
+ *  a line per non-empty bin and an end marker:
+ *      rtt-histogram <cycles/us> <samples> <lost> <min> <max>
+ *      rtt-bin <lower> <width> <count>
+ *      rtt-end
+ *  Values are in cycles. print gets each line without a newline.
+ */
+
+void rtt_histogram_print( const rtt_histogram_t *h, void ( *print )( const char *line ) );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* RTT_HISTOGRAM_H */
@@ -0,0 +1,239 @@
+# Generates the benchmark test payload and its CRC at configure time, so the
+# firmware doesn't carry kilobyte long literals or work the CRC out at boot.
+#
+#   include(<path to firmware/common>/test_payload.cmake)
+#   test_payload_generate(${CMAKE_CURRENT_BINARY_DIR} ${PAYLOAD_SIZE} [SCHEDULE ${PAYLOAD_SCHEDULE}])
+#
+# writes test_payload.h and test_payload.c into the output folder. The .c
+# needs adding to the target's sources and the folder to its include paths.
+#
+# With a SCHEDULE of sizes the payload is as long as the largest of them and
+# the header also gets TEST_PAYLOAD_SCHEDULE_COUNT and test_payload_schedule[],
+# the length and CRC of every frame the sender will cycle through. Those
+# frames carry their length in bytes 1 and 2 (see frame_header_write()), so
+# their CRCs are worked out with the header in place.
+#
+# The payload is the 0x00 start byte then a count written in base 255 with no
+# zero digits: 0x01..0xFF as single bytes, then 0x01 0x01, 0x01 0x02 .. as
+# pairs. The start byte is the only zero, and the 12/128/1024 B payloads are
+# identical to the literals the firmware used to carry.
+
+cmake_minimum_required(VERSION 3.16)
+
+# CRC-16/CCITT-FALSE, must match firmware/common/crc16.h
+set(TEST_PAYLOAD_CRC_POLY 4129)     # 0x1021
+set(TEST_PAYLOAD_CRC_SEED 65535)    # 0xFFFF
+
+set(TEST_PAYLOAD_MAX_SIZE 65535)    # bytes_sent counters are 16-bit
+
+# FRAME_LENGTH_MIN/MAX in firmware/common/frame_validator.h
+set(TEST_PAYLOAD_SCHEDULE_MIN 4)
+set(TEST_PAYLOAD_SCHEDULE_MAX 65024)
+
+# CRC16 of a list of byte values, continuing from crc
+function(_test_payload_crc RESULT crc table bytes)
+    foreach(byte IN LISTS bytes)
+        math(EXPR index "((${crc} >> 8) ^ ${byte}) & 255")
+        list(GET table ${index} entry)
+        math(EXPR crc "((${crc} << 8) & 65535) ^ ${entry}")
+    endforeach()
+    set(${RESULT} ${crc} PARENT_SCOPE)
+endfunction()
+
+# 0xABCD style text for a 16-bit value
+function(_test_payload_hex16 RESULT value hex)
+    math(EXPR high "${value} >> 8")
+    math(EXPR low "${value} & 255")
+    list(GET hex ${high} high_text)
+    list(GET hex ${low} low_text)
+    string(SUBSTRING "${low_text}" 2 2 low_text)
+    set(${RESULT} "${high_text}${low_text}" PARENT_SCOPE)
+endfunction()
+
+function(test_payload_generate OUTPUT_DIR SIZE)
+    cmake_parse_arguments(PARSE_ARGV 2 ARG "" "" "SCHEDULE")
+
+    if(ARG_SCHEDULE)
+        # The payload is shared by every frame, so it's as long as the largest
+        set(SIZE 0)
+        foreach(length IN LISTS ARG_SCHEDULE)
+            if(NOT length MATCHES "^[0-9]+$" OR length LESS TEST_PAYLOAD_SCHEDULE_MIN OR length GREATER TEST_PAYLOAD_SCHEDULE_MAX)
+                message(FATAL_ERROR "Scheduled payload sizes must be ${TEST_PAYLOAD_SCHEDULE_MIN} to ${TEST_PAYLOAD_SCHEDULE_MAX} bytes, got '${length}'")
+            endif()
+            if(length GREATER SIZE)
+                set(SIZE ${length})
+            endif()
+        endforeach()
+    endif()
+
+    if(NOT SIZE MATCHES "^[0-9]+$" OR SIZE LESS 1 OR SIZE GREATER TEST_PAYLOAD_MAX_SIZE)
+        message(FATAL_ERROR "Test payload size must be 1 to ${TEST_PAYLOAD_MAX_SIZE} bytes, got '${SIZE}'")
+    endif()
+
+    # "0x00" .. "0xFF" for formatting, and the byte-wise CRC table
+    set(digits 0 1 2 3 4 5 6 7 8 9 A B C D E F)
+    set(hex "")
+    set(table "")
+
+    foreach(value RANGE 255)
+        math(EXPR high "${value} >> 4")
+        math(EXPR low "${value} & 15")
+        list(GET digits ${high} h)
+        list(GET digits ${low} l)
+        list(APPEND hex "0x${h}${l}")
+
+        math(EXPR crc "${value} << 8")
+        foreach(bit RANGE 7)
+            math(EXPR top "${crc} & 32768")
+            if(top)
+                math(EXPR crc "((${crc} << 1) ^ ${TEST_PAYLOAD_CRC_POLY}) & 65535")
+            else()
+                math(EXPR crc "(${crc} << 1) & 65535")
+            endif()
+        endforeach()
+        list(APPEND table ${crc})
+    endforeach()
+
+    # Start byte, then the singles, then the pairs
+    set(bytes 0)
+    set(count 1)
+
+    foreach(value RANGE 1 255)
+        if(count EQUAL SIZE)
+            break()
+        endif()
+        list(APPEND bytes ${value})
+        math(EXPR count "${count} + 1")
+    endforeach()
+
+    set(high 1)
+    set(low 1)
+    while(count LESS SIZE)
+        list(APPEND bytes ${high})
+        math(EXPR count "${count} + 1")
+
+        if(count LESS SIZE)
+            list(APPEND bytes ${low})
+            math(EXPR count "${count} + 1")
+        endif()
+
+        math(EXPR low "${low} + 1")
+        if(low GREATER 255)
+            set(low 1)
+            math(EXPR high "${high} + 1")
+        endif()
+    endwhile()
+
+    # The initializer, ten bytes a line
+    _test_payload_crc(crc ${TEST_PAYLOAD_CRC_SEED} "${table}" "${bytes}")
+    set(body "")
+    set(column 0)
+
+    foreach(byte IN LISTS bytes)
+        list(GET hex ${byte} text)
+        if(column EQUAL 0)
+            string(APPEND body "        ")
+        endif()
+        string(APPEND body "${text},")
+        math(EXPR column "${column} + 1")
+
+        if(column EQUAL 10)
+            string(APPEND body "\n")
+            set(column 0)
+        else()
+            string(APPEND body " ")
+        endif()
+    endforeach()
+    string(STRIP "${body}" body)
+
+    _test_payload_hex16(crc_text ${crc} "${hex}")
+
+    # Each scheduled frame is the start byte, its length header and the rest
+    # of the payload up to that length
+    set(schedule_header "")
+    set(schedule_source "")
+    set(schedule_text "")
+
+    if(ARG_SCHEDULE)
+        list(LENGTH ARG_SCHEDULE schedule_count)
+        set(entries "")
+
+        foreach(length IN LISTS ARG_SCHEDULE)
+            math(EXPR digit_high "1 + ${length} / 255")
+            math(EXPR digit_low "1 + ${length} % 255")
+            math(EXPR rest "${length} - 3")
+            list(SUBLIST bytes 3 ${rest} frame)
+            list(PREPEND frame 0 ${digit_high} ${digit_low})
+
+            _test_payload_crc(frame_crc ${TEST_PAYLOAD_CRC_SEED} "${table}" "${frame}")
+            _test_payload_hex16(frame_crc_text ${frame_crc} "${hex}")
+            string(APPEND entries "        { ${length}u, ${frame_crc_text}u },\n")
+            list(APPEND schedule_text "${length} B (CRC ${frame_crc_text})")
+        endforeach()
+        string(STRIP "${entries}" entries)
+
+        set(schedule_header "
+#include \"frame_validator.h\"
+
+// Frames the sender cycles through, in order
+#define TEST_PAYLOAD_SCHEDULE_COUNT (${schedule_count}u)
+
+extern const frame_size_t test_payload_schedule[TEST_PAYLOAD_SCHEDULE_COUNT];
+")
+        set(schedule_source "
+const frame_size_t test_payload_schedule[TEST_PAYLOAD_SCHEDULE_COUNT] = {
+        ${entries}
+};
+")
+    endif()
+
+    set(header "// Generated by firmware/common/test_payload.cmake, don't edit
+
+#ifndef TEST_PAYLOAD_H
+#define TEST_PAYLOAD_H
+
+#include <stdint.h>
+
+#define TEST_PAYLOAD_SIZE (${SIZE}u)
+#define TEST_PAYLOAD_CRC  (${crc_text}u)   // CRC16 of the whole payload
+
+extern uint8_t test_payload[TEST_PAYLOAD_SIZE];
+${schedule_header}
+#endif /* TEST_PAYLOAD_H */
+")
+
+    set(source "// Generated by firmware/common/test_payload.cmake, don't edit
+
+#include \"test_payload.h\"
+
+uint8_t test_payload[TEST_PAYLOAD_SIZE] = {
+        ${body}
+};
+${schedule_source}")
+
+    # Only touch the files when the payload changed so nothing rebuilds needlessly
+    file(MAKE_DIRECTORY ${OUTPUT_DIR})
+    foreach(name test_payload.h test_payload.c)
+        if(name STREQUAL "test_payload.h")
+            set(content "${header}")
+        else()
+            set(content "${source}")
+        endif()
+
+        set(existing "")
+        if(EXISTS ${OUTPUT_DIR}/${name})
+            file(READ ${OUTPUT_DIR}/${name} existing)
+        endif()
+
+        if(NOT existing STREQUAL content)
+            file(WRITE ${OUTPUT_DIR}/${name} "${content}")
+        endif()
+    endforeach()
+
+    if(ARG_SCHEDULE)
+        list(JOIN schedule_text ", " schedule_text)
+        message(STATUS "Test payload schedule: ${schedule_text}")
+    else()
+        message(STATUS "Test payload: ${SIZE} B, CRC ${crc_text}")
+    endif()
+endfunction()
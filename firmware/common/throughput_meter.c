@@ -0,0 +1,144 @@
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "throughput_meter.h"
+
+/* ----- Private Prototypes ------------------------------------------------- */
+
+static void throughput_sample_clear( throughput_sample_t *sample );
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void throughput_stream_init( throughput_stream_t *s, uint32_t duration_us )
+{
+    s->duration_us = duration_us;
+    s->started_us  = 0;
+    s->active      = false;
+    s->frames      = 0;
+    s->bytes       = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void throughput_stream_start( throughput_stream_t *s, uint32_t now_us )
+{
+    s->started_us = now_us;
+    s->active     = true;
+    s->frames     = 0;
+    s->bytes      = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool throughput_stream_next( throughput_stream_t *s, uint32_t bytes, uint32_t now_us )
+{
+    if( !s->active )
+    {
+        return false;
+    }
+
+    s->frames++;
+    s->bytes += bytes;
+
+    if( now_us - s->started_us >= s->duration_us )
+    {
+        s->active = false;
+    }
+
+    return s->active;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void throughput_meter_init( throughput_meter_t *m, uint32_t window_us )
+{
+    m->window_us       = window_us;
+    m->active          = false;
+    m->window_start_us = 0;
+    m->burst_start_us  = 0;
+    m->last_frame_us   = 0;
+    m->frames_seen     = 0;
+    m->bytes_seen      = 0;
+    m->report_count    = 0;
+
+    throughput_sample_clear( &m->current );
+    throughput_sample_clear( &m->window );
+    throughput_sample_clear( &m->burst );
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool throughput_meter_update( throughput_meter_t *m, const frame_validator_t *v, uint32_t now_us )
+{
+    const uint32_t frames = v->frames - m->frames_seen;
+    const uint32_t bytes  = v->bytes - m->bytes_seen;
+    bool           report = false;
+
+    m->frames_seen = v->frames;
+    m->bytes_seen  = v->bytes;
+
+    if( frames && !m->active )
+    {
+        // The first frames were on the air before there was anything to time
+        // them from, so they only mark the start
+        m->active          = true;
+        m->burst_start_us  = now_us;
+        m->window_start_us = now_us;
+        m->last_frame_us   = now_us;
+
+        throughput_sample_clear( &m->current );
+        throughput_sample_clear( &m->burst );
+    }
+    else if( frames )
+    {
+        m->current.frames += frames;
+        m->current.bytes += bytes;
+        m->burst.frames += frames;
+        m->burst.bytes += bytes;
+        m->burst.elapsed_us = now_us - m->burst_start_us;
+        m->last_frame_us    = now_us;
+    }
+
+    if( m->active && now_us - m->window_start_us >= m->window_us )
+    {
+        // Over the time actually elapsed, in case updates came in late
+        m->window            = m->current;
+        m->window.elapsed_us = now_us - m->window_start_us;
+        m->window_start_us   = now_us;
+
+        throughput_sample_clear( &m->current );
+
+        // A quiet window ends the burst, which was timed up to its last frame
+        if( !m->window.frames )
+        {
+            m->active = false;
+        }
+
+        m->report_count++;
+        report = true;
+    }
+
+    return report;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t throughput_per_second( uint32_t count, uint32_t elapsed_us )
+{
+    if( !elapsed_us )
+    {
+        return 0;
+    }
+
+    return (uint32_t)( (uint64_t)count * 1000000u / elapsed_us );
+}
+
+/* ----- Private Functions -------------------------------------------------- */
+
+static void throughput_sample_clear( throughput_sample_t *sample )
+{
+    sample->frames     = 0;
+    sample->bytes      = 0;
+    sample->elapsed_us = 0;
+}
+
+/* ----- End ---------------------------------------------------------------- */
@@ -0,0 +1,109 @@
+#ifndef THROUGHPUT_METER_H
+#define THROUGHPUT_METER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "frame_validator.h"
+
+/* ----- Defines ------------------------------------------------------------ */
+
+// Goodput is reported once per window while frames keep arriving
+#ifndef THROUGHPUT_WINDOW_US
+    #define THROUGHPUT_WINDOW_US (1000000u)
+#endif
+
+/* ----- Types -------------------------------------------------------------- */
+
+typedef struct
+{
+    uint32_t frames;        // valid frames
+    uint32_t bytes;         // bytes of those frames
+    uint32_t elapsed_us;
+} throughput_sample_t;
+
+// Sender side of the streaming benchmark. A trigger starts a stream, and
+// frames follow back to back until duration_us has passed.
+typedef struct
+{
+    uint32_t duration_us;
+    uint32_t started_us;
+    bool     active;
+    uint32_t frames;        // frames started in this stream
+    uint32_t bytes;
+} throughput_stream_t;
+
+// Receiver side, fed from a frame_validator_t's counters. A burst starts with
+// the first valid frame after a quiet window and ends when a whole window
+// passes without one. Time is in microseconds from any free running clock,
+// wrapping is fine.
+//
+// Results are plain fields so a debugger or probe can read them without the
+// firmware's help: report_count changes after window and burst are updated.
+typedef struct
+{
+    uint32_t            window_us;
+    bool                active;
+    uint32_t            window_start_us;
+    uint32_t            burst_start_us;
+    uint32_t            last_frame_us;
+    uint32_t            frames_seen;        // validator counters last update
+    uint32_t            bytes_seen;
+    throughput_sample_t current;            // open window
+    throughput_sample_t window;             // last closed window
+    throughput_sample_t burst;              // since the burst's first frame
+    volatile uint32_t   report_count;
+} throughput_meter_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void throughput_stream_init( throughput_stream_t *s, uint32_t duration_us );
+
+/* -------------------------------------------------------------------------- */
+
+/** Starts (or restarts) a stream, the caller sends its first frame */
+
+void throughput_stream_start( throughput_stream_t *s, uint32_t now_us );
+
+/* -------------------------------------------------------------------------- */
+
+/** Call as each frame has been handed off completely. True if the next one
+ *  should follow straight away, false once the duration is up (which ends
+ *  the stream) or if no stream is running.
+ */
+
+bool throughput_stream_next( throughput_stream_t *s, uint32_t bytes, uint32_t now_us );
+
+/* -------------------------------------------------------------------------- */
+
+void throughput_meter_init( throughput_meter_t *m, uint32_t window_us );
+
+/* -------------------------------------------------------------------------- */
+
+/** Takes in any frames v validated since the last call. Call it after every
+ *  feed and regularly in between so windows close on time. True when there's
+ *  a new report: a window closed, or the burst ended (active went false).
+ */
+
+bool throughput_meter_update( throughput_meter_t *m, const frame_validator_t *v, uint32_t now_us );
+
+/* -------------------------------------------------------------------------- */
+
+/** count per second over elapsed_us, 0 for an empty sample */
+
+uint32_t throughput_per_second( uint32_t count, uint32_t elapsed_us );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* THROUGHPUT_METER_H */
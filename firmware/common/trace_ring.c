@@ -0,0 +1,58 @@
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ----- Local Includes ----------------------------------------------------- */
+
+#include "trace_ring.h"
+
+/* ----- Public Functions --------------------------------------------------- */
+
+void trace_ring_init( trace_ring_t *ring, uint32_t cycles_per_us )
+{
+    memset( (void *)ring, 0, sizeof( *ring ) );
+
+    ring->magic         = TRACE_RING_MAGIC;
+    ring->version       = TRACE_RING_VERSION;
+    ring->length        = TRACE_RING_LENGTH;
+    ring->cycles_per_us = cycles_per_us;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t trace_ring_print( const trace_ring_t *ring, uint32_t from, void ( *print )( const char *line ) )
+{
+    char           line[64];
+    const uint32_t head = ring->head;
+
+    // Only what's still in the ring, unsigned so it holds across the wrap
+    if( head - from > TRACE_RING_LENGTH )
+    {
+        from = head - TRACE_RING_LENGTH;
+    }
+
+    snprintf( line, sizeof( line ), "trace-ring %" PRIu32 " %" PRIu32, ring->cycles_per_us, head );
+    print( line );
+
+    for( uint32_t sequence = from; sequence != head; sequence++ )
+    {
+        const trace_record_t *record = &ring->records[sequence & ( TRACE_RING_LENGTH - 1u )];
+
+        snprintf( line,
+                  sizeof( line ),
+                  "trace %" PRIu32 " %u %u %" PRIu32,
+                  sequence,
+                  (unsigned)record->event,
+                  (unsigned)record->arg,
+                  record->cycles );
+        print( line );
+    }
+
+    print( "trace-end" );
+
+    return head;
+}
+
+/* ----- End ---------------------------------------------------------------- */
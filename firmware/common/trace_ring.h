@@ -0,0 +1,101 @@
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----- System Includes ---------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ----- Defines ------------------------------------------------------------ */
+
+#define TRACE_RING_MAGIC   (0x45435254u)    // "TRCE" in memory
+#define TRACE_RING_VERSION (1u)
+
+// Records kept, the oldest are overwritten. 256 is 2 KB, a few dozen frames.
+#ifndef TRACE_RING_LENGTH
+    #define TRACE_RING_LENGTH (256u)
+#endif
+
+#if ( TRACE_RING_LENGTH & ( TRACE_RING_LENGTH - 1u ) ) != 0
+    #error "TRACE_RING_LENGTH must be a power of two"
+#endif
+
+/* ----- Types -------------------------------------------------------------- */
+
+// The stages a frame passes through, ids are part of the dump format
+typedef enum
+{
+    TRACE_EVENT_NONE = 0,
+    TRACE_EVENT_TRIGGER,        // trigger input interrupt
+    TRACE_EVENT_SEND,           // chunk handed to the stack, arg = bytes
+    TRACE_EVENT_SEND_DONE,      // stack's send complete callback, arg = bytes
+    TRACE_EVENT_RECV,           // stack's receive callback, arg = bytes
+    TRACE_EVENT_VALID,          // frame passed validation, arg = frame length
+} trace_event_t;
+
+typedef struct
+{
+    uint32_t cycles;
+    uint16_t event;
+    uint16_t arg;
+} trace_record_t;
+
+// Same approach as rtt_histogram_t, a fixed little endian layout so the ring
+// can be dumped as is with a debugger and decoded by trace-breakdown in
+// analysis/latency-tools.
+typedef struct
+{
+    uint32_t          magic;
+    uint16_t          version;
+    uint16_t          length;
+    uint32_t          cycles_per_us;
+    volatile uint32_t head;         // records written since init
+    trace_record_t    records[TRACE_RING_LENGTH];
+} trace_ring_t;
+
+/* ----- Public Functions --------------------------------------------------- */
+
+/** Clears the ring. cycles_per_us is the clock the records are stamped with. */
+
+void trace_ring_init( trace_ring_t *ring, uint32_t cycles_per_us );
+
+/* -------------------------------------------------------------------------- */
+
+/** Stores one record, from a task or an interrupt. The slot is claimed with a
+ *  single atomic add (LDREX/STREX on Cortex-M) and filled with three stores,
+ *  so an event costs a few tens of cycles and can stay on in release builds.
+ */
+
+static inline void trace_ring_record( trace_ring_t *ring, uint16_t event, uint16_t arg, uint32_t cycles )
+{
+    const uint32_t slot = __atomic_fetch_add( &ring->head, 1u, __ATOMIC_RELAXED ) & ( TRACE_RING_LENGTH - 1u );
+
+    ring->records[slot].cycles = cycles;
+    ring->records[slot].event  = event;
+    ring->records[slot].arg    = arg;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/** Writes the records from sequence number from onwards as text, a header,
+ *  a line per record and an end marker:
+ *      trace-ring <cycles/us> <head>
+ *      trace <sequence> <event> <arg> <cycles>
+ *      trace-end
+ *  Records already overwritten are skipped, which shows up as a gap in the
+ *  sequence numbers. Returns the head to pass as from next time so repeated
+ *  calls only print what's new. print gets each line without a newline.
+ */
+
+uint32_t trace_ring_print( const trace_ring_t *ring, uint32_t from, void ( *print )( const char *line ) );
+
+/* ----- End ---------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRACE_RING_H */
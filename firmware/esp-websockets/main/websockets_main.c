@@ -5,11 +5,6 @@
 // #define WS_MODE (SERVER)
 #define WS_MODE (CLIENT)
 
-// Packet size test length settings
-#define PAYLOAD_12B
-// #define PAYLOAD_128B
-// #define PAYLOAD_1024B
-
 /* -------------------------------------------------------------------------- */
 
 #include <stdio.h>
@@ -31,6 +26,11 @@
 #include "websockets_main_defs.h"
 #include "websocket_server.h"
 #include "websocket_client.h"
+#include "frame_validator.h"
+#include "payload_schedule.h"
+#include "frame_sequencer.h"
+#include "frame_reassembler.h"
+#include "test_payload.h"
 
 /* -------------------------------------------------------------------------- */
 
@@ -55,151 +55,19 @@ static QueueHandle_t bench_evt_queue;
 /* -------------------------------------------------------------------------- */
 
 volatile bool trigger_pending = false;
+volatile uint32_t triggers_seen = 0;    // only written by the ISR
 
-#define CRC_SEED (0xFFFFu)
-uint16_t bytes_read = 0;
 uint16_t bytes_sent = 0;
 uint16_t bytes_pending = 0;
 
-uint16_t working_crc = CRC_SEED;
-uint16_t payload_crc = 0x00;
-
-#if defined(PAYLOAD_12B)
-    uint8_t test_payload[12] = {
-            0x00,
-            0x01, 0x02, 0x03, 0x04, 0x05,
-            0x06, 0x07, 0x08, 0x09, 0x0A,
-            0x0B,
-    };
-#elif defined(PAYLOAD_128B)
-    uint8_t test_payload[128] = {
-            0x00,
-            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-            0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14,
-            0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E,
-            0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
-            0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
-            0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C,
-            0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
-            0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50,
-            0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A,
-            0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x64,
-            0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E,
-            0x6F, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
-            0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F,
-    };
-#elif defined(PAYLOAD_1024B)
-    uint8_t test_payload[1024] = {
-            0x00,
-            // Sequential set of 255 bytes
-            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-            0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14,
-            0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E,
-            0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
-            0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
-            0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C,
-            0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
-            0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50,
-            0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A,
-            0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x64,
-            0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E,
-            0x6F, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
-            0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F, 0x80, 0x81, 0x82,
-            0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C,
-            0x8D, 0x8E, 0x8F, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96,
-            0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F, 0xA0,
-            0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA,
-            0xAB, 0xAC, 0xAD, 0xAE, 0xAF, 0xB0, 0xB1, 0xB2, 0xB3, 0xB4,
-            0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE,
-            0xBF, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8,
-            0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF, 0xD0, 0xD1, 0xD2,
-            0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xDB, 0xDC,
-            0xDD, 0xDE, 0xDF, 0xE0, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6,
-            0xE7, 0xE8, 0xE9, 0xEA, 0xEB, 0xEC, 0xED, 0xEE, 0xEF, 0xF0,
-            0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA,
-            0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
-
-            // Next run of 255 bytes consumes 510 bytes
-            0x01, 0x01, 0x01, 0x02, 0x01, 0x03, 0x01, 0x04,0x01, 0x05,
-            0x01, 0x06, 0x01, 0x07, 0x01, 0x08, 0x01, 0x09,0x01, 0x0A,
-            0x01, 0x0B, 0x01, 0x0C, 0x01, 0x0D, 0x01, 0x0E,0x01, 0x0F,
-            0x01, 0x10, 0x01, 0x11, 0x01, 0x12, 0x01, 0x13,0x01, 0x14,
-            0x01, 0x15, 0x01, 0x16, 0x01, 0x17, 0x01, 0x18,0x01, 0x19,
-            0x01, 0x1A, 0x01, 0x1B, 0x01, 0x1C, 0x01, 0x1D,0x01, 0x1E,
-            0x01, 0x1F, 0x01, 0x20, 0x01, 0x21, 0x01, 0x22,0x01, 0x23,
-            0x01, 0x24, 0x01, 0x25, 0x01, 0x26, 0x01, 0x27,0x01, 0x28,
-            0x01, 0x29, 0x01, 0x2A, 0x01, 0x2B, 0x01, 0x2C,0x01, 0x2D,
-            0x01, 0x2E, 0x01, 0x2F, 0x01, 0x30, 0x01, 0x31,0x01, 0x32,
-            0x01, 0x33, 0x01, 0x34, 0x01, 0x35, 0x01, 0x36,0x01, 0x37,
-            0x01, 0x38, 0x01, 0x39, 0x01, 0x3A, 0x01, 0x3B,0x01, 0x3C,
-            0x01, 0x3D, 0x01, 0x3E, 0x01, 0x3F, 0x01, 0x40,0x01, 0x41,
-            0x01, 0x42, 0x01, 0x43, 0x01, 0x44, 0x01, 0x45,0x01, 0x46,
-            0x01, 0x47, 0x01, 0x48, 0x01, 0x49, 0x01, 0x4A,0x01, 0x4B,
-            0x01, 0x4C, 0x01, 0x4D, 0x01, 0x4E, 0x01, 0x4F,0x01, 0x50,
-            0x01, 0x51, 0x01, 0x52, 0x01, 0x53, 0x01, 0x54,0x01, 0x55,
-            0x01, 0x56, 0x01, 0x57, 0x01, 0x58, 0x01, 0x59,0x01, 0x5A,
-            0x01, 0x5B, 0x01, 0x5C, 0x01, 0x5D, 0x01, 0x5E,0x01, 0x5F,
-            0x01, 0x60, 0x01, 0x61, 0x01, 0x62, 0x01, 0x63,0x01, 0x64,
-            0x01, 0x65, 0x01, 0x66, 0x01, 0x67, 0x01, 0x68,0x01, 0x69,
-            0x01, 0x6A, 0x01, 0x6B, 0x01, 0x6C, 0x01, 0x6D,0x01, 0x6E,
-            0x01, 0x6F, 0x01, 0x70, 0x01, 0x71, 0x01, 0x72,0x01, 0x73,
-            0x01, 0x74, 0x01, 0x75, 0x01, 0x76, 0x01, 0x77,0x01, 0x78,
-            0x01, 0x79, 0x01, 0x7A, 0x01, 0x7B, 0x01, 0x7C,0x01, 0x7D,
-            0x01, 0x7E, 0x01, 0x7F, 0x01, 0x80, 0x01, 0x81,0x01, 0x82,
-            0x01, 0x83, 0x01, 0x84, 0x01, 0x85, 0x01, 0x86,0x01, 0x87,
-            0x01, 0x88, 0x01, 0x89, 0x01, 0x8A, 0x01, 0x8B,0x01, 0x8C,
-            0x01, 0x8D, 0x01, 0x8E, 0x01, 0x8F, 0x01, 0x90,0x01, 0x91,
-            0x01, 0x92, 0x01, 0x93, 0x01, 0x94, 0x01, 0x95,0x01, 0x96,
-            0x01, 0x97, 0x01, 0x98, 0x01, 0x99, 0x01, 0x9A,0x01, 0x9B,
-            0x01, 0x9C, 0x01, 0x9D, 0x01, 0x9E, 0x01, 0x9F,0x01, 0xA0,
-            0x01, 0xA1, 0x01, 0xA2, 0x01, 0xA3, 0x01, 0xA4,0x01, 0xA5,
-            0x01, 0xA6, 0x01, 0xA7, 0x01, 0xA8, 0x01, 0xA9,0x01, 0xAA,
-            0x01, 0xAB, 0x01, 0xAC, 0x01, 0xAD, 0x01, 0xAE,0x01, 0xAF,
-            0x01, 0xB0, 0x01, 0xB1, 0x01, 0xB2, 0x01, 0xB3,0x01, 0xB4,
-            0x01, 0xB5, 0x01, 0xB6, 0x01, 0xB7, 0x01, 0xB8,0x01, 0xB9,
-            0x01, 0xBA, 0x01, 0xBB, 0x01, 0xBC, 0x01, 0xBD,0x01, 0xBE,
-            0x01, 0xBF, 0x01, 0xC0, 0x01, 0xC1, 0x01, 0xC2,0x01, 0xC3,
-            0x01, 0xC4, 0x01, 0xC5, 0x01, 0xC6, 0x01, 0xC7,0x01, 0xC8,
-            0x01, 0xC9, 0x01, 0xCA, 0x01, 0xCB, 0x01, 0xCC,0x01, 0xCD,
-            0x01, 0xCE, 0x01, 0xCF, 0x01, 0xD0, 0x01, 0xD1,0x01, 0xD2,
-            0x01, 0xD3, 0x01, 0xD4, 0x01, 0xD5, 0x01, 0xD6,0x01, 0xD7,
-            0x01, 0xD8, 0x01, 0xD9, 0x01, 0xDA, 0x01, 0xDB,0x01, 0xDC,
-            0x01, 0xDD, 0x01, 0xDE, 0x01, 0xDF, 0x01, 0xE0,0x01, 0xE1,
-            0x01, 0xE2, 0x01, 0xE3, 0x01, 0xE4, 0x01, 0xE5,0x01, 0xE6,
-            0x01, 0xE7, 0x01, 0xE8, 0x01, 0xE9, 0x01, 0xEA,0x01, 0xEB,
-            0x01, 0xEC, 0x01, 0xED, 0x01, 0xEE, 0x01, 0xEF,0x01, 0xF0,
-            0x01, 0xF1, 0x01, 0xF2, 0x01, 0xF3, 0x01, 0xF4,0x01, 0xF5,
-            0x01, 0xF6, 0x01, 0xF7, 0x01, 0xF8, 0x01, 0xF9,0x01, 0xFA,
-            0x01, 0xFB, 0x01, 0xFC, 0x01, 0xFD, 0x01, 0xFE,  0x01, 0xFF,
-
-            // 1+255+510 bytes are done, this is the remaining 258B for total of 1024
-            0x02, 0x01, 0x02, 0x02, 0x02, 0x03, 0x02, 0x04, 0x02, 0x05,
-            0x02, 0x06, 0x02, 0x07, 0x02, 0x08, 0x02, 0x09, 0x02, 0x0A,
-            0x02, 0x0B, 0x02, 0x0C, 0x02, 0x0D, 0x02, 0x0E, 0x02, 0x0F,
-            0x02, 0x10, 0x02, 0x11, 0x02, 0x12, 0x02, 0x13, 0x02, 0x14,
-            0x02, 0x15, 0x02, 0x16, 0x02, 0x17, 0x02, 0x18, 0x02, 0x19,
-            0x02, 0x1A, 0x02, 0x1B, 0x02, 0x1C, 0x02, 0x1D, 0x02, 0x1E,
-            0x02, 0x1F, 0x02, 0x20, 0x02, 0x21, 0x02, 0x22, 0x02, 0x23,
-            0x02, 0x24, 0x02, 0x25, 0x02, 0x26, 0x02, 0x27, 0x02, 0x28,
-            0x02, 0x29, 0x02, 0x2A, 0x02, 0x2B, 0x02, 0x2C, 0x02, 0x2D,
-            0x02, 0x2E, 0x02, 0x2F, 0x02, 0x30, 0x02, 0x31, 0x02, 0x32,
-            0x02, 0x33, 0x02, 0x34, 0x02, 0x35, 0x02, 0x36, 0x02, 0x37,
-            0x02, 0x38, 0x02, 0x39, 0x02, 0x3A, 0x02, 0x3B, 0x02, 0x3C,
-            0x02, 0x3D, 0x02, 0x3E, 0x02, 0x3F, 0x02, 0x40, 0x02, 0x41,
-            0x02, 0x42, 0x02, 0x43, 0x02, 0x44, 0x02, 0x45, 0x02, 0x46,
-            0x02, 0x47, 0x02, 0x48, 0x02, 0x49, 0x02, 0x4A, 0x02, 0x4B,
-            0x02, 0x4C, 0x02, 0x4D, 0x02, 0x4E, 0x02, 0x4F, 0x02, 0x50,
-            0x02, 0x51, 0x02, 0x52, 0x02, 0x53, 0x02, 0x54, 0x02, 0x55,
-            0x02, 0x56, 0x02, 0x57, 0x02, 0x58, 0x02, 0x59, 0x02, 0x5A,
-            0x02, 0x5B, 0x02, 0x5C, 0x02, 0x5D, 0x02, 0x5E, 0x02, 0x5F,
-            0x02, 0x60, 0x02, 0x61, 0x02, 0x62, 0x02, 0x63, 0x02, 0x64,
-            0x02, 0x65, 0x02, 0x66, 0x02, 0x67, 0x02, 0x68, 0x02, 0x69,
-            0x02, 0x6A, 0x02, 0x6B, 0x02, 0x6C, 0x02, 0x6D, 0x02, 0x6E,
-            0x02, 0x6F, 0x02, 0x70, 0x02, 0x71, 0x02, 0x72, 0x02, 0x73,
-            0x02, 0x74, 0x02, 0x75, 0x02, 0x76, 0x02, 0x77, 0x02, 0x78,
-            0x02, 0x79, 0x02, 0x7A, 0x02, 0x7B, 0x02, 0x7C, 0x02, 0x7D,
-            0x02, 0x7E, 0x02, 0x7F, 0x02, 0x80, 0x02, 0x81
-    };
+frame_validator_t rx_validator;
+
+#if defined(BENCH_SEQUENCED)
+// Up to FRAME_SEQUENCE_WINDOW frames queued and in flight, see SEQUENCE_WINDOW
+frame_sequencer_t tx_sequencer;
+frame_reassembler_t rx_reassembler;
+static uint8_t tx_fragment[BENCH_DATA_MAX_LEN];
+static uint32_t triggers_taken = 0;
 #endif
 
 /* -------------------------------------------------------------------------- */
@@ -208,8 +76,6 @@ static void setup_gpio_output( void );
 static void setup_gpio_input( void );
 static void IRAM_ATTR gpio_isr_handler(void* arg);
 
-static void crc16(uint8_t data, uint16_t *crc);
-
 static void benchmark_task(void *pvParameter);
 
 /* -------------------------------------------------------------------------- */
@@ -249,17 +115,7 @@ void setup_gpio_input( void )
 static void IRAM_ATTR gpio_isr_handler(void* arg)
 {
     trigger_pending = true;
-}
-
-/* -------------------------------------------------------------------------- */
-
-static void crc16(uint8_t data, uint16_t *crc)
-{
-    *crc  = (uint8_t)(*crc >> 8) | (*crc << 8);
-    *crc ^= data;
-    *crc ^= (uint8_t)(*crc & 0xff) >> 4;
-    *crc ^= (*crc << 8) << 4;
-    *crc ^= ((*crc & 0xff) << 4) << 1;
+    triggers_seen++;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -295,15 +151,13 @@ void app_main( void )
     setup_gpio_output();
     setup_gpio_input();
 
-    // Work out the correct CRC for the active payload
-    working_crc = CRC_SEED;
-    for( uint16_t i = 0; i < sizeof(test_payload); i++ )
-    {
-        crc16( test_payload[i], &working_crc );
-    }
+    // The payload and its CRC are generated at build time
+    payload_schedule_validator_init( &rx_validator );
 
-    payload_crc = working_crc;
-    working_crc = CRC_SEED;
+#if defined(BENCH_SEQUENCED)
+    frame_sequencer_init( &tx_sequencer, test_payload, BENCH_DATA_MAX_LEN );
+    frame_reassembler_init( &rx_reassembler, test_payload, TEST_PAYLOAD_SIZE );
+#endif
 
     // Useful callback events need a queue for user-space handling 
     bench_evt_queue = xQueueCreate(BENCHMARK_QUEUE_SIZE, sizeof(bench_event_t));
@@ -333,15 +187,37 @@ static void benchmark_task(void *pvParameter)
 {
     bench_event_t evt;
     uint16_t bytes_sent = 0;
+    uint16_t payload_length = 0;
 
     while(1)
     {
+#if defined(BENCH_SEQUENCED)
+        // Every trigger queues a frame instead of restarting the one in
+        // flight, so triggers can come faster than a round trip
+        while( triggers_taken != triggers_seen )
+        {
+            triggers_taken++;
+            frame_sequencer_queue( &tx_sequencer, payload_schedule_next_length() );
+        }
+
+        // The sends block until the stack has taken the data, drain the queue
+        uint32_t fragment_length = 0;
+        while( ( fragment_length = frame_sequencer_next( &tx_sequencer, tx_fragment ) ) )
+        {
+#if WS_MODE == SERVER
+            websocket_server_send_payload( tx_fragment, fragment_length );
+#else
+            websocket_client_send_payload( tx_fragment, fragment_length );
+#endif
+        }
+#else
         if( trigger_pending )
         {
             // Chunk large payloads into smaller packets
             bytes_sent = 0;
+            payload_length = payload_schedule_next();
 
-            uint16_t bytes_to_send = sizeof(test_payload) - bytes_sent;
+            uint16_t bytes_to_send = payload_length - bytes_sent;
             if( bytes_to_send > BENCH_DATA_MAX_LEN )
             {
                 bytes_to_send = BENCH_DATA_MAX_LEN;
@@ -358,6 +234,7 @@ static void benchmark_task(void *pvParameter)
             
             trigger_pending = false;
         }
+#endif
 
         // Handle inbound data from callbacks
         if( xQueueReceive(bench_evt_queue, &evt, 1) )
@@ -376,9 +253,9 @@ static void benchmark_task(void *pvParameter)
                     bytes_pending = 0;
 
                     // Send the next chunk if needed
-                    if( bytes_sent < sizeof(test_payload) )
+                    if( bytes_sent < payload_length )
                     {
-                        uint16_t bytes_to_send = sizeof(test_payload) - bytes_sent;
+                        uint16_t bytes_to_send = payload_length - bytes_sent;
                         if( bytes_to_send > BENCH_DATA_MAX_LEN )
                         {
                             bytes_to_send = BENCH_DATA_MAX_LEN;
@@ -410,30 +287,24 @@ static void benchmark_task(void *pvParameter)
 
                     // ESP_LOGI(TAG, "Got %"PRIu32"B", recv_cb->data_len);
 
-                    for( uint16_t i = 0; i < recv_cb->data_len; i++ )
-                    {
-                        // Reset the "parser" if the start of a new test structure is seen
-                        if(recv_cb->data[i] == 0x00 )
-                        {
-                            bytes_read = 0;
-                            working_crc = CRC_SEED;
-                            // ESP_LOGI(TAG, "RESET\n");
-                        }
-
-                        // Running crc and byte count
-                        crc16( recv_cb->data[i], &working_crc );
-                        bytes_read++;
+#if defined(BENCH_SEQUENCED)
+                    // A pulse per reassembled frame so each trigger has its own
+                    uint32_t completed = frame_reassembler_feed( &rx_reassembler, recv_cb->data, recv_cb->data_len );
 
-                        // Identify the end of the packet via expected length and correct CRC
-                        if( bytes_read == sizeof(test_payload) && working_crc == payload_crc )
-                        {
-                            // Valid test structure
-                            gpio_set_level( GPIO_OUTPUT_IO_0, 1 );
-                            // ESP_LOGI(TAG, "GOOD \n");
-                        }
+                    for( ; completed; completed-- )
+                    {
+                        gpio_set_level( GPIO_OUTPUT_IO_0, 1 );
+                        gpio_set_level( GPIO_OUTPUT_IO_0, 0 );
+                    }
+#else
+                    if( frame_validator_feed( &rx_validator, recv_cb->data, recv_cb->data_len ) )
+                    {
+                        // Valid test structure
+                        gpio_set_level( GPIO_OUTPUT_IO_0, 1 );
                     }
 
                     gpio_set_level( GPIO_OUTPUT_IO_0, 0 );
+#endif
                     
                     // The rx callback uses malloc to store the inbound data
                     // so clean up after we're done handling that data
@@ -19,15 +19,16 @@
 #include "esp_mac.h"
 #include "esp_now.h"
 #include "esp_crc.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
 
 #include "driver/gpio.h"
-
-/* -------------------------------------------------------------------------- */
-
-// Packet size test length settings
-#define PAYLOAD_12B
-// #define PAYLOAD_128B
-//#define PAYLOAD_1024B
+#include "frame_validator.h"
+#include "payload_schedule.h"
+#include "rtt_histogram.h"
+#include "test_payload.h"
+#include "throughput_meter.h"
 
 /* -------------------------------------------------------------------------- */
 
@@ -105,147 +106,23 @@ static uint8_t s_example_broadcast_mac[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0
 
 volatile bool trigger_pending = false;
 
-#define CRC_SEED (0xFFFFu)
-uint16_t bytes_read = 0;
-uint16_t working_crc = CRC_SEED;
-uint16_t payload_crc = 0x00;
-
-#if defined(PAYLOAD_12B)
-    uint8_t test_payload[12] = {
-            0x00,
-            0x01, 0x02, 0x03, 0x04, 0x05,
-            0x06, 0x07, 0x08, 0x09, 0x0A,
-            0x0B,
-    };
-#elif defined(PAYLOAD_128B)
-    uint8_t test_payload[128] = {
-            0x00,
-            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-            0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14,
-            0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E,
-            0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
-            0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
-            0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C,
-            0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
-            0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50,
-            0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A,
-            0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x64,
-            0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E,
-            0x6F, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
-            0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F,
-    };
-#elif defined(PAYLOAD_1024B)
-    uint8_t test_payload[1024] = {
-            0x00,
-            // Sequential set of 255 bytes
-            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-            0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14,
-            0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E,
-            0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
-            0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
-            0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C,
-            0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
-            0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50,
-            0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A,
-            0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x64,
-            0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E,
-            0x6F, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
-            0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F, 0x80, 0x81, 0x82,
-            0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C,
-            0x8D, 0x8E, 0x8F, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96,
-            0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F, 0xA0,
-            0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA,
-            0xAB, 0xAC, 0xAD, 0xAE, 0xAF, 0xB0, 0xB1, 0xB2, 0xB3, 0xB4,
-            0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE,
-            0xBF, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8,
-            0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF, 0xD0, 0xD1, 0xD2,
-            0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xDB, 0xDC,
-            0xDD, 0xDE, 0xDF, 0xE0, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6,
-            0xE7, 0xE8, 0xE9, 0xEA, 0xEB, 0xEC, 0xED, 0xEE, 0xEF, 0xF0,
-            0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA,
-            0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
-
-            // Next run of 255 bytes consumes 510 bytes
-            0x01, 0x01, 0x01, 0x02, 0x01, 0x03, 0x01, 0x04,0x01, 0x05,
-            0x01, 0x06, 0x01, 0x07, 0x01, 0x08, 0x01, 0x09,0x01, 0x0A,
-            0x01, 0x0B, 0x01, 0x0C, 0x01, 0x0D, 0x01, 0x0E,0x01, 0x0F,
-            0x01, 0x10, 0x01, 0x11, 0x01, 0x12, 0x01, 0x13,0x01, 0x14,
-            0x01, 0x15, 0x01, 0x16, 0x01, 0x17, 0x01, 0x18,0x01, 0x19,
-            0x01, 0x1A, 0x01, 0x1B, 0x01, 0x1C, 0x01, 0x1D,0x01, 0x1E,
-            0x01, 0x1F, 0x01, 0x20, 0x01, 0x21, 0x01, 0x22,0x01, 0x23,
-            0x01, 0x24, 0x01, 0x25, 0x01, 0x26, 0x01, 0x27,0x01, 0x28,
-            0x01, 0x29, 0x01, 0x2A, 0x01, 0x2B, 0x01, 0x2C,0x01, 0x2D,
-            0x01, 0x2E, 0x01, 0x2F, 0x01, 0x30, 0x01, 0x31,0x01, 0x32,
-            0x01, 0x33, 0x01, 0x34, 0x01, 0x35, 0x01, 0x36,0x01, 0x37,
-            0x01, 0x38, 0x01, 0x39, 0x01, 0x3A, 0x01, 0x3B,0x01, 0x3C,
-            0x01, 0x3D, 0x01, 0x3E, 0x01, 0x3F, 0x01, 0x40,0x01, 0x41,
-            0x01, 0x42, 0x01, 0x43, 0x01, 0x44, 0x01, 0x45,0x01, 0x46,
-            0x01, 0x47, 0x01, 0x48, 0x01, 0x49, 0x01, 0x4A,0x01, 0x4B,
-            0x01, 0x4C, 0x01, 0x4D, 0x01, 0x4E, 0x01, 0x4F,0x01, 0x50,
-            0x01, 0x51, 0x01, 0x52, 0x01, 0x53, 0x01, 0x54,0x01, 0x55,
-            0x01, 0x56, 0x01, 0x57, 0x01, 0x58, 0x01, 0x59,0x01, 0x5A,
-            0x01, 0x5B, 0x01, 0x5C, 0x01, 0x5D, 0x01, 0x5E,0x01, 0x5F,
-            0x01, 0x60, 0x01, 0x61, 0x01, 0x62, 0x01, 0x63,0x01, 0x64,
-            0x01, 0x65, 0x01, 0x66, 0x01, 0x67, 0x01, 0x68,0x01, 0x69,
-            0x01, 0x6A, 0x01, 0x6B, 0x01, 0x6C, 0x01, 0x6D,0x01, 0x6E,
-            0x01, 0x6F, 0x01, 0x70, 0x01, 0x71, 0x01, 0x72,0x01, 0x73,
-            0x01, 0x74, 0x01, 0x75, 0x01, 0x76, 0x01, 0x77,0x01, 0x78,
-            0x01, 0x79, 0x01, 0x7A, 0x01, 0x7B, 0x01, 0x7C,0x01, 0x7D,
-            0x01, 0x7E, 0x01, 0x7F, 0x01, 0x80, 0x01, 0x81,0x01, 0x82,
-            0x01, 0x83, 0x01, 0x84, 0x01, 0x85, 0x01, 0x86,0x01, 0x87,
-            0x01, 0x88, 0x01, 0x89, 0x01, 0x8A, 0x01, 0x8B,0x01, 0x8C,
-            0x01, 0x8D, 0x01, 0x8E, 0x01, 0x8F, 0x01, 0x90,0x01, 0x91,
-            0x01, 0x92, 0x01, 0x93, 0x01, 0x94, 0x01, 0x95,0x01, 0x96,
-            0x01, 0x97, 0x01, 0x98, 0x01, 0x99, 0x01, 0x9A,0x01, 0x9B,
-            0x01, 0x9C, 0x01, 0x9D, 0x01, 0x9E, 0x01, 0x9F,0x01, 0xA0,
-            0x01, 0xA1, 0x01, 0xA2, 0x01, 0xA3, 0x01, 0xA4,0x01, 0xA5,
-            0x01, 0xA6, 0x01, 0xA7, 0x01, 0xA8, 0x01, 0xA9,0x01, 0xAA,
-            0x01, 0xAB, 0x01, 0xAC, 0x01, 0xAD, 0x01, 0xAE,0x01, 0xAF,
-            0x01, 0xB0, 0x01, 0xB1, 0x01, 0xB2, 0x01, 0xB3,0x01, 0xB4,
-            0x01, 0xB5, 0x01, 0xB6, 0x01, 0xB7, 0x01, 0xB8,0x01, 0xB9,
-            0x01, 0xBA, 0x01, 0xBB, 0x01, 0xBC, 0x01, 0xBD,0x01, 0xBE,
-            0x01, 0xBF, 0x01, 0xC0, 0x01, 0xC1, 0x01, 0xC2,0x01, 0xC3,
-            0x01, 0xC4, 0x01, 0xC5, 0x01, 0xC6, 0x01, 0xC7,0x01, 0xC8,
-            0x01, 0xC9, 0x01, 0xCA, 0x01, 0xCB, 0x01, 0xCC,0x01, 0xCD,
-            0x01, 0xCE, 0x01, 0xCF, 0x01, 0xD0, 0x01, 0xD1,0x01, 0xD2,
-            0x01, 0xD3, 0x01, 0xD4, 0x01, 0xD5, 0x01, 0xD6,0x01, 0xD7,
-            0x01, 0xD8, 0x01, 0xD9, 0x01, 0xDA, 0x01, 0xDB,0x01, 0xDC,
-            0x01, 0xDD, 0x01, 0xDE, 0x01, 0xDF, 0x01, 0xE0,0x01, 0xE1,
-            0x01, 0xE2, 0x01, 0xE3, 0x01, 0xE4, 0x01, 0xE5,0x01, 0xE6,
-            0x01, 0xE7, 0x01, 0xE8, 0x01, 0xE9, 0x01, 0xEA,0x01, 0xEB,
-            0x01, 0xEC, 0x01, 0xED, 0x01, 0xEE, 0x01, 0xEF,0x01, 0xF0,
-            0x01, 0xF1, 0x01, 0xF2, 0x01, 0xF3, 0x01, 0xF4,0x01, 0xF5,
-            0x01, 0xF6, 0x01, 0xF7, 0x01, 0xF8, 0x01, 0xF9,0x01, 0xFA,
-            0x01, 0xFB, 0x01, 0xFC, 0x01, 0xFD, 0x01, 0xFE,  0x01, 0xFF,
-
-            // 1+255+510 bytes are done, this is the remaining 258B for total of 1024
-            0x02, 0x01, 0x02, 0x02, 0x02, 0x03, 0x02, 0x04, 0x02, 0x05,
-            0x02, 0x06, 0x02, 0x07, 0x02, 0x08, 0x02, 0x09, 0x02, 0x0A,
-            0x02, 0x0B, 0x02, 0x0C, 0x02, 0x0D, 0x02, 0x0E, 0x02, 0x0F,
-            0x02, 0x10, 0x02, 0x11, 0x02, 0x12, 0x02, 0x13, 0x02, 0x14,
-            0x02, 0x15, 0x02, 0x16, 0x02, 0x17, 0x02, 0x18, 0x02, 0x19,
-            0x02, 0x1A, 0x02, 0x1B, 0x02, 0x1C, 0x02, 0x1D, 0x02, 0x1E,
-            0x02, 0x1F, 0x02, 0x20, 0x02, 0x21, 0x02, 0x22, 0x02, 0x23,
-            0x02, 0x24, 0x02, 0x25, 0x02, 0x26, 0x02, 0x27, 0x02, 0x28,
-            0x02, 0x29, 0x02, 0x2A, 0x02, 0x2B, 0x02, 0x2C, 0x02, 0x2D,
-            0x02, 0x2E, 0x02, 0x2F, 0x02, 0x30, 0x02, 0x31, 0x02, 0x32,
-            0x02, 0x33, 0x02, 0x34, 0x02, 0x35, 0x02, 0x36, 0x02, 0x37,
-            0x02, 0x38, 0x02, 0x39, 0x02, 0x3A, 0x02, 0x3B, 0x02, 0x3C,
-            0x02, 0x3D, 0x02, 0x3E, 0x02, 0x3F, 0x02, 0x40, 0x02, 0x41,
-            0x02, 0x42, 0x02, 0x43, 0x02, 0x44, 0x02, 0x45, 0x02, 0x46,
-            0x02, 0x47, 0x02, 0x48, 0x02, 0x49, 0x02, 0x4A, 0x02, 0x4B,
-            0x02, 0x4C, 0x02, 0x4D, 0x02, 0x4E, 0x02, 0x4F, 0x02, 0x50,
-            0x02, 0x51, 0x02, 0x52, 0x02, 0x53, 0x02, 0x54, 0x02, 0x55,
-            0x02, 0x56, 0x02, 0x57, 0x02, 0x58, 0x02, 0x59, 0x02, 0x5A,
-            0x02, 0x5B, 0x02, 0x5C, 0x02, 0x5D, 0x02, 0x5E, 0x02, 0x5F,
-            0x02, 0x60, 0x02, 0x61, 0x02, 0x62, 0x02, 0x63, 0x02, 0x64,
-            0x02, 0x65, 0x02, 0x66, 0x02, 0x67, 0x02, 0x68, 0x02, 0x69,
-            0x02, 0x6A, 0x02, 0x6B, 0x02, 0x6C, 0x02, 0x6D, 0x02, 0x6E,
-            0x02, 0x6F, 0x02, 0x70, 0x02, 0x71, 0x02, 0x72, 0x02, 0x73,
-            0x02, 0x74, 0x02, 0x75, 0x02, 0x76, 0x02, 0x77, 0x02, 0x78,
-            0x02, 0x79, 0x02, 0x7A, 0x02, 0x7B, 0x02, 0x7C, 0x02, 0x7D,
-            0x02, 0x7E, 0x02, 0x7F, 0x02, 0x80, 0x02, 0x81
-    };
+frame_validator_t rx_validator;
+
+#if defined(BENCH_STREAM_MS)
+// Each trigger streams frames for BENCH_STREAM_MS, see STREAM_DURATION_MS.
+// rx_throughput holds the receiver's goodput for reading out over JTAG.
+throughput_stream_t tx_stream;
+throughput_meter_t rx_throughput;
+#endif
+
+#if defined(BENCH_RTT_PING)
+// Round trip mode, see RTT_MODE. Pings go out every BENCH_RTT_INTERVAL_MS
+// and the other board echoes them. The histogram is printed every
+// BENCH_RTT_REPORT_EVERY samples for rtt-import.
+rtt_histogram_t rtt_histogram;
+uint32_t rtt_ping_cycles = 0;
+uint32_t rtt_sent_cycles = 0;
+bool rtt_outstanding = false;
 #endif
 
 /* -------------------------------------------------------------------------- */
@@ -254,8 +131,6 @@ static void setup_gpio_output( void );
 static void setup_gpio_input( void );
 static void IRAM_ATTR gpio_isr_handler(void* arg);
 
-static void crc16(uint8_t data, uint16_t *crc);
-
 static void wifi_init(void);
 static esp_err_t espnow_init(void);
 static void example_espnow_deinit(example_espnow_send_param_t *send_param);
@@ -264,6 +139,8 @@ static void example_espnow_send_cb(const uint8_t *mac_addr, esp_now_send_status_
 static void example_espnow_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len);
 static void broadcast_for_peers( example_espnow_send_param_t *send_param );
 static void example_espnow_task(void *pvParameter);
+static void report_throughput( void );
+static void print_line( const char *line );
 
 /* -------------------------------------------------------------------------- */
 
@@ -306,17 +183,6 @@ static void IRAM_ATTR gpio_isr_handler(void* arg)
 
 /* -------------------------------------------------------------------------- */
 
-static void crc16(uint8_t data, uint16_t *crc)
-{
-    *crc  = (uint8_t)(*crc >> 8) | (*crc << 8);
-    *crc ^= data;
-    *crc ^= (uint8_t)(*crc & 0xff) >> 4;
-    *crc ^= (*crc << 8) << 4;
-    *crc ^= ((*crc & 0xff) << 4) << 1;
-}
-
-/* -------------------------------------------------------------------------- */
-
 static void wifi_init(void)
 {
     ESP_ERROR_CHECK( esp_netif_init() );
@@ -393,7 +259,8 @@ static esp_err_t espnow_init(void)
         return ESP_FAIL;
     }
 
-    xTaskCreate(example_espnow_task, "example_espnow_task", 2048, send_param, 4, NULL);
+    // Pinned for the round trip timing, with room to print the histogram
+    xTaskCreatePinnedToCore(example_espnow_task, "example_espnow_task", 4096, send_param, 4, NULL, 0);
 
     return ESP_OK;
 }
@@ -500,13 +367,38 @@ static void example_espnow_task(void *pvParameter)
     example_espnow_send_param_t *send_param = (example_espnow_send_param_t *)pvParameter;
     example_espnow_event_t evt;
     uint16_t bytes_sent = 0;
+    uint16_t payload_length = 0;
 
     // Spend some time broadcasting so the other ESP32 can add us to it's peer list
     broadcast_for_peers( send_param );
 
+#if defined(BENCH_RTT_PING)
+    // The cycle counter is per core, this task is pinned so both ends of a
+    // round trip are read from the same one
+    const uint32_t rtt_interval_cycles = BENCH_RTT_INTERVAL_MS * 1000u * esp_rom_get_cpu_ticks_per_us();
+    rtt_ping_cycles = esp_cpu_get_cycle_count();
+#endif
+
     // Main event loop
     while(1)
     {
+#if defined(BENCH_RTT_PING)
+        // Ping on a timer rather than the trigger input. An echo that hasn't
+        // come back by the next ping is counted as lost.
+        if( esp_cpu_get_cycle_count() - rtt_ping_cycles >= rtt_interval_cycles )
+        {
+            rtt_ping_cycles = esp_cpu_get_cycle_count();
+
+            if( rtt_outstanding )
+            {
+                rtt_histogram_record_lost( &rtt_histogram );
+                rtt_outstanding = false;
+            }
+
+            trigger_pending = true;
+        }
+#endif
+
         if(trigger_pending)
         {
             // Get the candidate device we want to send to
@@ -526,9 +418,14 @@ static void example_espnow_task(void *pvParameter)
                 // Send an unicast ESPNOW packet to the peer we met during startup
                 memcpy(send_param->dest_mac, peer->peer_addr, ESP_NOW_ETH_ALEN);
 
+#if defined(BENCH_STREAM_MS)
+                throughput_stream_start( &tx_stream, (uint32_t)esp_timer_get_time() );
+#endif
+
                 // Chunk large payloads into 250 byte packets
                 bytes_sent = 0;
-                uint16_t bytes_to_send = sizeof(test_payload) - bytes_sent;
+                payload_length = payload_schedule_next();
+                uint16_t bytes_to_send = payload_length - bytes_sent;
                 if( bytes_to_send > MAX_ESPNOW_PAYLOAD_BYTES )
                 {
                     bytes_to_send = MAX_ESPNOW_PAYLOAD_BYTES;
@@ -539,6 +436,11 @@ static void example_espnow_task(void *pvParameter)
                 send_param->len = bytes_to_send;
                 memcpy( send_param->buffer, &test_payload[bytes_sent], bytes_to_send );
 
+#if defined(BENCH_RTT_PING)
+                rtt_sent_cycles = esp_cpu_get_cycle_count();
+                rtt_outstanding = true;
+#endif
+
                 if( esp_now_send(send_param->dest_mac, send_param->buffer, send_param->len) != ESP_OK )
                 {
                     ESP_LOGE(TAG, "Send error");
@@ -572,10 +474,26 @@ static void example_espnow_task(void *pvParameter)
                         break;
                     }
 
+#if defined(BENCH_STREAM_MS)
+                    // Streaming, the next frame follows as soon as one is out
+                    if( bytes_sent >= payload_length && tx_stream.active )
+                    {
+                        if( throughput_stream_next( &tx_stream, payload_length, (uint32_t)esp_timer_get_time() ) )
+                        {
+                            bytes_sent = 0;
+                            payload_length = payload_schedule_next();
+                        }
+                        else
+                        {
+                            ESP_LOGI(TAG, "Stream sent %"PRIu32" frames, %"PRIu32"B", tx_stream.frames, tx_stream.bytes);
+                        }
+                    }
+#endif
+
                     // Send the next chunk if needed
-                    if( bytes_sent < sizeof(test_payload) )
+                    if( bytes_sent < payload_length )
                     {
-                        uint16_t bytes_to_send = sizeof(test_payload) - bytes_sent;
+                        uint16_t bytes_to_send = payload_length - bytes_sent;
                         if( bytes_to_send > MAX_ESPNOW_PAYLOAD_BYTES )
                         {
                             bytes_to_send = MAX_ESPNOW_PAYLOAD_BYTES;
@@ -636,27 +554,49 @@ static void example_espnow_task(void *pvParameter)
                     {
                         // ESP_LOGI(TAG, "Receive unicast data from: "MACSTR", len: %d", MAC2STR(recv_cb->src_addr), recv_cb->data_len);
 
-                        for( uint8_t i = 0; i < recv_cb->data_len; i++ )
+#if defined(BENCH_RTT_ECHO)
+                        const uint32_t rx_bytes = rx_validator.bytes;
+#endif
+
+                        if( frame_validator_feed( &rx_validator, recv_cb->data, recv_cb->data_len ) )
                         {
-                            // ESP_LOGI(TAG, "%d: %d", i, recv_cb->data[i]);
+                            // Valid test structure
+                            gpio_set_level( GPIO_OUTPUT_IO_0, 1 );
+
+#if defined(BENCH_RTT_PING)
+                            if( rtt_outstanding )
+                            {
+                                rtt_histogram_record( &rtt_histogram, esp_cpu_get_cycle_count() - rtt_sent_cycles );
+                                rtt_outstanding = false;
 
-                            // Reset the "parser" if the start of a new test structure is seen
-                            if(recv_cb->data[i] == 0x00 )
+                                if( rtt_histogram.samples % BENCH_RTT_REPORT_EVERY == 0 )
+                                {
+                                    rtt_histogram_print( &rtt_histogram, print_line );
+                                }
+                            }
+#elif defined(BENCH_RTT_ECHO)
+                            // Straight back to the pinging board, later
+                            // chunks follow from the send callback as usual
+                            memcpy(send_param->dest_mac, recv_cb->src_addr, ESP_NOW_ETH_ALEN);
+
+                            bytes_sent = 0;
+                            payload_length = payload_schedule_echo( rx_validator.bytes - rx_bytes );
+                            uint16_t bytes_to_send = payload_length;
+                            if( bytes_to_send > MAX_ESPNOW_PAYLOAD_BYTES )
                             {
-                                bytes_read = 0;
-                                working_crc = CRC_SEED;
+                                bytes_to_send = MAX_ESPNOW_PAYLOAD_BYTES;
                             }
 
-                            // Running crc and byte count
-                            crc16( recv_cb->data[i], &working_crc );
-                            bytes_read++;
+                            send_param->len = bytes_to_send;
+                            memcpy( send_param->buffer, test_payload, bytes_to_send );
 
-                            // Identify the end of the packet via expected length and correct CRC
-                            if( bytes_read == sizeof(test_payload) && working_crc == payload_crc )
+                            if( esp_now_send(send_param->dest_mac, send_param->buffer, send_param->len) != ESP_OK )
                             {
-                                // Valid test structure
-                                gpio_set_level( GPIO_OUTPUT_IO_0, 1 );
+                                ESP_LOGE(TAG, "Echo error");
                             }
+
+                            bytes_sent += bytes_to_send;
+#endif
                         }
 
                         gpio_set_level( GPIO_OUTPUT_IO_0, 0 );
@@ -675,11 +615,50 @@ static void example_espnow_task(void *pvParameter)
             }
         }   // end evtxQueueReceive
 
+#if defined(BENCH_STREAM_MS)
+        // Also while nothing arrives, so the last window of a burst closes
+        if( throughput_meter_update( &rx_throughput, &rx_validator, (uint32_t)esp_timer_get_time() ) )
+        {
+            report_throughput();
+        }
+#endif
+
     }   // end event loop
 }
 
 /* -------------------------------------------------------------------------- */
 
+static void report_throughput( void )
+{
+#if defined(BENCH_STREAM_MS)
+    const throughput_sample_t *window = &rx_throughput.window;
+    const throughput_sample_t *burst = &rx_throughput.burst;
+
+    ESP_LOGI(TAG, "Goodput %"PRIu32" frames/s, %"PRIu32" B/s",
+                    throughput_per_second( window->frames, window->elapsed_us ),
+                    throughput_per_second( window->bytes, window->elapsed_us ) );
+
+    if( !rx_throughput.active )
+    {
+        ESP_LOGI(TAG, "Burst %"PRIu32" frames, %"PRIu32"B in %"PRIu32"us: %"PRIu32" frames/s, %"PRIu32" B/s",
+                        burst->frames,
+                        burst->bytes,
+                        burst->elapsed_us,
+                        throughput_per_second( burst->frames, burst->elapsed_us ),
+                        throughput_per_second( burst->bytes, burst->elapsed_us ) );
+    }
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void print_line( const char *line )
+{
+    printf( "%s\n", line );
+}
+
+/* -------------------------------------------------------------------------- */
+
 void app_main(void)
 {
     // Initialize NVS
@@ -695,15 +674,17 @@ void app_main(void)
     setup_gpio_output();
     setup_gpio_input();
 
-    // Work out the correct CRC for the active payload
-    working_crc = CRC_SEED;
-    for( uint16_t i = 0; i < sizeof(test_payload); i++ )
-    {
-        crc16( test_payload[i], &working_crc );
-    }
+    // The payload and its CRC are generated at build time
+    payload_schedule_validator_init( &rx_validator );
+
+#if defined(BENCH_STREAM_MS)
+    throughput_stream_init( &tx_stream, BENCH_STREAM_MS * 1000u );
+    throughput_meter_init( &rx_throughput, THROUGHPUT_WINDOW_US );
+#endif
 
-    payload_crc = working_crc;
-    working_crc = CRC_SEED;
+#if defined(BENCH_RTT_PING)
+    rtt_histogram_init( &rtt_histogram, esp_rom_get_cpu_ticks_per_us() );
+#endif
 
     // Start wifi/espnow tasks
     wifi_init();
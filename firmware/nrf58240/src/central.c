@@ -61,6 +61,8 @@ static void ble_data_sent(struct bt_nus_client *nus, uint8_t err,
 {
 	ARG_UNUSED(nus);
 
+	BENCH_TRACE_EVENT( TRACE_EVENT_SEND_DONE, len );
+
 	// When sending we allocated a buffer.
 	// Free it here. This definitely could be cleaner.
 	free(data);       
@@ -87,6 +89,8 @@ static uint8_t ble_data_received(struct bt_nus_client *nus,
 {
 	ARG_UNUSED(nus);
 
+	BENCH_TRACE_EVENT( TRACE_EVENT_RECV, len );
+
 	// int err;
 	// printk("Rx %iB\n", len);
 
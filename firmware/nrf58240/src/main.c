@@ -13,6 +13,10 @@
 #include <zephyr/drivers/gpio.h>
 
 #include "benchmark_defs.h"
+#include "frame_validator.h"
+#include "payload_schedule.h"
+#include "test_payload.h"
+#include "throughput_meter.h"
 
 #if BLE_MODE == SERVER
     #include "central.h"
@@ -31,13 +35,28 @@ static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(LED2_NODE, gpios);
 
 /* -------------------------------------------------------------------------- */
 
-#define CRC_SEED (0xFFFFu)
-uint16_t bytes_read = 0;
 uint16_t bytes_sent = 0;
 uint16_t bytes_pending = 0;
 
-uint16_t working_crc = CRC_SEED;
-uint16_t payload_crc = 0x00;
+frame_validator_t rx_validator;
+
+#if defined(BENCH_STREAM_MS)
+// Each trigger streams frames for BENCH_STREAM_MS, see STREAM_DURATION_MS.
+// rx_throughput holds the receiver's goodput for reading out over SWD.
+throughput_stream_t tx_stream;
+throughput_meter_t rx_throughput;
+#endif
+
+#if defined(BENCH_TRACE)
+// Cycle stamped stage events for the per-stage breakdown, read over SWD or
+// printed every BENCH_TRACE_DUMP_EVERY frames, see TRACE_EVENTS
+trace_ring_t trace_ring;
+#endif
+
+#if defined(BENCH_TRACE_DUMP_EVERY)
+static uint32_t trace_printed = 0;
+static uint32_t trace_frames = 0;
+#endif
 
 /* -------------------------------------------------------------------------- */
 
@@ -61,12 +80,19 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 static struct gpio_callback gpio_cb;
 
+static uint32_t uptime_us( void );
+static void report_throughput( void );
+#if defined(BENCH_TRACE_DUMP_EVERY)
+static void print_line( const char *line );
+#endif
+
 volatile bool trigger_pending = false;
 
 // This is the callback function that will be called when an IRQ is detected 
 // for GPIO_PIN 25:
 static void gpio_callback(const struct device *dev, struct gpio_callback *cb,
                           uint32_t pins) {
+	BENCH_TRACE_EVENT( TRACE_EVENT_TRIGGER, 0 );
 	trigger_pending = true;
 
 }
@@ -99,21 +125,21 @@ static void configure_gpio(void)
 	gpio_add_callback(button.port, &gpio_cb);
 }
 
-static void crc16(uint8_t data, uint16_t *crc)
-{
-    *crc  = (uint8_t)(*crc >> 8) | (*crc << 8);
-    *crc ^= data;
-    *crc ^= (uint8_t)(*crc & 0xff) >> 4;
-    *crc ^= (*crc << 8) << 4;
-    *crc ^= ((*crc & 0xff) << 4) << 1;
-}
-
 int main(void)
 {
     k_msgq_init(&bench_evt_queue, bench_evt_buffer, sizeof(bench_event_t), BENCHMARK_QUEUE_SIZE);
 
     printk("BLE Latency Benchmark\n");
 
+#if defined(BENCH_TRACE)
+    // Enable the DWT cycle counter for the trace timestamps
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    trace_ring_init( &trace_ring, SystemCoreClock / 1000000u );
+#endif
+
 	configure_gpio();
 
 #if BLE_MODE == SERVER
@@ -124,19 +150,17 @@ int main(void)
     peripheral_register_user_evt_queue(&bench_evt_queue);
 #endif
 
-    // Work out the correct CRC for the active payload
-    working_crc = CRC_SEED;
-    for( uint16_t i = 0; i < sizeof(test_payload); i++ )
-    {
-        crc16( test_payload[i], &working_crc );
-    }
-
-    payload_crc = working_crc;
-    working_crc = CRC_SEED;
+    // The payload and its CRC are generated at build time
+    payload_schedule_validator_init( &rx_validator );
 
+#if defined(BENCH_STREAM_MS)
+    throughput_stream_init( &tx_stream, BENCH_STREAM_MS * 1000u );
+    throughput_meter_init( &rx_throughput, THROUGHPUT_WINDOW_US );
+#endif
 
     bench_event_t evt;
     uint16_t bytes_sent = 0;
+    uint16_t payload_length = 0;
     int msgq_res = 0;
 
     printk("Starting...\n");
@@ -145,10 +169,15 @@ int main(void)
 
  		if( trigger_pending )
         {
+#if defined(BENCH_STREAM_MS)
+            throughput_stream_start( &tx_stream, uptime_us() );
+#endif
+
             // Chunk large payloads into smaller packets
             bytes_sent = 0;
+            payload_length = payload_schedule_next();
 
-            uint16_t bytes_to_send = sizeof(test_payload) - bytes_sent;
+            uint16_t bytes_to_send = payload_length - bytes_sent;
             if( bytes_to_send > BENCH_DATA_MAX_LEN )
             {
                 bytes_to_send = BENCH_DATA_MAX_LEN;
@@ -156,6 +185,8 @@ int main(void)
             
             // printk( "Trig. Sending %iB\n", bytes_to_send );
 
+            BENCH_TRACE_EVENT( TRACE_EVENT_SEND, bytes_to_send );
+
 #if BLE_MODE == SERVER
             central_send_payload( &test_payload[bytes_sent], bytes_to_send );
 #else
@@ -184,10 +215,26 @@ int main(void)
                     bytes_sent += bytes_pending;
                     bytes_pending = 0;
 
+#if defined(BENCH_STREAM_MS)
+                    // Streaming, the next frame follows as soon as one is out
+                    if( bytes_sent >= payload_length && tx_stream.active )
+                    {
+                        if( throughput_stream_next( &tx_stream, payload_length, uptime_us() ) )
+                        {
+                            bytes_sent = 0;
+                            payload_length = payload_schedule_next();
+                        }
+                        else
+                        {
+                            LOG_INF( "Stream sent %u frames, %uB", tx_stream.frames, tx_stream.bytes );
+                        }
+                    }
+#endif
+
                     // Send the next chunk if needed
-                    if( bytes_sent < sizeof(test_payload) )
+                    if( bytes_sent < payload_length )
                     {
-                        uint16_t bytes_to_send = sizeof(test_payload) - bytes_sent;
+                        uint16_t bytes_to_send = payload_length - bytes_sent;
                         if( bytes_to_send > BENCH_DATA_MAX_LEN )
                         {
                             bytes_to_send = BENCH_DATA_MAX_LEN;
@@ -195,6 +242,8 @@ int main(void)
 
                         // printk( "Cont. Sending %iB\n", bytes_to_send );
 
+                        BENCH_TRACE_EVENT( TRACE_EVENT_SEND, bytes_to_send );
+
 #if BLE_MODE == SERVER
                         central_send_payload( &test_payload[bytes_sent], bytes_to_send );
 #else
@@ -208,6 +257,10 @@ int main(void)
                         bytes_sent = 0;
                         bytes_pending = 0;
                         // printk( "FIN \n");
+
+#if defined(BENCH_TRACE_DUMP_EVERY)
+                        trace_frames++;
+#endif
                     }
   
                     break;
@@ -220,26 +273,15 @@ int main(void)
 
                     // printk( "Got %iB\n", recv_cb->data_len);
 
-                    for( uint16_t i = 0; i < recv_cb->data_len; i++ )
+                    if( frame_validator_feed( &rx_validator, recv_cb->data, recv_cb->data_len ) )
                     {
-                        // Reset the "parser" if the start of a new test structure is seen
-                        if(recv_cb->data[i] == 0x00 )
-                        {
-                            bytes_read = 0;
-                            working_crc = CRC_SEED;
-                            // printk( "RESET\n");
-                        }
+                        // Valid test structure
+                        gpio_pin_set_dt(&led, true);
+                        BENCH_TRACE_EVENT( TRACE_EVENT_VALID, rx_validator.expected_length );
 
-                        // Running crc and byte count
-                        crc16( recv_cb->data[i], &working_crc );
-                        bytes_read++;
-
-                        // Identify the end of the packet via expected length and correct CRC
-                        if( bytes_read == sizeof(test_payload) && working_crc == payload_crc )
-                        {
-                            // Valid test structure
-                            gpio_pin_set_dt(&led, true);
-                        }
+#if defined(BENCH_TRACE_DUMP_EVERY)
+                        trace_frames++;
+#endif
                     }
 
                     gpio_pin_set_dt(&led, false);
@@ -257,5 +299,62 @@ int main(void)
             }
             
 		}
+
+#if defined(BENCH_STREAM_MS)
+        // Also while nothing arrives, so the last window of a burst closes
+        if( throughput_meter_update( &rx_throughput, &rx_validator, uptime_us() ) )
+        {
+            report_throughput();
+        }
+#endif
+
+#if defined(BENCH_TRACE_DUMP_EVERY)
+        // Only between frames, each record takes a few ms on the console
+        if( trace_frames >= BENCH_TRACE_DUMP_EVERY && !bytes_pending )
+        {
+            trace_printed = trace_ring_print( &trace_ring, trace_printed, print_line );
+            trace_frames = 0;
+        }
+#endif
 	}
 }
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t uptime_us( void )
+{
+    return (uint32_t)k_ticks_to_us_floor64( k_uptime_ticks() );
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void report_throughput( void )
+{
+#if defined(BENCH_STREAM_MS)
+    const throughput_sample_t *window = &rx_throughput.window;
+    const throughput_sample_t *burst = &rx_throughput.burst;
+
+    LOG_INF( "Goodput %u frames/s, %u B/s",
+             throughput_per_second( window->frames, window->elapsed_us ),
+             throughput_per_second( window->bytes, window->elapsed_us ) );
+
+    if( !rx_throughput.active )
+    {
+        LOG_INF( "Burst %u frames, %uB in %uus: %u frames/s, %u B/s",
+                 burst->frames,
+                 burst->bytes,
+                 burst->elapsed_us,
+                 throughput_per_second( burst->frames, burst->elapsed_us ),
+                 throughput_per_second( burst->bytes, burst->elapsed_us ) );
+    }
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(BENCH_TRACE_DUMP_EVERY)
+static void print_line( const char *line )
+{
+    printk( "%s\n", line );
+}
+#endif
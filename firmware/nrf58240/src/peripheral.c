@@ -107,6 +107,8 @@ BT_CONN_CB_DEFINE(conn_callbacks) = {
 
 static void ble_send_cb( struct bt_conn *conn )
 {
+	BENCH_TRACE_EVENT( TRACE_EVENT_SEND_DONE, 0 );
+
 	// printk("TxDone?\n");
 
 	if( user_periph_evt_queue )
@@ -122,6 +124,8 @@ static void ble_send_cb( struct bt_conn *conn )
 static void ble_receive_cb(struct bt_conn *conn, const uint8_t *const data,
 			  uint16_t len)
 {
+	BENCH_TRACE_EVENT( TRACE_EVENT_RECV, len );
+
 	char addr[BT_ADDR_LE_STR_LEN] = {0};
 	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, ARRAY_SIZE(addr));
 	// printk("Received %i data from: %s\n", len, addr);
@@ -1,63 +1,62 @@
 /* ----- System Includes ---------------------------------------------------- */
 
+#include <string.h>
+
 /* ----- Local Includes ----------------------------------------------------- */
 
 #include "fifo.h"
 
 /* ----- Private Prototypes ------------------------------------------------- */
 
-static uint32_t fifo_next(fifo_t *restrict f, uint32_t index);
+static uint32_t fifo_load(const uint32_t *index);
+static void fifo_store(uint32_t *index, uint32_t value);
+static void fifo_spans(fifo_t *restrict f, uint32_t start, uint32_t count, fifo_span_t spans[2]);
+static void fifo_reverse(uint8_t *buf, uint32_t length);
 
 /* ----- Public Functions --------------------------------------------------- */
 
 /** This initializes the FIFO structure with the given buffer and size */
 void fifo_init(fifo_t *restrict f, uint8_t *buf, uint32_t buf_size) {
+    // Round down to a power of two, so the indices can be masked
+    uint32_t capacity = 1;
+    while (buf_size && capacity <= buf_size / 2) {
+        capacity *= 2;
+    }
+
     f->head = 0;
     f->tail = 0;
-    f->capacity = buf_size;
+    f->capacity = buf_size ? capacity : 0;
+    f->mask = f->capacity - 1;
     f->buf = buf;
 }
 
 /* -------------------------------------------------------------------------- */
 
-/** Returns the amount of data in use in the fifo.
-  * This can be at max the capacity less 1
-  */
+/** Returns the capacity of the fifo, all of which can be used */
 uint32_t fifo_size(fifo_t *restrict f) {
-    return f->capacity - 1;
+    return f->capacity;
 }
 
 /* -------------------------------------------------------------------------- */
 
 /** Returns the amount of data in use in the fifo.
-  * This can be at max the capacity less 1
+  * Unsigned subtraction of the free running indices survives them wrapping
   */
 uint32_t fifo_used(fifo_t *restrict f) {
-    if (f->head != f->tail) {
-        if (f->head > f->tail) {
-            return f->head - f->tail;
-        } else {
-            return f->head - f->tail + f->capacity;
-        }
-    }
-    return 0;
+    return fifo_load(&f->head) - fifo_load(&f->tail);
 }
 
 /* -------------------------------------------------------------------------- */
 
 /** Returns the amount of data in a sequential run in the fifo
   * i.e doesn't count bytes which cross over the overflow boundary
-  * This can be at max the capacity less 1
   */
 uint32_t fifo_used_linear(fifo_t *restrict f) {
-    if (f->head != f->tail) {
-        if (f->head > f->tail) {
-            return f->head - f->tail;
-        } else {
-            return f->capacity - f->tail;   // from tail to end of buffer
-        }
-    }
-    return 0;
+    const uint32_t tail = fifo_load(&f->tail);
+    const uint32_t used = fifo_load(&f->head) - tail;
+    const uint32_t to_end = f->capacity - (tail & f->mask);   // from tail to end of buffer
+
+    return (used < to_end) ? used : to_end;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -71,10 +70,10 @@ uint32_t fifo_free(fifo_t *restrict f) {
 
 /** Write a byte to the FIFO. Return true when OK */
 bool fifo_put(fifo_t *restrict f, const uint8_t ch) {
-    const uint32_t new_head = fifo_next(f, f->head);
-    if (new_head != f->tail) {
-        f->buf[f->head] = ch;
-        f->head = new_head;
+    const uint32_t head = f->head;
+    if (head - fifo_load(&f->tail) != f->capacity) {
+        f->buf[head & f->mask] = ch;
+        fifo_store(&f->head, head + 1);
         return true;    /* successfully added to queue */
     }
     return false; //no more room
@@ -85,9 +84,10 @@ bool fifo_put(fifo_t *restrict f, const uint8_t ch) {
 /** Get a byte from the FIFO. Return NULL when empty */
 uint8_t *
 fifo_get(fifo_t *restrict f) {
-    if (f->tail != f->head) {
-        uint8_t *ch = &f->buf[f->tail];
-        f->tail = fifo_next(f, f->tail);
+    const uint32_t tail = f->tail;
+    if (tail != fifo_load(&f->head)) {
+        uint8_t *ch = &f->buf[tail & f->mask];
+        fifo_store(&f->tail, tail + 1);
         return ch;
     }
     return 0;
@@ -98,8 +98,9 @@ fifo_get(fifo_t *restrict f) {
 /** Peek a byte from the FIFO. Return NULL when empty */
 uint8_t *
 fifo_peek(fifo_t *restrict f) {
-    if (f->tail != f->head) {
-        uint8_t *ch = &f->buf[f->tail];
+    const uint32_t tail = f->tail;
+    if (tail != fifo_load(&f->head)) {
+        uint8_t *ch = &f->buf[tail & f->mask];
         return ch;
     }
     return 0;
@@ -112,14 +113,23 @@ fifo_peek(fifo_t *restrict f) {
  *  The number of bytes written is returned
  */
 uint32_t fifo_write(fifo_t *restrict f, const uint8_t *buf, uint32_t nbytes) {
-    uint32_t count = 0;
-    for (uint32_t i = 0; i < nbytes; i++) {
-        if (fifo_put(f, buf[i])) {
-            count++;
-        } else {
-            break;
-        }
+    const uint32_t head = f->head;
+    uint32_t count = f->capacity - (head - fifo_load(&f->tail));
+    if (nbytes < count) {
+        count = nbytes;
+    }
+
+    // At most two copies, up to the end of the buffer then from the start
+    const uint32_t to_end = f->capacity - (head & f->mask);
+    const uint32_t first = (count < to_end) ? count : to_end;
+    memcpy(&f->buf[head & f->mask], buf, first);
+    if (count > first) {
+        memcpy(&f->buf[0], &buf[first], count - first);
     }
+
+    // Only publish the new head once the data is in place
+    fifo_store(&f->head, head + count);
+
     return count;
 }
 
@@ -127,67 +137,146 @@ uint32_t fifo_write(fifo_t *restrict f, const uint8_t *buf, uint32_t nbytes) {
 
 /** Reads nbytes bytes from the FIFO. The number of bytes read is returned */
 uint32_t fifo_read(fifo_t *restrict f, uint8_t *buf, uint32_t nbytes) {
-    uint32_t count = 0;
-    for (uint32_t i = 0; i < nbytes; i++) {
-        uint8_t *p = fifo_get(f);
-        if (p) {
-            buf[i] = *p;
-            count++;
-        } else {
-            break;
-        }
+    const uint32_t tail = f->tail;
+    uint32_t count = fifo_load(&f->head) - tail;
+    if (nbytes < count) {
+        count = nbytes;
+    }
+
+    const uint32_t to_end = f->capacity - (tail & f->mask);
+    const uint32_t first = (count < to_end) ? count : to_end;
+    memcpy(buf, &f->buf[tail & f->mask], first);
+    if (count > first) {
+        memcpy(&buf[first], &f->buf[0], count - first);
     }
+
+    // The producer may reuse the space once the tail moves
+    fifo_store(&f->tail, tail + count);
+
+    return count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/** Points spans at the free space, returns the total */
+uint32_t fifo_reserve_write(fifo_t *restrict f, fifo_span_t spans[2])
+{
+    const uint32_t head = f->head;
+    const uint32_t count = f->capacity - (head - fifo_load(&f->tail));
+
+    fifo_spans(f, head, count, spans);
+
     return count;
 }
 
 /* -------------------------------------------------------------------------- */
 
-/** Returns a pointer to the tail position. If the nbytes length is illegal, returns null */
-uint32_t * fifo_get_tail_ptr(fifo_t *restrict f, uint32_t nbytes)
+/** Publishes nbytes written into the reserved spans */
+bool fifo_commit_write(fifo_t *restrict f, uint32_t nbytes)
 {
-    uint32_t *ptr = 0;
+    const uint32_t head = f->head;
 
-    if (nbytes <= fifo_used_linear(f))
+    if (nbytes <= f->capacity - (head - fifo_load(&f->tail)))
     {
-        ptr = &f->buf[f->tail];
+        fifo_store(&f->head, head + nbytes);
+
+        return true;
     }
 
-    return ptr;
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/** Points spans at the data held, returns the total */
+uint32_t fifo_peek_spans(fifo_t *restrict f, fifo_span_t spans[2])
+{
+    const uint32_t tail = f->tail;
+    const uint32_t count = fifo_load(&f->head) - tail;
+
+    fifo_spans(f, tail, count, spans);
+
+    return count;
 }
 
 /* -------------------------------------------------------------------------- */
 
 /** Moves/flushes the tail forward by nbytes */
-uint32_t fifo_skip(fifo_t *restrict f, uint32_t nbytes)
+bool fifo_consume(fifo_t *restrict f, uint32_t nbytes)
 {
-    if (nbytes <= fifo_used_linear(f))
-    {
-        f->tail += nbytes;
+    const uint32_t tail = f->tail;
 
-        if (f->tail >= f->capacity)
-        {
-            f->tail = 0;
-        }
+    if (nbytes <= fifo_load(&f->head) - tail)
+    {
+        fifo_store(&f->tail, tail + nbytes);
 
-        return nbytes;
+        return true;
     }
 
-    return 0;
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/** Rotates the held bytes so the head lands on the start of the buffer */
+void fifo_rebase(fifo_t *restrict f)
+{
+    const uint32_t used = f->head - f->tail;
+    const uint32_t shift = f->head & f->mask;
+
+    // Rotate the buffer left by shift with three reversals, no scratch space
+    fifo_reverse(f->buf, shift);
+    fifo_reverse(&f->buf[shift], f->capacity - shift);
+    fifo_reverse(f->buf, f->capacity);
+
+    f->head = 0;
+    f->tail = 0 - used;
 }
 
 /* ----- Private Functions -------------------------------------------------- */
 
-static uint32_t fifo_next(fifo_t *restrict f, uint32_t index)
+// The other side's index. Acquire, so its data (or its finished reads) are
+// visible before we act on the index. On the Cortex-M4 this is a load and DMB.
+static uint32_t fifo_load(const uint32_t *index)
 {
-    uint32_t current = index;
-    current++;
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
 
-    if (current >= f->capacity)
+/* -------------------------------------------------------------------------- */
+
+// Our own index. Release, so the data written (or read) before it is done
+// before the other side, or a DMA stream started from it, sees the new index.
+// On the Cortex-M4 this is a DMB and a store.
+static void fifo_store(uint32_t *index, uint32_t value)
+{
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Splits count bytes from the free running index start at the end of the buffer
+static void fifo_spans(fifo_t *restrict f, uint32_t start, uint32_t count, fifo_span_t spans[2])
+{
+    const uint32_t offset = start & f->mask;
+    const uint32_t to_end = f->capacity - offset;
+
+    spans[0].data = &f->buf[offset];
+    spans[0].length = (count < to_end) ? count : to_end;
+    spans[1].data = &f->buf[0];
+    spans[1].length = count - spans[0].length;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void fifo_reverse(uint8_t *buf, uint32_t length)
+{
+    for (uint32_t i = 0; i < length / 2; i++)
     {
-        current = 0;
-    }
+        const uint8_t swap = buf[i];
 
-    return current;
+        buf[i] = buf[length - 1 - i];
+        buf[length - 1 - i] = swap;
+    }
 }
 
-/* ----- End ---------------------------------------------------------------- */
\ No newline at end of file
+/* ----- End ---------------------------------------------------------------- */
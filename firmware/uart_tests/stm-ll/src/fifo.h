@@ -14,17 +14,32 @@ extern "C" {
 
 /* ----- Types -------------------------------------------------------------- */
 
+// Single producer, single consumer ring. One context may write (put/write/
+// reserve/commit) and one other context may read (get/peek/read/consume) without masking
+// interrupts. head and tail run freely and are masked on access, so the whole
+// power of two capacity is usable.
 typedef struct
 {
     uint8_t * buf;
-    uint32_t  head;
-    uint32_t  tail;
+    uint32_t  head;         // bytes ever written, only the producer stores it
+    uint32_t  tail;         // bytes ever read, only the consumer stores it
     uint32_t  capacity;
+    uint32_t  mask;
 } fifo_t;
 
+// A run of bytes inside the fifo's buffer
+typedef struct
+{
+    uint8_t * data;
+    uint32_t  length;
+} fifo_span_t;
+
 /* ----- Public Functions --------------------------------------------------- */
 
-/** This initializes the FIFO structure with the given buffer and size */
+/** This initializes the FIFO structure with the given buffer and size
+ *  The size should be a power of two, otherwise only the largest power of two
+ *  that fits is used
+ */
 
 void fifo_init( fifo_t * restrict f, uint8_t * buf, uint32_t buf_size );
 
@@ -60,7 +75,10 @@ bool fifo_put( fifo_t * restrict f, const uint8_t ch );
 
 /* -------------------------------------------------------------------------- */
 
-/** Get a byte from the FIFO. Return NULL when empty */
+/** Get a byte from the FIFO. Return NULL when empty
+ *  The producer may overwrite the byte as soon as this returns, so read it
+ *  straight away or use fifo_read()
+ */
 
 uint8_t * fifo_get( fifo_t * restrict f );
 
@@ -87,19 +105,47 @@ uint32_t fifo_read( fifo_t * restrict f, uint8_t * buf, uint32_t nbytes );
 
 /* -------------------------------------------------------------------------- */
 
-/** Get the pointer to the tail, if the proposed nbytes is legal
- *  Only use this function while promising that underlying data isn't mutated
+/** Points spans at the free space in place, from the head to the end of the
+ *  buffer then on from the start, so a DMA stream or driver can fill it
+ *  without a copy. Returns the total free, the second span is empty unless
+ *  the free space wraps. Only the producer may call this
+ */
+
+uint32_t fifo_reserve_write( fifo_t * restrict f, fifo_span_t spans[2] );
+
+/* -------------------------------------------------------------------------- */
+
+/** Adds nbytes written into the reserved spans to the fifo
+ *  Returns false and adds nothing if that is more than is free
+ */
+
+bool fifo_commit_write( fifo_t * restrict f, uint32_t nbytes );
+
+/* -------------------------------------------------------------------------- */
+
+/** Points spans at the data in the fifo in place, the oldest bytes first, so it
+ *  can be parsed or sent by DMA without a copy. Returns the total length, the
+ *  second span is empty unless the data wraps. Only the consumer may call this
+ */
+
+uint32_t fifo_peek_spans( fifo_t * restrict f, fifo_span_t spans[2] );
+
+/* -------------------------------------------------------------------------- */
+
+/** Drops nbytes returned by fifo_peek_spans() from the fifo
+ *  Returns false and drops nothing if that is more than is held
  */
 
-uint32_t * fifo_get_tail_ptr( fifo_t * restrict f, uint32_t nbytes );
+bool fifo_consume( fifo_t * restrict f, uint32_t nbytes );
 
 /* -------------------------------------------------------------------------- */
 
-/** Moves the tail forwards by nbytes, functionally skipping data (partial flush)
- *  Returns number bytes flushed
+/** Moves the held bytes so the head is at the start of the buffer, for a
+ *  circular DMA stream which always starts writing there. Only call it while
+ *  neither the producer nor the consumer can run
  */
 
-uint32_t fifo_skip( fifo_t * restrict f, uint32_t nbytes );
+void fifo_rebase( fifo_t * restrict f );
 
 /* ----- End ---------------------------------------------------------------- */
 
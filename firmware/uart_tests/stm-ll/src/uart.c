@@ -19,27 +19,78 @@
 
 #define HAL_UART_TX_FIFO_SIZE 2048
 #define HAL_UART_RX_FIFO_SIZE 2048
-#define HAL_UART_RX_DMA_BUFFER_SIZE 32
+
+// Longest single DMA TX transfer, set from CMake. The stream's count is 16 bits
+#ifndef HAL_UART_TX_DMA_MAX_BURST
+#define HAL_UART_TX_DMA_MAX_BURST HAL_UART_TX_FIFO_SIZE
+#endif
+
+// One engine for each uart_mode_t. start and stop enable or quiesce its
+// interrupts and streams, the rest are called from main as it uses the fifos
+typedef struct
+{
+    void (*start)( void );
+    void (*stop)( void );
+    void (*start_tx)( void );       // main has added to tx_fifo
+    void (*rx_service)( void );     // main is about to check rx_fifo
+} uart_driver_t;
 
 // User-space buffers are serviced outside IRQ
 fifo_t   tx_fifo = { 0 };
 uint8_t  tx_buffer[HAL_UART_TX_FIFO_SIZE];
-uint16_t tx_sneak_bytes;
+uint32_t tx_sneak_bytes;
 
 fifo_t  rx_fifo = { 0 };
 uint8_t rx_buffer[HAL_UART_RX_FIFO_SIZE];
 
-#ifdef UART_DMA
-// Raw DMA buffer,
-volatile uint8_t dma_rx_buffer[HAL_UART_RX_DMA_BUFFER_SIZE];
-uint32_t dma_rx_pos = 0;
-#endif
-
-static void hal_uart_start_tx( void );
-static void hal_usart_rx_handler( void );
-
-// This function is responsible for setting up the UART5 in any selected operating mode
-void uart_init( void )
+// The RX stream runs circularly over rx_fifo's own buffer, and what it has
+// written is committed from its count. Bytes it wrote over before they were
+// read are counted as overruns
+bool     dma_rx_running = false;
+uint32_t rx_overruns = 0;
+
+static void hal_uart_no_op( void );
+
+static void hal_uart_poll_start_tx( void );
+static void hal_uart_poll_rx( void );
+
+static void hal_uart_irq_start( void );
+static void hal_uart_irq_stop( void );
+static void hal_uart_irq_start_tx( void );
+
+static void hal_uart_dma_start( void );
+static void hal_uart_dma_stop( void );
+static void hal_uart_dma_start_tx( void );
+static void hal_uart_dma_tx_next( void );
+static void hal_uart_dma_rx( void );
+
+static const uart_driver_t uart_drivers[UART_MODE_COUNT] = {
+    [UART_MODE_POLL] = {
+        .start       = hal_uart_no_op,
+        .stop        = hal_uart_no_op,
+        .start_tx    = hal_uart_poll_start_tx,
+        .rx_service  = hal_uart_poll_rx,
+    },
+    [UART_MODE_IRQ] = {
+        .start       = hal_uart_irq_start,
+        .stop        = hal_uart_irq_stop,
+        .start_tx    = hal_uart_irq_start_tx,
+        .rx_service  = hal_uart_no_op,
+    },
+    [UART_MODE_DMA] = {
+        .start       = hal_uart_dma_start,
+        .stop        = hal_uart_dma_stop,
+        .start_tx    = hal_uart_dma_start_tx,
+        .rx_service  = hal_uart_no_op,
+    },
+};
+
+static uart_mode_t          uart_mode   = UART_MODE_POLL;
+static const uart_driver_t *uart_driver = &uart_drivers[UART_MODE_POLL];
+
+// This function is responsible for setting up the UART5 and both DMA streams,
+// then starts the engine for the selected operating mode
+void uart_init( uart_mode_t mode )
 {
     // Cleanup periperhal, Disable DMA streams
     LL_USART_DeInit( UART5 );
@@ -49,9 +100,6 @@ void uart_init( void )
     // Prepare buffers
     memset( tx_buffer, 0, sizeof(tx_buffer) );
     memset( rx_buffer, 0, sizeof(rx_fifo) );
-#ifdef UART_DMA
-    memset( (uint8_t*)dma_rx_buffer, 0, sizeof(dma_rx_buffer) );
-#endif
     fifo_init( &tx_fifo, &tx_buffer[0], HAL_UART_TX_FIFO_SIZE );
     fifo_init( &rx_fifo, &rx_buffer[0], HAL_UART_RX_FIFO_SIZE );
 
@@ -70,8 +118,7 @@ void uart_init( void )
     LL_GPIO_SetPinPull( GPIOC, LL_GPIO_PIN_12, LL_GPIO_PULL_NO );
     LL_GPIO_SetAFPin_8_15( GPIOC, LL_GPIO_PIN_12, LL_GPIO_AF_8 );
 
-
-#ifdef UART_DMA
+    // The streams are configured whichever mode starts, so it can be switched later
     LL_AHB1_GRP1_EnableClock( LL_AHB1_GRP1_PERIPH_DMA1 );
 
     // UART5 uses:
@@ -100,7 +147,6 @@ void uart_init( void )
             1,
             0 )
     );
-    NVIC_EnableIRQ( DMA1_Stream7_IRQn );
 
     /* RX Init */
     LL_DMA_SetChannelSelection( DMA1, LL_DMA_STREAM_0, LL_DMA_CHANNEL_4 );
@@ -114,16 +160,14 @@ void uart_init( void )
     LL_DMA_DisableFifoMode( DMA1, LL_DMA_STREAM_0 );
 
     LL_DMA_SetPeriphAddress( DMA1, LL_DMA_STREAM_0, (uint32_t)&UART5->DR );
-    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_STREAM_0, (uint32_t)&dma_rx_buffer );
-    LL_DMA_SetDataLength( DMA1, LL_DMA_STREAM_0, HAL_UART_RX_DMA_BUFFER_SIZE );
+    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_STREAM_0, (uint32_t)&rx_buffer[0] );
+    LL_DMA_SetDataLength( DMA1, LL_DMA_STREAM_0, HAL_UART_RX_FIFO_SIZE );
 
     /* Enable HT & TC interrupts */
     LL_DMA_EnableIT_HT( DMA1, LL_DMA_STREAM_0 );
     LL_DMA_EnableIT_TC( DMA1, LL_DMA_STREAM_0 );
 
     NVIC_SetPriority( DMA1_Stream0_IRQn, 2 );
-    NVIC_EnableIRQ( DMA1_Stream0_IRQn );
-#endif
 
     // Common UART config
     LL_APB1_GRP1_EnableClock( LL_APB1_GRP1_PERIPH_UART5 );
@@ -143,34 +187,56 @@ void uart_init( void )
     LL_USART_SetOverSampling( UART5, LL_USART_OVERSAMPLING_16 );
     LL_USART_ConfigAsyncMode( UART5 );
 
-    // USART interrupt priorities
+    // USART interrupt priorities, enabled by the engines which use them
     NVIC_SetPriority( UART5_IRQn, 3 );
-    NVIC_EnableIRQ( UART5_IRQn );
 
-#ifdef UART_POLL
     LL_USART_Enable( UART5 );
 
-#endif
+    uart_mode   = mode;
+    uart_driver = &uart_drivers[mode];
+    uart_driver->start();
 
-#ifdef UART_IRQ
-    LL_USART_EnableIT_TXE(UART5);
-    LL_USART_EnableIT_RXNE(UART5);
+    // Manually transmit a byte
+//    LL_USART_TransmitData9(UART5, 0xAA);
 
-    LL_USART_Enable( UART5 );
-#endif
+}
 
-#ifdef UART_DMA
-    LL_USART_EnableDMAReq_TX( UART5 );
-    LL_USART_EnableDMAReq_RX( UART5 );
-    LL_USART_EnableIT_IDLE( UART5 );
+/* -------------------------------------------------------------------------- */
 
-    LL_USART_Enable( UART5 );
-    LL_DMA_EnableStream( DMA1, LL_DMA_STREAM_0 );    // rx stream
-#endif
+void uart_set_mode( uart_mode_t mode )
+{
+    if( mode == uart_mode || mode >= UART_MODE_COUNT )
+    {
+        return;
+    }
 
-    // Manually transmit a byte
-//    LL_USART_TransmitData9(UART5, 0xAA);
+    // Let the current engine finish sending, so no frame is cut short
+    while( fifo_used( &tx_fifo ) || !LL_USART_IsActiveFlag_TC( UART5 ) )
+    {
+        uart_driver->rx_service();
+    }
+
+    // With its interrupts off main owns both fifos for a moment, then the new
+    // engine's contexts take over whatever is still in rx_fifo
+    uart_driver->stop();
+
+    uart_mode   = mode;
+    uart_driver = &uart_drivers[mode];
+    uart_driver->start();
+}
+
+/* -------------------------------------------------------------------------- */
 
+uart_mode_t uart_get_mode( void )
+{
+    return uart_mode;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t hal_uart_rx_overruns( void )
+{
+    return rx_overruns;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -182,7 +248,7 @@ uint32_t hal_uart_write( const uint8_t *data, uint32_t length )
     if( fifo_free( &tx_fifo ) >= length )
     {
         sent = fifo_write( &tx_fifo, data, length );
-        hal_uart_start_tx();
+        uart_driver->start_tx();
     }
 
     return sent;
@@ -192,9 +258,7 @@ uint32_t hal_uart_write( const uint8_t *data, uint32_t length )
 
 uint32_t hal_uart_rx_data_available( void )
 {
-#ifdef UART_POLL
-    hal_usart_rx_handler();
-#endif
+    uart_driver->rx_service();
     return fifo_used( &rx_fifo );
 }
 
@@ -216,15 +280,40 @@ uint32_t hal_uart_read( uint8_t *data, uint32_t maxlength )
     return len;
 }
 
+/* -------------------------------------------------------------------------- */
+
+uint32_t hal_uart_rx_peek( const uint8_t **data )
+{
+    fifo_span_t spans[2];
+
+    fifo_peek_spans( &rx_fifo, spans );
+
+    *data = spans[0].data;
+    return spans[0].length;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void hal_uart_rx_consume( uint32_t length )
+{
+    fifo_consume( &rx_fifo, length );
+}
+
 /* ------------------------------------------------------------------*/
 
-static void hal_uart_start_tx( void )
+// tx_fifo and rx_fifo each have one producer and one consumer context, so
+// nothing here masks interrupts. main only ever adds to tx_fifo and the TXE
+// or DMA TX interrupt drains it, the RX side is the other way round. Polling
+// does everything from main.
+
+static void hal_uart_no_op( void )
 {
-    uint32_t primask;
-    primask = __get_PRIMASK();
-    __disable_irq();
+}
+
+/* ------------------------------------------------------------------*/
 
-#ifdef UART_POLL
+static void hal_uart_poll_start_tx( void )
+{
     uint8_t byte = 0;
 
     while( fifo_read( &tx_fifo, &byte, 1 ) )
@@ -235,43 +324,142 @@ static void hal_uart_start_tx( void )
         // Poll until it's complete - this is blocking behaviour
         while( !LL_USART_IsActiveFlag_TXE(UART5) )
         {
-            hal_usart_rx_handler();
+            hal_uart_poll_rx();
         }
     }
-#endif
+}
 
-#ifdef UART_IRQ
-    uint8_t byte = 0;
+/* ------------------------------------------------------------------*/
 
-    if( fifo_read( &tx_fifo, &byte, 1 ) )
+static void hal_uart_poll_rx( void )
+{
+    if( LL_USART_IsActiveFlag_RXNE(UART5) )
     {
-        // Send it
-        LL_USART_TransmitData9(UART5, byte);
-        LL_USART_EnableIT_TXE(UART5);
+        LL_USART_ClearFlag_RXNE(UART5);
+        uint8_t rx_byte = (uint8_t)LL_USART_ReceiveData9(UART5);
+        fifo_put(&rx_fifo, rx_byte);
     }
-#endif
+}
+
+/* ------------------------------------------------------------------*/
+
+static void hal_uart_irq_start( void )
+{
+    // TXE is only enabled while tx_fifo has data
+    LL_USART_EnableIT_RXNE(UART5);
+    NVIC_EnableIRQ( UART5_IRQn );
+}
+
+/* ------------------------------------------------------------------*/
+
+static void hal_uart_irq_stop( void )
+{
+    NVIC_DisableIRQ( UART5_IRQn );
+    LL_USART_DisableIT_TXE(UART5);
+    LL_USART_DisableIT_RXNE(UART5);
+    NVIC_ClearPendingIRQ( UART5_IRQn );
+}
+
+/* ------------------------------------------------------------------*/
+
+static void hal_uart_irq_start_tx( void )
+{
+    // The TXE interrupt takes the bytes, and turns itself off once the fifo is empty
+    LL_USART_EnableIT_TXE(UART5);
+}
+
+/* ------------------------------------------------------------------*/
+
+static void hal_uart_dma_start( void )
+{
+    // The stream starts writing at the start of the buffer, so that is where
+    // rx_fifo's head has to be. Nothing else runs yet, another mode may have
+    // left bytes in it
+    fifo_rebase( &rx_fifo );
+
+    LL_DMA_SetDataLength( DMA1, LL_DMA_STREAM_0, HAL_UART_RX_FIFO_SIZE );
+    LL_DMA_ClearFlag_TC0( DMA1 );
+    LL_DMA_ClearFlag_HT0( DMA1 );
+    LL_DMA_ClearFlag_DME0( DMA1 );
+    LL_DMA_ClearFlag_FE0( DMA1 );
+    LL_DMA_ClearFlag_TE0( DMA1 );
+    dma_rx_running = true;
+
+    LL_USART_EnableDMAReq_TX( UART5 );
+    LL_USART_EnableDMAReq_RX( UART5 );
+    LL_USART_EnableIT_IDLE( UART5 );
+
+    LL_DMA_EnableStream( DMA1, LL_DMA_STREAM_0 );    // rx stream
+
+    NVIC_EnableIRQ( DMA1_Stream7_IRQn );
+    NVIC_EnableIRQ( DMA1_Stream0_IRQn );
+    NVIC_EnableIRQ( UART5_IRQn );
+}
+
+/* ------------------------------------------------------------------*/
+
+static void hal_uart_dma_stop( void )
+{
+    NVIC_DisableIRQ( UART5_IRQn );
+    NVIC_DisableIRQ( DMA1_Stream0_IRQn );
+    NVIC_DisableIRQ( DMA1_Stream7_IRQn );
+    LL_USART_DisableIT_IDLE( UART5 );
+
+    // Keep what the RX stream already wrote, then leave it off
+    LL_DMA_DisableStream( DMA1, LL_DMA_STREAM_0 );
+    while( LL_DMA_IsEnabledStream( DMA1, LL_DMA_STREAM_0 ) )
+    {
+    }
+    hal_uart_dma_rx();
+
+    dma_rx_running = false;
+
+    LL_USART_DisableDMAReq_TX( UART5 );
+    LL_USART_DisableDMAReq_RX( UART5 );
+
+    NVIC_ClearPendingIRQ( UART5_IRQn );
+    NVIC_ClearPendingIRQ( DMA1_Stream0_IRQn );
+    NVIC_ClearPendingIRQ( DMA1_Stream7_IRQn );
+}
 
-#ifdef UART_DMA
+/* ------------------------------------------------------------------*/
+
+static void hal_uart_dma_start_tx( void )
+{
+    // Let the TX stream's interrupt start the transfer, it's the only place
+    // which reads tx_fifo
+    NVIC_SetPendingIRQ( DMA1_Stream7_IRQn );
+}
+
+/* ------------------------------------------------------------------*/
+
+// Only called from DMA1_Stream7_IRQHandler
+static void hal_uart_dma_tx_next( void )
+{
     /* If transfer is not ongoing */
     if( !LL_DMA_IsEnabledStream( DMA1, LL_DMA_STREAM_7 ) )
     {
-        // Accept up to the max DMA buffer's capacity from the stream
-        // StreamBuffer -> buffer for DMA -> UART TX
-        tx_sneak_bytes = fifo_used_linear( &tx_fifo );
-
-        // Limit maximum size to transmit at a time
-        if( tx_sneak_bytes > 32 )
+        // Send straight out of the fifo, the first span up to the end of its buffer
+        fifo_span_t spans[2];
+
+        fifo_peek_spans( &tx_fifo, spans );
+        tx_sneak_bytes = spans[0].length;
+
+        // The whole contiguous run in one transfer, up to the limit. A wrapped
+        // remainder is started from the TC interrupt, while the UART still
+        // has the last byte to shift out, so the line doesn't go idle. The
+        // stream's double buffer mode can't be used for it, both of its
+        // buffers have to be the same length
+        if( tx_sneak_bytes > HAL_UART_TX_DMA_MAX_BURST )
         {
-            tx_sneak_bytes = 32;
+            tx_sneak_bytes = HAL_UART_TX_DMA_MAX_BURST;
         }
 
         // Configure DMA with the data
         if( tx_sneak_bytes > 0 )
         {
-            void *ptr = fifo_get_tail_ptr( &tx_fifo, tx_sneak_bytes );
-
             LL_DMA_SetDataLength( DMA1, LL_DMA_STREAM_7, tx_sneak_bytes );
-            LL_DMA_SetMemoryAddress( DMA1, LL_DMA_STREAM_7, (uint32_t)ptr );
+            LL_DMA_SetMemoryAddress( DMA1, LL_DMA_STREAM_7, (uint32_t)spans[0].data );
 
             LL_DMA_ClearFlag_TC7( DMA1 );
             LL_DMA_ClearFlag_HT7( DMA1 );
@@ -283,101 +471,89 @@ static void hal_uart_start_tx( void )
             LL_DMA_EnableStream( DMA1, LL_DMA_STREAM_7 );
         }
     }
-#endif
-
-    __set_PRIMASK( primask );
 }
 
 /* ------------------------------------------------------------------*/
 
-static void hal_usart_rx_handler( void )
+static void hal_uart_dma_rx( void )
 {
-#ifdef UART_POLL
-    if( LL_USART_IsActiveFlag_RXNE(UART5) )
+    // Commits what the RX stream has written into rx_fifo. Called from
+    // DMA1_Stream0_IRQHandler, which the HT/TC flags and line-idle end up in,
+    // and once more by hal_uart_dma_stop() with the interrupts off
+
+    // The count means nothing until the stream has been set up for rx_fifo
+    if( !dma_rx_running )
     {
-        LL_USART_ClearFlag_RXNE(UART5);
-        uint8_t rx_byte = (uint8_t)LL_USART_ReceiveData9(UART5);
-        fifo_put(&rx_fifo, rx_byte);
+        return;
     }
-#endif
-
-#ifdef UART_IRQ
-    uint8_t rx_byte = (uint8_t)LL_USART_ReceiveData9(UART5);
-    fifo_put(&rx_fifo, rx_byte);
-#endif
 
-#ifdef UART_DMA
-    // Tracks data handled by RX DMA and passes data off for higher-level storage/parsing etc.
-    // Called when the RX DMA interrupts for half or full buffer fire, and when line-idle occurs
+    fifo_span_t    spans[2];
+    const uint32_t free = fifo_reserve_write( &rx_fifo, spans );
+    const uint32_t head = (uint32_t)( spans[0].data - &rx_buffer[0] );
 
-    // Calculate current head index
-    uint32_t current_pos = HAL_UART_RX_DMA_BUFFER_SIZE - LL_DMA_GetDataLength( DMA1, LL_DMA_STREAM_0 );
+    // Where the stream will write next, the count is reloaded after each lap
+    uint32_t current_pos = HAL_UART_RX_FIFO_SIZE - LL_DMA_GetDataLength( DMA1, LL_DMA_STREAM_0 );
 
-    // Has DMA given us new data?
-    if( current_pos != dma_rx_pos )
+    if( current_pos == HAL_UART_RX_FIFO_SIZE )
     {
-        // Data hasn't hit the end yet
-        if( current_pos > dma_rx_pos )
-        {
-            fifo_write( &rx_fifo, (const uint8_t *)&dma_rx_buffer[dma_rx_pos], current_pos - dma_rx_pos );
-        }
-        else    // circular buffer overflowed
-        {
-            // Read to the end of the buffer
-            fifo_write( &rx_fifo, (const uint8_t *)&dma_rx_buffer[dma_rx_pos], sizeof(dma_rx_buffer) - dma_rx_pos );
-
-            // Read from the start of the buffer to the current head
-            if( current_pos > 0 )
-            {
-                fifo_write( &rx_fifo, (const uint8_t *)&dma_rx_buffer[0], current_pos );
-            }
-        }
+        current_pos = 0;
     }
-    // Remember the current head position
-    dma_rx_pos = current_pos;
 
-    // Check if we've reached the end of the buffer, move the head to the start
-    if( dma_rx_pos == HAL_UART_RX_DMA_BUFFER_SIZE )
+    // Has DMA given us new data?
+    uint32_t received = ( current_pos - head ) & ( HAL_UART_RX_FIFO_SIZE - 1 );
+
+    // More than was free means the stream has lapped the reader and written
+    // over unread bytes. Only what fits is added, the rest follows once the
+    // reader makes room, so the head stays on the stream's position
+    if( received > free )
     {
-        dma_rx_pos = 0;
+        rx_overruns++;
+        received = free;
     }
-#endif
+
+    fifo_commit_write( &rx_fifo, received );
 }
 
 /* ------------------------------------------------------------------*/
 
 void UART5_IRQHandler( void )
 {
-#ifdef UART_IRQ
-    // Check tx empty flag
+    // IRQ mode, check tx empty flag
     if(LL_USART_IsEnabledIT_TXE(UART5) && LL_USART_IsActiveFlag_TXE(UART5) )
     {
-        LL_USART_ClearFlag_TC(UART5);
-        LL_USART_DisableIT_TXE(UART5);
+        uint8_t byte = 0;
 
-        // Check for more data to send
-        hal_uart_start_tx();
+        // Send the next byte, or stop interrupting until main adds more
+        if( fifo_read( &tx_fifo, &byte, 1 ) )
+        {
+            LL_USART_TransmitData9(UART5, byte);
+        }
+        else
+        {
+            LL_USART_ClearFlag_TC(UART5);
+            LL_USART_DisableIT_TXE(UART5);
+        }
     }
 
     if(LL_USART_IsEnabledIT_RXNE(UART5) && LL_USART_IsActiveFlag_RXNE(UART5) )
     {
         LL_USART_ClearFlag_RXNE(UART5);
-        hal_usart_rx_handler();
+        uint8_t rx_byte = (uint8_t)LL_USART_ReceiveData9(UART5);
+        fifo_put(&rx_fifo, rx_byte);
     }
-#endif
 
-    // Idle line interrupt occurs when the UART RX line has been high for more than one frame
+    // DMA mode, idle line interrupt occurs when the UART RX line has been high for more than one frame
     if( LL_USART_IsEnabledIT_IDLE( UART5 ) && LL_USART_IsActiveFlag_IDLE( UART5 ) )
     {
         // Clear IDLE line flag
         LL_USART_ClearFlag_IDLE( UART5 );
 
-        // Check for data to process
-        hal_usart_rx_handler();
+        // Check for data to process. The RX stream's interrupt does it, so
+        // rx_fifo and the stream state are only ever written from one context
+        NVIC_SetPendingIRQ( DMA1_Stream0_IRQn );
     }
 }
 
-#ifdef UART_DMA
 // RX
 void DMA1_Stream0_IRQHandler( void )
 {
@@ -385,15 +561,16 @@ void DMA1_Stream0_IRQHandler( void )
     if( LL_DMA_IsEnabledIT_HT( DMA1, LL_DMA_STREAM_0 ) && LL_DMA_IsActiveFlag_HT0( DMA1 ) )
     {
         LL_DMA_ClearFlag_HT0( DMA1 );
-        hal_usart_rx_handler();
     }
 
     // Full transfer complete
     if( LL_DMA_IsEnabledIT_TC( DMA1, LL_DMA_STREAM_0 ) && LL_DMA_IsActiveFlag_TC0( DMA1 ) )
     {
         LL_DMA_ClearFlag_TC0( DMA1 );
-        hal_usart_rx_handler();
     }
+
+    // Also pended by the UART5 idle line interrupt, with neither flag set
+    hal_uart_dma_rx();
 }
 
 // TX
@@ -404,11 +581,12 @@ void DMA1_Stream7_IRQHandler( void )
     {
         LL_DMA_ClearFlag_TC7( DMA1 );    // Clear transfer complete flag
 
-        // Flush the data that completed, and send more if needed
-        fifo_skip( &tx_fifo, tx_sneak_bytes );
-        hal_uart_start_tx();
+        // Flush the data that completed
+        fifo_consume( &tx_fifo, tx_sneak_bytes );
     }
+
+    // Send more if needed, this is also pended by hal_uart_dma_start_tx()
+    hal_uart_dma_tx_next();
 }
-#endif
 
-/* ------------------------------------------------------------------*/
\ No newline at end of file
+/* ------------------------------------------------------------------*/
@@ -1,7 +1,36 @@
 #ifndef UART_H
 #define UART_H
 
-void uart_init( void );
+// Every engine is built in, and the mode can be changed while running
+typedef enum
+{
+    UART_MODE_POLL,
+    UART_MODE_IRQ,
+    UART_MODE_DMA,
+    UART_MODE_COUNT,
+} uart_mode_t;
+
+void uart_init( uart_mode_t mode );
+
+/* -------------------------------------------------------------------------- */
+
+/* Waits for the current mode to finish sending, then hands both fifos to the
+ * engine for mode. Received bytes not yet read are kept.
+ */
+void uart_set_mode( uart_mode_t mode );
+
+/* -------------------------------------------------------------------------- */
+
+uart_mode_t uart_get_mode( void );
+
+/* -------------------------------------------------------------------------- */
+
+/* Number of times the DMA RX stream wrote over bytes before they were read,
+ * because main fell a whole rx fifo behind.
+ */
+uint32_t hal_uart_rx_overruns( void );
+
+/* -------------------------------------------------------------------------- */
 
 /* Non-blocking send for a number of characters to the UART tx FIFO queue.
  * Returns true when successful. false when queue was full.
@@ -29,4 +58,17 @@ uint32_t hal_uart_read( uint8_t *buffer, uint32_t bufferlen );
 
 /* -------------------------------------------------------------------------- */
 
+/* Points data at the oldest received bytes in place, without copying them.
+ * Returns how many are contiguous, the rest follow after a wrap.
+ * Release them with hal_uart_rx_consume() once handled.
+ */
+uint32_t hal_uart_rx_peek( const uint8_t **data );
+
+/* -------------------------------------------------------------------------- */
+
+/* Drops length bytes returned by hal_uart_rx_peek() from the rx FIFO queue. */
+void hal_uart_rx_consume( uint32_t length );
+
+/* -------------------------------------------------------------------------- */
+
 #endif //UART_H